@@ -0,0 +1,77 @@
+/**
+ * @file AnalysisManager.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DILITHIUM_ANALYSIS_MANAGER_HPP
+#define _DILITHIUM_ANALYSIS_MANAGER_HPP
+
+#pragma once
+
+#include <Dilithium/Dominators.hpp>
+#include <Dilithium/LoopInfo.hpp>
+
+#include <memory>
+#include <unordered_map>
+
+#include <boost/core/noncopyable.hpp>
+
+namespace Dilithium
+{
+	class Function;
+
+	// Caches the CFG analyses of each function, computing them on first request. They only depend on the blocks and
+	// the edges between them, so they survive any change that keeps the CFG intact. A pass that changes the CFG of a
+	// function (or renumbers its blocks) must report it with InvalidateCFG.
+	class FunctionAnalysisManager : boost::noncopyable
+	{
+	public:
+		DominatorTree const & GetDominatorTree(Function const & func);
+		PostDominatorTree const & GetPostDominatorTree(Function const & func);
+		LoopInfo const & GetLoopInfo(Function const & func);
+
+		void InvalidateCFG(Function const & func);
+		void Clear();
+
+	private:
+		struct CachedAnalyses
+		{
+			std::unique_ptr<DominatorTree> dom_tree;
+			std::unique_ptr<PostDominatorTree> post_dom_tree;
+			std::unique_ptr<LoopInfo> loop_info;
+		};
+
+		std::unordered_map<Function const *, CachedAnalyses> analyses_;
+	};
+}
+
+#endif		// _DILITHIUM_ANALYSIS_MANAGER_HPP
@@ -36,14 +36,20 @@
 #define _DILITHIUM_ASM_WRITER_HPP
 
 #include <iosfwd>
+#include <memory>
+
+#include <boost/core/noncopyable.hpp>
 
 namespace Dilithium
 {
 	class BasicBlock;
 	class Function;
 	class Instruction;
+	class LLVMModule;
 	class Value;
 
+	struct ModuleSlotTrackerImpl;
+
 	class AssemblyAnnotationWriter
 	{
 	public:
@@ -70,6 +76,34 @@ namespace Dilithium
 		/// right of an instruction or global value.
 		virtual void PrintInfoComment(Value const & value, std::ostream& os);
 	};
+
+	/// ModuleSlotTracker - Caches the slot numbers and type names of a module
+	/// for printing many values from it. Value::Print and
+	/// Value::PrintAsOperand without one number the whole module on every
+	/// call. Create one per module and pass it to each call instead.
+	class ModuleSlotTracker : boost::noncopyable
+	{
+	public:
+		/// Slots are computed lazily, on the first print that needs them.
+		explicit ModuleSlotTracker(LLVMModule const * module, bool should_initialize_all_metadata = true);
+		~ModuleSlotTracker();
+
+		LLVMModule const * GetModule() const;
+
+		/// IncorporateFunction - Number the local values of func, dropping the
+		/// previously incorporated function. This is a no-op if func is already
+		/// the incorporated one, so printing values of one function in a row
+		/// numbers it only once.
+		void IncorporateFunction(Function const & func);
+
+		ModuleSlotTrackerImpl& Impl()
+		{
+			return *impl_;
+		}
+
+	private:
+		std::unique_ptr<ModuleSlotTrackerImpl> impl_;
+	};
 }
 
 #endif		// _DILITHIUM_ASM_WRITER_HPP
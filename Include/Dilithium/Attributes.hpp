@@ -44,6 +44,8 @@
 #include <map>
 #include <string>
 
+#include <boost/range/iterator_range.hpp>
+
 namespace Dilithium
 {
 	class AttrBuilder;
@@ -47,6 +47,7 @@ namespace Dilithium
 {
 	class Function;
 	class LLVMContext;
+	class TerminatorInst;
 	class ValueSymbolTable;
 
 	class BasicBlock : public Value
@@ -58,6 +59,8 @@ namespace Dilithium
 		template <typename NodeType>
 		friend void RemoveFromSymbolTableList(NodeType*);
 
+		friend class Function;
+
 	public:
 		typedef std::list<std::unique_ptr<Instruction>> InstListType;
 		typedef InstListType::iterator iterator;
@@ -147,6 +150,16 @@ namespace Dilithium
 			return inst_list_;
 		}
 
+		TerminatorInst const * GetTerminator() const;
+		TerminatorInst* GetTerminator();
+
+		// Dense index of this block in its parent, always less than Function::MaxBlockNumber(). Used by CFG analyses
+		// to keep per-block data in flat arrays.
+		uint32_t Number() const
+		{
+			return number_;
+		}
+
 		ValueSymbolTable* GetValueSymbolTable();
 
 		void DropAllReferences();
@@ -171,6 +184,7 @@ namespace Dilithium
 	private:
 		InstListType inst_list_;
 		Function* parent_;
+		uint32_t number_;
 
 		// DILITHIUM_NOT_IMPLEMENTED
 	};
@@ -42,9 +42,14 @@
 
 namespace Dilithium
 {
+	class LLVMContext;
 	class LLVMModule;
 
 	std::unique_ptr<LLVMModule> LoadLLVMModule(uint8_t const * data, uint32_t data_length, std::string const & name);
+	// Loads into an existing context, e.g. one whose DXIL prelude is already built. Not safe to call concurrently
+	// on the same context.
+	std::unique_ptr<LLVMModule> LoadLLVMModule(uint8_t const * data, uint32_t data_length, std::string const & name,
+		std::shared_ptr<LLVMContext> const & context);
 }
 
 #endif		// _DILITHIUM_BITCODE_READER_HPP
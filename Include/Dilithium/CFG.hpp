@@ -164,6 +164,114 @@ namespace Dilithium
 	{
 		return pred_const_range(pred_begin(bb), pred_end(bb));
 	}
+
+	// BasicBlock succ_iterator definition
+
+	template <class Ptr, class OpIterator> // Successor Iterator
+	class SuccIterator
+	{
+	public:
+		typedef Ptr value_type;
+		typedef ptrdiff_t difference_type;
+		typedef Ptr* pointer;
+		typedef Ptr* reference;
+		typedef std::forward_iterator_tag iterator_category;
+
+	public:
+		SuccIterator()
+			: iter_(), end_()
+		{
+		}
+		SuccIterator(OpIterator iter, OpIterator end)
+			: iter_(iter), end_(end)
+		{
+			this->AdvancePastNonBlocks();
+		}
+
+		bool operator==(SuccIterator const & rhs) const
+		{
+			return iter_ == rhs.iter_;
+		}
+		bool operator!=(SuccIterator const & rhs) const
+		{
+			return !operator==(rhs);
+		}
+
+		reference operator*() const
+		{
+			BOOST_ASSERT_MSG(iter_ != end_, "succ_iterator out of range!");
+			return cast<BasicBlock>(iter_->Get());
+		}
+
+		SuccIterator<Ptr, OpIterator>& operator++()
+		{
+			// Preincrement
+			BOOST_ASSERT_MSG(iter_ != end_, "succ_iterator out of range!");
+			++ iter_;
+			this->AdvancePastNonBlocks();
+			return *this;
+		}
+
+		SuccIterator<Ptr, OpIterator> operator++(int)
+		{
+			// Postincrement
+			auto tmp = *this;
+			++ *this;
+			return tmp;
+		}
+
+	private:
+		void AdvancePastNonBlocks()
+		{
+			// Successors are the BasicBlock operands of the terminator, skip conditions and case values.
+			while ((iter_ != end_) && !isa<BasicBlock>(iter_->Get()))
+			{
+				++ iter_;
+			}
+		}
+
+	private:
+		OpIterator iter_;
+		OpIterator end_;
+	};
+
+	typedef SuccIterator<BasicBlock, User::op_iterator> succ_iterator;
+	typedef SuccIterator<BasicBlock const, User::const_op_iterator> const_succ_iterator;
+	typedef boost::iterator_range<succ_iterator> succ_range;
+	typedef boost::iterator_range<const_succ_iterator> succ_const_range;
+
+	inline succ_iterator succ_begin(BasicBlock* bb)
+	{
+		auto term = bb->GetTerminator();
+		return term ? succ_iterator(term->OpBegin(), term->OpEnd()) : succ_iterator();
+	}
+	inline const_succ_iterator succ_begin(BasicBlock const * bb)
+	{
+		auto term = bb->GetTerminator();
+		return term ? const_succ_iterator(term->OpBegin(), term->OpEnd()) : const_succ_iterator();
+	}
+	inline succ_iterator succ_end(BasicBlock* bb)
+	{
+		auto term = bb->GetTerminator();
+		return term ? succ_iterator(term->OpEnd(), term->OpEnd()) : succ_iterator();
+	}
+	inline const_succ_iterator succ_end(BasicBlock const * bb)
+	{
+		auto term = bb->GetTerminator();
+		return term ? const_succ_iterator(term->OpEnd(), term->OpEnd()) : const_succ_iterator();
+	}
+	inline bool succ_empty(BasicBlock const * bb)
+	{
+		return succ_begin(bb) == succ_end(bb);
+	}
+	inline succ_range successors(BasicBlock* bb)
+	{
+		return succ_range(succ_begin(bb), succ_end(bb));
+	}
+	inline succ_const_range successors(BasicBlock const * bb)
+	{
+		return succ_const_range(succ_begin(bb), succ_end(bb));
+	}
 }
 
 #endif
@@ -104,7 +104,6 @@ namespace Dilithium
 
 	private:
 		MPFloat val_;
-		// DILITHIUM_NOT_IMPLEMENTED
 	};
 
 	class ConstantAggregateZero : public Constant
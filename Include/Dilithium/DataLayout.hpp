@@ -39,6 +39,8 @@
 
 #include <Dilithium/MathExtras.hpp>
 
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -170,6 +172,7 @@ namespace Dilithium
 			return this->Alignment(ty, true);
 		}
 
+		// Thread-safe, each struct is laid out once and cached
 		StructLayout const * GetStructLayout(StructType* ty) const;
 
 	private:
@@ -215,6 +218,7 @@ namespace Dilithium
 		static const LayoutAlignElem invalid_alignment_elem_;
 		static const PointerAlignElem invalid_pointer_elem_;
 
+		mutable std::mutex layout_map_mutex_;
 		mutable std::unordered_map<StructType*, std::unique_ptr<StructLayout>> layout_map_;
 	};
 }
@@ -0,0 +1,143 @@
+/**
+ * @file Dominators.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DILITHIUM_DOMINATORS_HPP
+#define _DILITHIUM_DOMINATORS_HPP
+
+#pragma once
+
+#include <Dilithium/ArrayRef.hpp>
+
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+namespace Dilithium
+{
+	class BasicBlock;
+	class Function;
+
+	// Dominator tree of a function, computed with the Semi-NCA algorithm. All the per-block data are kept in flat
+	// arrays indexed by BasicBlock::Number(), so queries never go through a pointer map.
+	// The post-dominator flavor works on the reversed CFG, with a virtual root joining all blocks without successors.
+	// Blocks that can't reach an exit (infinite loops) are treated as unreachable by the post-dominator tree.
+	class DominatorTreeBase : boost::noncopyable
+	{
+	public:
+		static uint32_t const INVALID_NUMBER = ~0U;
+
+	public:
+		explicit DominatorTreeBase(bool is_post_dom);
+
+		void Recalculate(Function const & func);
+
+		bool IsPostDominator() const
+		{
+			return is_post_dom_;
+		}
+		Function const * Parent() const
+		{
+			return func_;
+		}
+
+		// Entry block for the dominator tree, exit blocks for the post-dominator tree
+		ArrayRef<BasicBlock const *> Roots() const
+		{
+			return roots_;
+		}
+
+		bool IsReachable(BasicBlock const * bb) const;
+
+		// Returns nullptr for roots and unreachable blocks
+		BasicBlock const * IDom(BasicBlock const * bb) const;
+		ArrayRef<BasicBlock const *> Children(BasicBlock const * bb) const;
+		// Depth in the tree, roots are at level 0
+		uint32_t Level(BasicBlock const * bb) const;
+
+		// Every block dominates itself. An unreachable block is dominated by anything, and dominates nothing but
+		// unreachable blocks.
+		bool Dominates(BasicBlock const * a, BasicBlock const * b) const;
+		bool ProperlyDominates(BasicBlock const * a, BasicBlock const * b) const;
+
+		// Returns nullptr if a and b have no common dominator (unreachable blocks, or different exits of a
+		// post-dominator tree).
+		BasicBlock const * FindNearestCommonDominator(BasicBlock const * a, BasicBlock const * b) const;
+
+	private:
+		void Clear();
+
+	private:
+		bool is_post_dom_;
+		Function const * func_;
+
+		std::vector<BasicBlock const *> roots_;
+		std::vector<BasicBlock const *> blocks_;
+		std::vector<uint32_t> idom_;
+		std::vector<uint32_t> level_;
+		std::vector<uint32_t> dfs_in_;
+		std::vector<uint32_t> dfs_out_;
+		std::vector<uint32_t> child_offsets_;
+		std::vector<BasicBlock const *> children_;
+	};
+
+	class DominatorTree : public DominatorTreeBase
+	{
+	public:
+		DominatorTree()
+			: DominatorTreeBase(false)
+		{
+		}
+		explicit DominatorTree(Function const & func)
+			: DominatorTreeBase(false)
+		{
+			this->Recalculate(func);
+		}
+	};
+
+	class PostDominatorTree : public DominatorTreeBase
+	{
+	public:
+		PostDominatorTree()
+			: DominatorTreeBase(true)
+		{
+		}
+		explicit PostDominatorTree(Function const & func)
+			: DominatorTreeBase(true)
+		{
+			this->Recalculate(func);
+		}
+	};
+}
+
+#endif		// _DILITHIUM_DOMINATORS_HPP
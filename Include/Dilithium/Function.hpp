@@ -72,6 +72,8 @@ namespace Dilithium
 		template <typename NodeType>
 		friend void RemoveFromSymbolTableList(NodeType*);
 
+		friend class BasicBlock;
+
 		enum
 		{
 			IsMaterializableBit = 1 << 0,
@@ -131,6 +133,14 @@ namespace Dilithium
 			return basic_blocks_;
 		}
 
+		// Upper bound of BasicBlock::Number() for the blocks in this function
+		uint32_t MaxBlockNumber() const
+		{
+			return next_block_number_;
+		}
+		// Compacts block numbers to [0, size()) in list order. Cached CFG analyses must be invalidated afterwards.
+		void RenumberBlocks();
+
 		BasicBlock const & EntryBlock() const
 		{
 			return this->front();
@@ -214,6 +224,7 @@ namespace Dilithium
 		}
 
 		void GetAllMetadata(boost::container::small_vector_base<std::pair<uint32_t, MDNode*>>& mds) const;
+		void SetMetadata(uint32_t kind_id, MDNode* node);
 
 		static bool classof(Value const * v)
 		{
@@ -264,6 +275,7 @@ namespace Dilithium
 		ValueSymbolTable sym_tab_;
 		AttributeSet attr_sets_;
 		FunctionType* ty_;
+		uint32_t next_block_number_;
 
 		// DILITHIUM_NOT_IMPLEMENTED
 	};
@@ -37,15 +37,71 @@
 
 #pragma once
 
+#include <Dilithium/CXX17/string_view.hpp>
 #include <Dilithium/GlobalObject.hpp>
+#include <Dilithium/OperandTraits.hpp>
 
 namespace Dilithium
 {
+	class Constant;
+	class Type;
+
+	class GlobalVariable;
+
+	template <>
+	struct OperandTraits<GlobalVariable> : public OptionalOperandTraits<GlobalVariable>
+	{
+	};
+
+	// LLVMModule doesn't keep a list of global variables yet, so a GlobalVariable isn't linked into a module, and is
+	// owned by its creator
 	class GlobalVariable : public GlobalObject
 	{
 	public:
+		~GlobalVariable() override;
+
+		static GlobalVariable* Create(Type* ty, bool is_constant, LinkageTypes linkage, Constant* initializer = nullptr,
+			std::string_view name = "", uint32_t address_space = 0);
+
+		// Definitions have an initializer, declarations don't
+		bool HasInitializer() const
+		{
+			return !this->IsDeclaration();
+		}
+		Constant* GetInitializer() const;
+		// nullptr makes this a declaration
+		void SetInitializer(Constant* initializer);
+
+		bool IsConstant() const
+		{
+			return is_constant_;
+		}
+		void SetConstant(bool val)
+		{
+			is_constant_ = val;
+		}
+
+		bool IsExternallyInitialized() const
+		{
+			return is_externally_initialized_;
+		}
+		void SetExternallyInitialized(bool val)
+		{
+			is_externally_initialized_ = val;
+		}
+
 		// Methods for support type inquiry through isa, cast, and dyn_cast:
 		static bool classof(Value const * v);
+
+		DEFINE_TRANSPARENT_OPERAND_ACCESSORS(GlobalVariable, Value);
+
+	private:
+		GlobalVariable(Type* ty, bool is_constant, LinkageTypes linkage, Constant* initializer, std::string_view name,
+			uint32_t address_space);
+
+	private:
+		bool is_constant_;
+		bool is_externally_initialized_;
 	};
 }
 
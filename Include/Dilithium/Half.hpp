@@ -37,9 +37,12 @@
 
 #pragma once
 
-#include <boost/operators.hpp>
+#include <Dilithium/ArrayRef.hpp>
+
 #include <limits>
 
+#include <boost/operators.hpp>
+
 #define HALF_MIN		5.96046448e-08f	// Smallest positive half
 
 #define HALF_NRM_MIN	6.10351562e-05f	// Smallest positive normalized half
@@ -118,6 +121,11 @@ namespace Dilithium
 	private:
 		uint16_t value_;
 	};
+
+	// Bulk conversions of src into dst, which has room for src.size() values. The results are the same as converting
+	// the values one by one.
+	void ConvertFloatToHalf(ArrayRef<float> src, half* dst) noexcept;
+	void ConvertHalfToFloat(ArrayRef<half> src, float* dst) noexcept;
 }
 
 namespace std
@@ -40,9 +40,12 @@
 #include <Dilithium/User.hpp>
 #include <Dilithium/Value.hpp>
 
+#include <memory>
+
 namespace Dilithium
 {
 	class BasicBlock;
+	class MDAttachmentMap;
 	class MDNode;
 
 	class Instruction : public User
@@ -112,6 +115,8 @@ namespace Dilithium
 			return this->GetValueId() - Value::InstructionVal;
 		}
 
+		Instruction* Clone() const;
+
 		char const * OpcodeName() const;
 		bool IsTerminator() const;
 		bool IsBinaryOp() const;
@@ -138,6 +143,8 @@ namespace Dilithium
 		MDNode* GetMetadata(std::string_view kind) const;
 		void GetAllMetadata(boost::container::small_vector_base<std::pair<uint32_t, MDNode*>>& mds) const;
 		void GetAllMetadataOtherThanDebugLoc(boost::container::small_vector_base<std::pair<uint32_t, MDNode*>>& mds) const;
+		void SetMetadata(uint32_t kind_id, MDNode* node);
+		void SetMetadata(std::string_view kind, MDNode* node);
 
 		static bool classof(Value const * v)
 		{
@@ -187,6 +194,8 @@ namespace Dilithium
 
 	private:
 		BasicBlock* parent_;
+		// Attachments live on the instruction itself. Only allocated when HasMetadataBit is set.
+		std::unique_ptr<MDAttachmentMap> metadata_;
 
 		// DILITHIUM_NOT_IMPLEMENTED
 	};
@@ -78,12 +78,25 @@ namespace Dilithium
 			return this->NumOperands() != 0 ? this->Operand(0) : nullptr;
 		}
 
+		static bool classof(Instruction const * inst)
+		{
+			return inst->Opcode() == Instruction::Ret;
+		}
+		static bool classof(Value const * v)
+		{
+			return isa<Instruction>(v) && classof(cast<Instruction>(v));
+		}
+
 	private:
+		friend class Instruction;
+
 		explicit ReturnInst(LLVMContext& context, Value* ret_val = nullptr, Instruction* insert_before = nullptr);
 		ReturnInst(LLVMContext& context, Value* ret_val, BasicBlock* insert_at_end);
 		explicit ReturnInst(LLVMContext& context, BasicBlock* insert_at_end);
 		ReturnInst(ReturnInst const & rhs);
 
+		ReturnInst* CloneImpl() const;
+
 		DEFINE_TRANSPARENT_OPERAND_ACCESSORS(ReturnInst, Value)
 
 		// DILITHIUM_NOT_IMPLEMENTED
@@ -172,6 +185,8 @@ namespace Dilithium
 		DEFINE_TRANSPARENT_OPERAND_ACCESSORS(CallInst, Value)
 
 	private:
+		friend class Instruction;
+
 		CallInst(FunctionType* ty, Value* func, ArrayRef<Value*> args, std::string_view name, Instruction* insert_before);
 		CallInst(Value* func, ArrayRef<Value*> args, std::string_view name, Instruction* insert_before);
 		CallInst(Value* func, ArrayRef<Value*> args, std::string_view name, BasicBlock* insert_at_end);
@@ -179,6 +194,8 @@ namespace Dilithium
 		CallInst(Value* func, std::string_view name, BasicBlock* insert_at_end);
 		CallInst(CallInst const & rhs);
 
+		CallInst* CloneImpl() const;
+
 		void Init(Value* func, ArrayRef<Value*> args, std::string_view name);
 		void Init(FunctionType* fty, Value* func, ArrayRef<Value*> args, std::string_view name);
 		void Init(Value* func, std::string_view name);
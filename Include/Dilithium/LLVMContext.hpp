@@ -38,14 +38,17 @@
 #pragma once
 
 #include <Dilithium/CXX17/string_view.hpp>
+#include <Dilithium/MemoryUsage.hpp>
 
 #include <memory>
+#include <vector>
 
 #include <boost/container/small_vector.hpp>
 #include <boost/core/noncopyable.hpp>
 
 namespace Dilithium
 {
+	class DxilPrelude;
 	struct LLVMContextImpl;
 
 	class LLVMContext : boost::noncopyable
@@ -77,6 +80,31 @@ namespace Dilithium
 		uint32_t MdKindId(std::string_view name) const;
 		void MdKindNames(boost::container::small_vector_base<std::string_view>& result) const;
 
+		// In concurrent mode, the functions that get a uniqued object can be called from several threads:
+		// IntegerType/FunctionType/PointerType/StructType::Get, StructType::Create, AttributeSet/AttributeSetNode::Get,
+		// ConstantInt/ConstantFP/UndefValue::Get, MDString/MDTuple::Get, ValueAsMetadata/MetadataAsValue::Get and
+		// MdKindId. The big uniquing tables are sharded by hash with a lock per shard, the others have a lock each, and
+		// so does the metadata use tracking.
+		// Anything that uses the shared objects as operands of a User is not covered, since the use lists of the shared
+		// constants are not synchronized. So building, loading, cloning or deleting modules on the same context still
+		// has to happen on one thread at a time. Switch the mode only while no other thread is using the context.
+		bool ConcurrentUniquing() const;
+		void ConcurrentUniquing(bool enable);
+
+		// The shared dx.types.* structs, dx.op attribute sets and opcode constants. Built on first call, thread-safe.
+		DxilPrelude const & GetDxilPrelude();
+		bool HasDxilPrelude() const;
+
+		// Appends one entry per uniquing table. Walks the tables without locking, don't call it while other threads
+		// are uniquing into this context.
+		void MemoryStats(std::vector<MemoryUsage>& stats) const;
+
+		// Frees the uniqued integer and floating point constants, undef values, metadata nodes, MDStrings and metadata
+		// wrappers that no live module on this context reaches anymore, then shrinks the tables. Unresolved metadata
+		// nodes and what they reach are kept. Pointers to the freed objects held outside a module become dangling.
+		// Takes no locks, call it only while no other thread uses the context.
+		void Compact();
+
 		LLVMContextImpl& Impl()
 		{
 			return *impl_;
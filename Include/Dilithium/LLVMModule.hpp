@@ -40,12 +40,14 @@
 #include <Dilithium/CXX17/string_view.hpp>
 #include <Dilithium/DataLayout.hpp>
 #include <Dilithium/Function.hpp>
+#include <Dilithium/MemoryUsage.hpp>
 #include <Dilithium/Metadata.hpp>
 #include <Dilithium/ValueSymbolTable.hpp>
 
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/core/noncopyable.hpp>
 #include <boost/range/iterator_range.hpp>
@@ -56,6 +58,7 @@ namespace Dilithium
 	class GVMaterializer;
 	class LLVMContext;
 	class NamedMDNode;
+	class RawOStream;
 
 	class DxilModule;
 
@@ -78,6 +81,8 @@ namespace Dilithium
 		LLVMModule(std::string const & name, std::shared_ptr<LLVMContext> const & context);
 		~LLVMModule();
 
+		std::unique_ptr<LLVMModule> Clone() const;
+
 		LLVMContext& Context() const
 		{
 			return *context_;
@@ -114,6 +119,10 @@ namespace Dilithium
 		NamedMDNode* GetNamedMetadata(std::string_view name) const;
 		NamedMDNode* GetOrInsertNamedMetadata(std::string_view name);
 
+		// Appends the functions, arguments, basic blocks, instructions, uses, value handles and metadata attachments
+		// owned by this module. The shared uniqued objects are reported by LLVMContext::MemoryStats.
+		void MemoryStats(std::vector<MemoryUsage>& stats) const;
+
 		void Materializer(std::shared_ptr<GVMaterializer> const & gvm);
 		void MaterializeAllPermanently();
 
@@ -221,7 +230,10 @@ namespace Dilithium
 			return boost::iterator_range<const_named_metadata_iterator>(this->NamedMetadataBegin(), this->NamedMetadataEnd());
 		}
 
-		void Print(std::ostream& os, AssemblyAnnotationWriter* aaw) const;
+		// With num_threads other than 1, functions are printed in parallel, 0 means one thread per core. The text
+		// is the same, but aaw is called from several threads at once.
+		void Print(std::ostream& os, AssemblyAnnotationWriter* aaw, uint32_t num_threads = 1) const;
+		void Print(RawOStream& os, AssemblyAnnotationWriter* aaw, uint32_t num_threads = 1) const;
 
 		void DropAllReferences();
 
@@ -0,0 +1,130 @@
+/**
+ * @file LoopInfo.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DILITHIUM_LOOP_INFO_HPP
+#define _DILITHIUM_LOOP_INFO_HPP
+
+#pragma once
+
+#include <Dilithium/ArrayRef.hpp>
+
+#include <memory>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+namespace Dilithium
+{
+	class BasicBlock;
+	class DominatorTreeBase;
+	class Function;
+	class LoopInfo;
+
+	// A natural loop, identified by its header. Blocks() starts with the header, followed by the rest of the blocks,
+	// including the ones in sub-loops, in function order.
+	class Loop : boost::noncopyable
+	{
+		friend class LoopInfo;
+
+	public:
+		BasicBlock const * Header() const
+		{
+			return blocks_.front();
+		}
+		Loop* ParentLoop() const
+		{
+			return parent_;
+		}
+		ArrayRef<Loop*> SubLoops() const
+		{
+			return sub_loops_;
+		}
+		ArrayRef<BasicBlock const *> Blocks() const
+		{
+			return blocks_;
+		}
+
+		// Outermost loops have depth 1
+		uint32_t LoopDepth() const;
+
+		bool Contains(Loop const * l) const;
+		bool Contains(BasicBlock const * bb) const;
+
+	private:
+		explicit Loop(BasicBlock const * header);
+
+	private:
+		Loop* parent_;
+		std::vector<Loop*> sub_loops_;
+		std::vector<BasicBlock const *> blocks_;
+		LoopInfo const * info_;
+	};
+
+	// Natural loop forest of a function. Loops are discovered from the back edges of the dominator tree, inner loops
+	// first, so irreducible cycles don't form loops.
+	class LoopInfo : boost::noncopyable
+	{
+	public:
+		LoopInfo();
+		LoopInfo(Function const & func, DominatorTreeBase const & dom_tree);
+
+		void Analyze(Function const & func, DominatorTreeBase const & dom_tree);
+
+		ArrayRef<Loop*> TopLevelLoops() const
+		{
+			return top_level_loops_;
+		}
+		bool empty() const
+		{
+			return top_level_loops_.empty();
+		}
+
+		// Innermost loop containing bb, or nullptr if it's not in any loop
+		Loop* LoopFor(BasicBlock const * bb) const;
+		// 0 for blocks out of any loop
+		uint32_t LoopDepth(BasicBlock const * bb) const;
+		bool IsLoopHeader(BasicBlock const * bb) const;
+
+	private:
+		void Clear();
+
+	private:
+		Function const * func_;
+		std::vector<std::unique_ptr<Loop>> loops_;
+		std::vector<Loop*> top_level_loops_;
+		std::vector<Loop*> bb_map_;
+	};
+}
+
+#endif		// _DILITHIUM_LOOP_INFO_HPP
@@ -41,30 +41,82 @@
 #include <Dilithium/ArrayRef.hpp>
 
 #include <boost/assert.hpp>
+#include <boost/functional/hash.hpp>
 
 namespace Dilithium
 {
-	// Multi-precision integer. Must <= 64 bits.
+	// Multi-precision integer. Widths up to 64 bits are stored in a single inline word, wider ones in heap allocated words.
 	class MPInt
 	{
 		static uint32_t constexpr MPINT_BITS_PER_WORD = sizeof(uint64_t) * 8;
 
 	public:
 		explicit MPInt()
-			: bit_width_(1)
+			: bit_width_(1), val_(0)
 		{
 		}
-		MPInt(uint32_t num_bits, uint64_t val, bool is_signed = false);
+		MPInt(uint32_t num_bits, uint64_t val, bool is_signed = false)
+			: bit_width_(num_bits)
+		{
+			BOOST_ASSERT_MSG(bit_width_, "bitwidth too small");
+			if (this->IsSingleWord())
+			{
+				val_ = val;
+				this->ClearUnusedBits();
+			}
+			else
+			{
+				this->InitSlowCase(val, is_signed);
+			}
+		}
+		// Words are in little endian order
+		MPInt(uint32_t num_bits, ArrayRef<uint64_t> big_val);
 		MPInt(uint32_t num_bits, std::string_view str, uint8_t radix);
 		MPInt(MPInt const & rhs)
-			: bit_width_(rhs.bit_width_), val_(rhs.val_)
+			: bit_width_(rhs.bit_width_)
 		{
+			if (this->IsSingleWord())
+			{
+				val_ = rhs.val_;
+			}
+			else
+			{
+				this->InitSlowCase(rhs);
+			}
 		}
 		MPInt(MPInt&& rhs)
-			: bit_width_(rhs.bit_width_), val_(rhs.val_)
+			: bit_width_(rhs.bit_width_)
 		{
+			if (this->IsSingleWord())
+			{
+				val_ = rhs.val_;
+			}
+			else
+			{
+				p_val_ = rhs.p_val_;
+			}
 			rhs.bit_width_ = 0;
 		}
+		~MPInt()
+		{
+			if (!this->IsSingleWord())
+			{
+				delete[] p_val_;
+			}
+		}
+
+		bool IsSingleWord() const
+		{
+			return bit_width_ <= MPINT_BITS_PER_WORD;
+		}
+		uint32_t NumWords() const
+		{
+			return NumWords(bit_width_);
+		}
+		static uint32_t NumWords(uint32_t bit_width)
+		{
+			return (bit_width + MPINT_BITS_PER_WORD - 1) / MPINT_BITS_PER_WORD;
+		}
 
 		bool IsNegative() const
 		{
@@ -72,7 +124,11 @@ namespace Dilithium
 		}
 		bool IsAllOnesValue() const
 		{
-			return val_ == ~0ULL >> (MPINT_BITS_PER_WORD - bit_width_);
+			if (this->IsSingleWord())
+			{
+				return val_ == ~0ULL >> (MPINT_BITS_PER_WORD - bit_width_);
+			}
+			return this->CountPopulation() == bit_width_;
 		}
 		bool IsMaxValue() const
 		{
@@ -98,6 +154,10 @@ namespace Dilithium
 
 		uint64_t LimitedValue(uint64_t limit = ~0ULL) const
 		{
+			if (!this->IsSingleWord() && (this->ActiveBits() > MPINT_BITS_PER_WORD))
+			{
+				return limit;
+			}
 			return this->ZExtValue() > limit ? limit : this->ZExtValue();
 		}
 		static MPInt AllOnesValue(uint32_t num_bits)
@@ -112,9 +172,10 @@ namespace Dilithium
 		static MPInt LowBitsSet(uint32_t num_bits, uint32_t lo_bits_set);
 		static MPInt Splat(uint32_t new_len, MPInt const & v);
 
-		uint64_t RawData() const
+		// NumWords() words in little endian order
+		uint64_t const * RawData() const
 		{
-			return val_;
+			return this->IsSingleWord() ? &val_ : p_val_;
 		}
 
 		void Assign(uint64_t rhs);
@@ -132,12 +193,43 @@ namespace Dilithium
 		}
 		bool operator!() const
 		{
-			return !val_;
+			if (this->IsSingleWord())
+			{
+				return !val_;
+			}
+			return this->CountLeadingZeros() == bit_width_;
 		}
 
-		MPInt& operator=(MPInt const & rhs);
-		MPInt& operator=(MPInt&& rhs);
-		MPInt& operator+=(MPInt const & rhs);
+		MPInt& operator=(MPInt const & rhs)
+		{
+			if (this->IsSingleWord() && rhs.IsSingleWord())
+			{
+				val_ = rhs.val_;
+				bit_width_ = rhs.bit_width_;
+				return *this;
+			}
+			return this->AssignSlowCase(rhs);
+		}
+		MPInt& operator=(MPInt&& rhs)
+		{
+			if (this->IsSingleWord() && rhs.IsSingleWord())
+			{
+				val_ = rhs.val_;
+				bit_width_ = rhs.bit_width_;
+				return *this;
+			}
+			return this->MoveAssignSlowCase(rhs);
+		}
+		MPInt& operator+=(MPInt const & rhs)
+		{
+			BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
+			if (this->IsSingleWord())
+			{
+				val_ += rhs.val_;
+				return this->ClearUnusedBits();
+			}
+			return this->AddAssignSlowCase(rhs);
+		}
 		MPInt& operator-=(MPInt const & rhs);
 		MPInt& operator*=(MPInt const & rhs);
 		MPInt& operator&=(MPInt const & rhs);
@@ -146,7 +238,17 @@ namespace Dilithium
 		MPInt& operator^=(MPInt const & rhs);
 		MPInt& operator<<=(uint32_t shift);
 
-		MPInt operator+(MPInt const & rhs) const;
+		MPInt operator+(MPInt const & rhs) const
+		{
+			BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
+			if (this->IsSingleWord())
+			{
+				return MPInt(bit_width_, val_ + rhs.val_);
+			}
+			MPInt ret(*this);
+			ret.AddAssignSlowCase(rhs);
+			return ret;
+		}
 		MPInt operator+(uint64_t rhs) const
 		{
 			return (*this) + MPInt(bit_width_, rhs);
@@ -169,12 +271,20 @@ namespace Dilithium
 			return this->Shl(bits);
 		}
 
-		bool operator[](uint32_t bit_pos) const;
+		bool operator[](uint32_t bit_pos) const
+		{
+			BOOST_ASSERT_MSG(bit_pos < bit_width_, "Bit position out of bounds!");
+			return (MaskBit(bit_pos) & this->Word(bit_pos)) != 0;
+		}
 
 		bool operator==(MPInt const & rhs) const;
 		bool operator==(uint64_t val) const
 		{
-			return val_ == val;
+			if (this->IsSingleWord())
+			{
+				return val_ == val;
+			}
+			return (this->ActiveBits() <= MPINT_BITS_PER_WORD) && (p_val_[0] == val);
 		}
 
 		bool operator!=(MPInt const & rhs) const
@@ -188,7 +298,15 @@ namespace Dilithium
 
 		MPInt AShr(uint32_t shift) const;
 		MPInt LShr(uint32_t shift) const;
-		MPInt Shl(uint32_t shift) const;
+		MPInt Shl(uint32_t shift) const
+		{
+			BOOST_ASSERT_MSG(shift <= bit_width_, "Invalid shift amount");
+			if (this->IsSingleWord())
+			{
+				return MPInt(bit_width_, (shift >= bit_width_) ? 0 : (val_ << shift));
+			}
+			return this->ShlSlowCase(shift);
+		}
 		MPInt AShr(MPInt const & shift) const;
 		MPInt LShr(MPInt const & shift) const;
 		MPInt Shl(MPInt const & shift) const;
@@ -200,19 +318,26 @@ namespace Dilithium
 		MPInt ZExtOrSelf(uint32_t width) const;
 		uint64_t ZExtValue() const
 		{
-			return val_;
+			if (this->IsSingleWord())
+			{
+				return val_;
+			}
+			BOOST_ASSERT_MSG(this->ActiveBits() <= MPINT_BITS_PER_WORD, "Too many bits for uint64_t");
+			return p_val_[0];
 		}
 		int64_t SExtValue() const
 		{
-			return static_cast<int64_t>(val_ << (MPINT_BITS_PER_WORD - bit_width_)) >> (MPINT_BITS_PER_WORD - bit_width_);
+			if (this->IsSingleWord())
+			{
+				return static_cast<int64_t>(val_ << (MPINT_BITS_PER_WORD - bit_width_)) >> (MPINT_BITS_PER_WORD - bit_width_);
+			}
+			BOOST_ASSERT_MSG(this->MinSignedBits() <= MPINT_BITS_PER_WORD, "Too many bits for int64_t");
+			return static_cast<int64_t>(p_val_[0]);
 		}
 
 		void SetBit(uint32_t bit_pos);
 		void ClearBit(uint32_t bit_pos);
-		void ClearAllBits()
-		{
-			val_ = 0;
-		}
+		void ClearAllBits();
 
 		void FlipAllBits();
 
@@ -224,6 +349,10 @@ namespace Dilithium
 		{
 			return bit_width_ - this->CountLeadingZeros();
 		}
+		uint32_t MinSignedBits() const
+		{
+			return this->IsNegative() ? (bit_width_ - (~(*this)).CountLeadingZeros() + 1) : (this->ActiveBits() + 1);
+		}
 
 		uint32_t CountLeadingZeros() const;
 		uint32_t CountPopulation() const;
@@ -239,16 +368,51 @@ namespace Dilithium
 	private:
 		static uint64_t MaskBit(uint32_t bit_pos)
 		{
-			return 1ULL << bit_pos;
+			return 1ULL << (bit_pos % MPINT_BITS_PER_WORD);
+		}
+		uint64_t Word(uint32_t bit_pos) const
+		{
+			return this->IsSingleWord() ? val_ : p_val_[bit_pos / MPINT_BITS_PER_WORD];
+		}
+		uint64_t& Word(uint32_t bit_pos)
+		{
+			return this->IsSingleWord() ? val_ : p_val_[bit_pos / MPINT_BITS_PER_WORD];
 		}
 
-		void ClearUnusedBits();
+		MPInt& ClearUnusedBits()
+		{
+			if (bit_width_ > 0)
+			{
+				uint32_t const word_bits = ((bit_width_ - 1) % MPINT_BITS_PER_WORD) + 1;
+				uint64_t const mask = ~0ULL >> (MPINT_BITS_PER_WORD - word_bits);
+				if (this->IsSingleWord())
+				{
+					val_ &= mask;
+				}
+				else
+				{
+					p_val_[this->NumWords() - 1] &= mask;
+				}
+			}
+			return *this;
+		}
+
+		void InitSlowCase(uint64_t val, bool is_signed);
+		void InitSlowCase(MPInt const & rhs);
+		MPInt& AssignSlowCase(MPInt const & rhs);
+		MPInt& MoveAssignSlowCase(MPInt& rhs);
+		MPInt& AddAssignSlowCase(MPInt const & rhs);
+		MPInt ShlSlowCase(uint32_t shift) const;
 
 		void FromString(uint32_t num_bits, std::string_view str, uint8_t radix);
 
 	private:
-		uint64_t val_;
 		uint32_t bit_width_;
+		union
+		{
+			uint64_t val_;
+			uint64_t* p_val_;
+		};
 	};
 
 	inline bool operator==(uint64_t v1, MPInt const & v2)
@@ -278,7 +442,11 @@ namespace std
 
 		result_type operator()(argument_type const & rhs) const
 		{
-			return hash<uint64_t>()(rhs.RawData());
+			if (rhs.IsSingleWord())
+			{
+				return hash<uint64_t>()(*rhs.RawData());
+			}
+			return boost::hash_range(rhs.RawData(), rhs.RawData() + rhs.NumWords());
 		}
 	};
 
@@ -45,6 +45,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <boost/core/noncopyable.hpp>
@@ -121,6 +122,9 @@ namespace Dilithium
 
 	public:
 		static MetadataAsValue* Get(LLVMContext& context, Metadata* md);
+		// Frees the wrappers no instruction uses anymore
+		static void DeleteUnused(LLVMContext& context);
+
 		Metadata* GetMetadata() const
 		{
 			return md_;
@@ -164,6 +168,11 @@ namespace Dilithium
 		void ReplaceAllUsesWith(Metadata* md);
 		void ResolveAllUses(bool resolve_users = true);
 
+		bool HasUses() const
+		{
+			return !use_map_.empty();
+		}
+
 	private:
 		void AddRef(void* ref, OwnerTy owner);
 		void DropRef(void* ref);
@@ -218,6 +227,8 @@ namespace Dilithium
 
 		static void HandleDeletion(Value* val);
 		static void HandleRAUW(Value* from, Value* to);
+		// Frees the ConstantAsMetadata no node or tracking reference points to anymore
+		static void DeleteUnusedConstants(LLVMContext& context);
 
 		static bool classof(Metadata const * md)
 		{
@@ -297,6 +308,7 @@ namespace Dilithium
 		}
 	};
 
+	// The characters are allocated right behind the object, one allocation per string
 	class MDString : boost::noncopyable, public Metadata
 	{
 		MDString& operator=(MDString&&) = delete;
@@ -305,15 +317,24 @@ namespace Dilithium
 		typedef std::string_view::iterator iterator;
 
 	public:
-		MDString();
-		MDString(MDString&& rhs);
-
 		static MDString* Get(LLVMContext& context, std::string_view str);
 
-		std::string_view String() const;
+		static void operator delete(void* p)
+		{
+			::operator delete(p);
+		}
+
+		std::string_view String() const
+		{
+			return std::string_view(reinterpret_cast<char const *>(this + 1), size_);
+		}
 		size_t Size() const
 		{
-			return string_.size();
+			return size_;
+		}
+		uint64_t Hash() const
+		{
+			return string_hash_;
 		}
 
 		iterator begin() const
@@ -331,8 +352,11 @@ namespace Dilithium
 		}
 
 	private:
-		std::string string_;
+		MDString(std::string_view str, uint64_t hash);
+
+	private:
 		uint64_t string_hash_;
+		uint32_t size_;
 		// DILITHIUM_NOT_IMPLEMENTED
 	};
 
@@ -417,7 +441,14 @@ namespace Dilithium
 		static MDTuple* GetDistinct(LLVMContext& context, ArrayRef<Metadata*> mds);
 		//static TempMDTuple GetTemporary(LLVMContext& context, ArrayRef<Metadata*> mds);
 
+		// Frees the uniqued and distinct nodes not in reachable. The unresolved nodes and everything they reach have
+		// to be in reachable, since their forward references are still to come.
+		static void DeleteUnreachable(LLVMContext& context, std::unordered_set<Metadata const *> const & reachable);
+
 		void ReplaceOperandWith(uint32_t idx, Metadata* new_md);
+		// Turns a distinct node whose operands are final into a uniqued one. It stays distinct if it references itself
+		// or an equal uniqued node exists already.
+		void UniquifyDistinct();
 
 		bool IsResolved() const
 		{
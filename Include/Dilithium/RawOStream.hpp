@@ -0,0 +1,180 @@
+/**
+ * @file RawOStream.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DILITHIUM_RAW_OSTREAM_HPP
+#define _DILITHIUM_RAW_OSTREAM_HPP
+
+#pragma once
+
+#include <Dilithium/CXX17/string_view.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+
+#include <boost/core/noncopyable.hpp>
+
+namespace Dilithium
+{
+	// A growable character buffer for text output. Unlike std::ostream, it has no locale, no sticky format flags
+	// and no virtual call per token, so appending is a bounds check plus a memcpy.
+	// If constructed with a target stream, the buffer is written to it whenever it fills up, and on Flush() or
+	// destruction. Otherwise all the text is kept in memory, and can be retrieved by Str().
+	class RawOStream : boost::noncopyable
+	{
+	public:
+		RawOStream();
+		explicit RawOStream(std::ostream& target);
+		~RawOStream();
+
+		RawOStream& Write(char const * data, size_t size)
+		{
+			if (size > capacity_ - size_)
+			{
+				this->Grow(size);
+			}
+			memcpy(buff_.get() + size_, data, size);
+			size_ += size;
+			return *this;
+		}
+
+		RawOStream& operator<<(char c)
+		{
+			if (size_ == capacity_)
+			{
+				this->Grow(1);
+			}
+			buff_[size_] = c;
+			++ size_;
+			return *this;
+		}
+		RawOStream& operator<<(std::string_view str)
+		{
+			return this->Write(str.data(), str.size());
+		}
+		RawOStream& operator<<(std::string const & str)
+		{
+			return this->Write(str.data(), str.size());
+		}
+		RawOStream& operator<<(char const * str)
+		{
+			return this->Write(str, strlen(str));
+		}
+		// Pointers are printed in hex with a 0x prefix
+		RawOStream& operator<<(void const * ptr);
+
+		// Like std::ostream, the character types write a character and the other integral types write a number
+		RawOStream& operator<<(signed char c)
+		{
+			return *this << static_cast<char>(c);
+		}
+		RawOStream& operator<<(unsigned char c)
+		{
+			return *this << static_cast<char>(c);
+		}
+
+		template <typename T>
+		typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value && !std::is_same<T, signed char>::value
+			&& !std::is_same<T, unsigned char>::value && !std::is_same<T, bool>::value, RawOStream&>::type operator<<(T val)
+		{
+			if (std::is_signed<T>::value)
+			{
+				return this->WriteDecimal(static_cast<int64_t>(val));
+			}
+			else
+			{
+				return this->WriteDecimal(static_cast<uint64_t>(val));
+			}
+		}
+
+		RawOStream& WriteDecimal(uint64_t val);
+		RawOStream& WriteDecimal(int64_t val);
+		// Hex digits without prefix, zero padded to at least min_digits
+		RawOStream& WriteHex(uint64_t val, uint32_t min_digits = 1, bool upper = true);
+		RawOStream& Indent(uint32_t num_spaces);
+
+		void Reserve(size_t size);
+
+		// Writes the buffered text to the target stream, if any
+		void Flush();
+		void Clear()
+		{
+			size_ = 0;
+		}
+
+		std::string_view Str() const
+		{
+			return std::string_view(buff_.get(), size_);
+		}
+		size_t Size() const
+		{
+			return size_;
+		}
+		bool Empty() const
+		{
+			return size_ == 0;
+		}
+
+	private:
+		void Grow(size_t extra);
+
+	private:
+		std::unique_ptr<char[]> buff_;
+		size_t size_;
+		size_t capacity_;
+		std::ostream* target_;
+	};
+
+	// Adapts a RawOStream to the std::streambuf interface, so that code written against std::ostream, like
+	// AssemblyAnnotationWriter, can write into the same buffer. It keeps no put area, characters go to the sink
+	// in the order they are written.
+	class RawOStreamBuf : boost::noncopyable, public std::streambuf
+	{
+	public:
+		explicit RawOStreamBuf(RawOStream& os);
+
+	protected:
+		virtual int_type overflow(int_type ch) override;
+		virtual std::streamsize xsputn(char_type const * s, std::streamsize count) override;
+
+	private:
+		RawOStream& os_;
+	};
+}
+
+#endif		// _DILITHIUM_RAW_OSTREAM_HPP
@@ -177,7 +177,7 @@ namespace Dilithium
 		{
 		}
 		TypedTrackingMDRef(TypedTrackingMDRef&& rhs)
-			: ref_(std::move(rhs.ref))
+			: ref_(std::move(rhs.ref_))
 		{
 		}
 		TypedTrackingMDRef(TypedTrackingMDRef const & rhs)
@@ -189,7 +189,7 @@ namespace Dilithium
 		{
 			if (this != &rhs)
 			{
-				ref_ = std::move(rhs.ref);
+				ref_ = std::move(rhs.ref_);
 			}
 			return *this;
 		}
@@ -229,13 +229,13 @@ namespace Dilithium
 			return ref_ != rhs.ref_;
 		}
 
-		void reset()
+		void Reset()
 		{
-			ref_.reset();
+			ref_.Reset();
 		}
-		void reset(T* md)
+		void Reset(T* md)
 		{
-			ref.reset(static_cast<Metadata*>(md));
+			ref_.Reset(static_cast<Metadata*>(md));
 		}
 
 		bool HasTrivialDestructor() const
@@ -37,6 +37,9 @@
 
 #pragma once
 
+#include <cstdint>
+
+#include <boost/assert.hpp>
 #include <boost/core/noncopyable.hpp>
 
 namespace Dilithium
@@ -48,14 +51,16 @@ namespace Dilithium
 
 	class Use : boost::noncopyable
 	{
+		friend class User;
 		friend class Value;
 
 	public:
 		Use()
-			: val_(nullptr)
+			: val_(nullptr), next_(nullptr), prev_ptr_tag_(0)
 		{
 		}
 		Use(Use&& rhs)
+			: val_(nullptr), next_(nullptr), prev_ptr_tag_(rhs.prev_ptr_tag_)
 		{
 			this->Set(rhs.val_);
 		}
@@ -96,11 +101,6 @@ namespace Dilithium
 
 		static Use* InitTags(Use* beg, Use* end);
 
-	private:
-		Use const * GetImpliedUser() const;
-		void AddToList(Use** node);
-		void RemoveFromList();
-
 	private:
 		enum PrevPtrTag
 		{
@@ -110,10 +110,41 @@ namespace Dilithium
 			FullStopTag
 		};
 
+		static uintptr_t constexpr TAG_MASK = 3;
+
+		Use const * GetImpliedUser() const;
+		void AddToList(Use** node);
+		void RemoveFromList();
+
+		// The waymarking tag is packed into the low 2 bits of the prev pointer. Use* is at least 4-byte aligned.
+		Use** PrevPtr() const
+		{
+			return reinterpret_cast<Use**>(prev_ptr_tag_ & ~TAG_MASK);
+		}
+		void PrevPtr(Use** prev)
+		{
+			prev_ptr_tag_ = reinterpret_cast<uintptr_t>(prev) | (prev_ptr_tag_ & TAG_MASK);
+		}
+		PrevPtrTag Tag() const
+		{
+			return static_cast<PrevPtrTag>(prev_ptr_tag_ & TAG_MASK);
+		}
+		void Tag(PrevPtrTag tag)
+		{
+			prev_ptr_tag_ = (prev_ptr_tag_ & ~TAG_MASK) | tag;
+		}
+
+		// The Use one past the operands doesn't belong to any list. It holds the owner, and is what GetImpliedUser lands on.
+		void ImpliedUser(User* user)
+		{
+			BOOST_ASSERT_MSG(!val_, "Only an unused Use can point to its User");
+			prev_ptr_tag_ = reinterpret_cast<uintptr_t>(user);
+		}
+
+	private:
 		Value* val_;
 		Use* next_;
-		Use** prev_ptr_;
-		PrevPtrTag tag_;
+		uintptr_t prev_ptr_tag_;
 
 		// DILITHIUM_NOT_IMPLEMENTED
 	};
@@ -55,6 +55,7 @@ namespace Dilithium
 	class ModuleSlotTracker;
 	class Type;
 	class User;
+	class ValueHandleBase;
 
 	class Value : boost::noncopyable
 	{
@@ -333,6 +334,8 @@ namespace Dilithium
 			return is_used_by_md_;
 		}
 
+		uint32_t NumValueHandles() const;
+
 		Value* StripPointerCasts();
 
 		void MutateType(Type* ty)
@@ -371,6 +374,8 @@ namespace Dilithium
 	private:
 		Type* type_;
 		Use* use_list_;
+		// Head of the intrusive list of value handles watching this value. Only valid when has_value_handle_ is set.
+		ValueHandleBase* handle_list_;
 
 		uint8_t const subclass_id_;
 		uint8_t has_value_handle_ : 1;
@@ -0,0 +1,125 @@
+/**
+ * @file DxilCBufferLayout.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DILITHIUM_DXIL_CBUFFER_LAYOUT_HPP
+#define _DILITHIUM_DXIL_CBUFFER_LAYOUT_HPP
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+namespace Dilithium
+{
+	class DxilFieldAnnotation;
+	class DxilTypeSystem;
+	class StructType;
+	class Type;
+
+	// Byte offsets and sizes of a struct's elements inside a constant buffer
+	class DxilCBufferStructLayout
+	{
+		friend class DxilCBufferLayout;
+
+	public:
+		uint32_t SizeInBytes() const
+		{
+			return size_;
+		}
+
+		uint32_t NumElements() const
+		{
+			return static_cast<uint32_t>(offsets_.size());
+		}
+		uint32_t ElementOffset(uint32_t index) const
+		{
+			return offsets_[index];
+		}
+		uint32_t ElementSize(uint32_t index) const
+		{
+			return sizes_[index];
+		}
+
+	private:
+		uint32_t size_;
+		std::vector<uint32_t> offsets_;
+		std::vector<uint32_t> sizes_;
+	};
+
+	// The HLSL constant buffer packing rules, the counterpart of DataLayout/StructLayout for cbuffers.
+	// Data is packed into 16-byte rows and nothing straddles a row. Arrays, structs and matrices of more than one vector
+	// start on a new row, and every array element but the last is padded to a whole row. Matrix orientation comes from
+	// the field annotations, column major if there is none.
+	// Layouts are computed once per struct and cached. GetStructLayout is thread-safe.
+	class DxilCBufferLayout : boost::noncopyable
+	{
+	public:
+		explicit DxilCBufferLayout(DxilTypeSystem& type_system);
+
+		DxilCBufferStructLayout const * GetStructLayout(StructType const * st) const;
+		// Lays out every annotated struct, so later lookups only hit the cache
+		void Precompute() const;
+
+		// annotation may be nullptr
+		uint32_t TypeSize(Type* ty, DxilFieldAnnotation const * annotation) const;
+
+		// True if the cbuffer offsets and size in st's annotation match the computed layout
+		bool VerifyAnnotation(StructType const * st) const;
+		// Writes the computed offsets and size into st's annotation, adding one if st has none
+		void SynthesizeAnnotation(StructType const * st);
+
+	private:
+		struct FieldPlacement
+		{
+			uint32_t size;
+			uint32_t scalar_size;
+			bool new_row;
+		};
+
+		FieldPlacement MeasureField(Type* ty, DxilFieldAnnotation const * annotation) const;
+		std::unique_ptr<DxilCBufferStructLayout> LayoutStruct(StructType const * st) const;
+
+	private:
+		DxilTypeSystem& type_system_;
+
+		mutable std::mutex layouts_mutex_;
+		mutable std::unordered_map<StructType const *, std::unique_ptr<DxilCBufferStructLayout>> layouts_;
+	};
+}
+
+#endif		// _DILITHIUM_DXIL_CBUFFER_LAYOUT_HPP
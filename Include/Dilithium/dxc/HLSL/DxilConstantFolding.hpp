@@ -0,0 +1,55 @@
+/**
+ * @file DxilConstantFolding.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DILITHIUM_DXIL_CONSTANT_FOLDING_HPP
+#define _DILITHIUM_DXIL_CONSTANT_FOLDING_HPP
+
+#pragma once
+
+namespace Dilithium
+{
+	class CallInst;
+	class Constant;
+	class LLVMModule;
+
+	// Folds a ReadNone dx.op call whose arguments are all constants. Returns nullptr if the call can't be folded exactly,
+	// for example when an f16/f32 denormal is involved, since DXIL leaves flushing them to the driver.
+	Constant* ConstantFoldDxilCall(CallInst const & call);
+
+	// Folds dx.op calls over the whole module in one pass, revisiting the users of every folded call.
+	// Returns the number of calls removed.
+	uint32_t FoldDxilConstants(LLVMModule& module);
+}
+
+#endif		// _DILITHIUM_DXIL_CONSTANT_FOLDING_HPP
@@ -38,10 +38,17 @@
 #pragma once
 
 #include <Dilithium/Util.hpp>
+#include <Dilithium/ArrayRef.hpp>
 #include <Dilithium/dxc/HLSL/DxilConstants.hpp>
 
+#include <utility>
+
+#include <boost/container/small_vector.hpp>
+
 namespace Dilithium
 {
+	struct PSVRuntimeInfo0;
+
 #pragma pack(push, 1)
 	size_t constexpr DxilContainerHashSize = 16;
 	uint16_t constexpr DxilContainerVersionMajor = 1;  // Current major version
@@ -218,6 +225,24 @@ namespace Dilithium
 
 	// Easy to get this wrong. Earlier assertions can help determine
 	static_assert(sizeof(DxilProgramSignatureElement) == 0x20, "DxilProgramSignatureElement is misaligned");
+
+	// Serialized root signature, the content of a RTS0 part. Offsets are from the start of the part data.
+	struct DxilContainerRootSignatureDesc
+	{
+		uint32_t Version;
+		uint32_t NumParameters;
+		uint32_t RootParametersOffset;
+		uint32_t NumStaticSamplers;
+		uint32_t StaticSamplersOffset;	// Points to DxilStaticSamplerDesc[NumStaticSamplers]
+		uint32_t Flags;
+	};
+
+	struct DxilContainerRootParameter
+	{
+		uint32_t ParameterType;
+		uint32_t ShaderVisibility;
+		uint32_t PayloadOffset;
+	};
 #pragma pack(pop)
 
 	DxilPartHeader const * GetDxilContainerPart(DxilContainerHeader const * header, uint32_t index);
@@ -245,6 +270,51 @@ namespace Dilithium
 	void GetDxilProgramBitcode(DxilProgramHeader const * header, uint8_t const ** bitcode, uint32_t* bitcode_length);
 	bool IsValidDxilProgramHeader(DxilProgramHeader const * header, uint32_t length);
 
+	// Validates a container once and indexes its parts by FourCC. The typed getters check that the part is big enough
+	// for what they return, and point into the container's memory, which has to outlive the reader. They return
+	// nullptr if the part is missing or malformed. Like the linear scans it replaces, the first part of each FourCC wins.
+	class DxilContainerReader
+	{
+	public:
+		DxilContainerReader();
+
+		// Returns false, and leaves the reader empty, if ptr isn't a valid container. A reader can be loaded again to
+		// inspect many containers without reallocating.
+		bool Load(void const * ptr, size_t length);
+		void Clear();
+
+		bool IsLoaded() const
+		{
+			return header_ != nullptr;
+		}
+		DxilContainerHeader const * GetHeader() const
+		{
+			return header_;
+		}
+
+		DxilPartHeader const * FindPart(uint32_t four_cc) const;
+		bool HasPart(uint32_t four_cc) const
+		{
+			return this->FindPart(four_cc) != nullptr;
+		}
+		// Empty if the part is missing
+		ArrayRef<uint8_t> GetPartData(uint32_t four_cc) const;
+
+		// DFCC_DXIL or DFCC_ShaderDebugInfoDXIL
+		DxilProgramHeader const * GetProgramHeader(uint32_t four_cc = DFCC_DXIL) const;
+		// DFCC_InputSignature, DFCC_OutputSignature or DFCC_PatchConstantSignature. The elements and their semantic
+		// names are checked too.
+		DxilProgramSignature const * GetSignature(uint32_t four_cc) const;
+		DxilShaderFeatureInfo const * GetFeatureInfo() const;
+		PSVRuntimeInfo0 const * GetPSVRuntimeInfo() const;
+		// The parameter and static sampler tables are checked too
+		DxilContainerRootSignatureDesc const * GetRootSignature() const;
+
+	private:
+		DxilContainerHeader const * header_;
+		boost::container::small_vector<std::pair<uint32_t, DxilPartHeader const *>, 8> parts_;
+	};
+
 	// Extract the shader type from the program version value.
 	inline ShaderKind GetVersionShaderType(uint32_t program_version)
 	{
@@ -44,17 +44,26 @@ namespace Dilithium
 	class Type;
 	class Function;
 	class Constant;
+	class ConstantInt;
+	class StructType;
 	class Value;
 	class Instruction;
 };
 
+#include <Dilithium/ArrayRef.hpp>
 #include <Dilithium/Attributes.hpp>
 #include <Dilithium/dxc/HLSL/DxilConstants.hpp>
 
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
 namespace Dilithium
 {
 	class OP
 	{
+		friend class DxilPrelude;
+
 	public:
 		OP() = delete;
 		OP(LLVMContext& ctx, LLVMModule* module);
@@ -65,6 +74,8 @@ namespace Dilithium
 		}
 
 		static char const * GetOpCodeName(OpCode op);
+		static OpCodeClass GetOpCodeClass(OpCode op);
+		static Attribute::AttrKind GetFunctionAttribute(OpCode op);
 		static bool IsDxilOpFunc(Function const * func);
 
 	private:
@@ -88,6 +99,74 @@ namespace Dilithium
 
 		static char const * name_prefix_;
 	};
+
+	// The dx.types.* structs, dx.op function attribute sets and opcode constants that every DXIL module re-creates.
+	// Built once per context from OP::op_code_props_ (see LLVMContext::GetDxilPrelude), immutable afterwards.
+	// Build it before loading modules into the context, so the prelude owns the dx.types.* names.
+	class DxilPrelude : boost::noncopyable
+	{
+	public:
+		explicit DxilPrelude(LLVMContext& context);
+
+		StructType* HandleType() const
+		{
+			return handle_ty_;
+		}
+		StructType* DimensionsType() const
+		{
+			return dimensions_ty_;
+		}
+		StructType* SamplePosType() const
+		{
+			return sample_pos_ty_;
+		}
+		StructType* SplitDoubleType() const
+		{
+			return split_double_ty_;
+		}
+		StructType* TwoI32Type() const
+		{
+			return two_i32_ty_;
+		}
+		StructType* I32CarryType() const
+		{
+			return i32_carry_ty_;
+		}
+		// nullptr if no opcode loads that overload
+		StructType* ResRetType(Type* overload) const;
+		StructType* CBufRetType(Type* overload) const;
+
+		// nounwind plus the function attribute from the opcode table
+		AttributeSet OpFunctionAttributes(OpCode op) const;
+		ConstantInt* OpCodeConstant(OpCode op) const
+		{
+			return op_code_constants_[static_cast<uint32_t>(op)];
+		}
+
+		// The prelude struct with this name and body, or nullptr. Lets the reader reuse the prelude types.
+		StructType* FindStructType(std::string_view name, ArrayRef<Type*> elements, bool is_packed) const;
+
+	private:
+		StructType* CreateStructType(std::string_view name, ArrayRef<Type*> elements);
+
+	private:
+		LLVMContext& context_;
+
+		StructType* handle_ty_;
+		StructType* dimensions_ty_;
+		StructType* sample_pos_ty_;
+		StructType* split_double_ty_;
+		StructType* two_i32_ty_;
+		StructType* i32_carry_ty_;
+		StructType* res_ret_tys_[OP::NumTypeOverloads];
+		StructType* cbuf_ret_tys_[OP::NumTypeOverloads];
+		std::vector<StructType*> struct_types_;
+
+		AttributeSet read_none_attrs_;
+		AttributeSet read_only_attrs_;
+		AttributeSet no_attrs_;
+		std::vector<ConstantInt*> op_code_constants_;
+	};
 }
 
 #endif		// _DILITHIUM_DXIL_OPERATIONS_HPP
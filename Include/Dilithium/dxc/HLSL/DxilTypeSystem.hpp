@@ -175,6 +175,8 @@ namespace Dilithium
 
 	class DxilStructAnnotation
 	{
+		friend class DxilTypeSystem;
+
 	public:
 		uint32_t NumFields() const;
 		DxilFieldAnnotation& FieldAnnotation(uint32_t index);
@@ -0,0 +1,80 @@
+/**
+ * @file AnalysisManager.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/AnalysisManager.hpp>
+
+namespace Dilithium
+{
+	DominatorTree const & FunctionAnalysisManager::GetDominatorTree(Function const & func)
+	{
+		auto& cached = analyses_[&func];
+		if (!cached.dom_tree)
+		{
+			cached.dom_tree.reset(new DominatorTree(func));
+		}
+		return *cached.dom_tree;
+	}
+
+	PostDominatorTree const & FunctionAnalysisManager::GetPostDominatorTree(Function const & func)
+	{
+		auto& cached = analyses_[&func];
+		if (!cached.post_dom_tree)
+		{
+			cached.post_dom_tree.reset(new PostDominatorTree(func));
+		}
+		return *cached.post_dom_tree;
+	}
+
+	LoopInfo const & FunctionAnalysisManager::GetLoopInfo(Function const & func)
+	{
+		auto& cached = analyses_[&func];
+		if (!cached.loop_info)
+		{
+			auto const & dom_tree = this->GetDominatorTree(func);
+			cached.loop_info.reset(new LoopInfo(func, dom_tree));
+		}
+		return *cached.loop_info;
+	}
+
+	void FunctionAnalysisManager::InvalidateCFG(Function const & func)
+	{
+		analyses_.erase(&func);
+	}
+
+	void FunctionAnalysisManager::Clear()
+	{
+		analyses_.clear();
+	}
+}
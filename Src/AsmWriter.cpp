@@ -41,7 +41,15 @@
 #include <Dilithium/GlobalVariable.hpp>
 #include <Dilithium/Instructions.hpp>
 #include <Dilithium/LLVMModule.hpp>
-
+#include <Dilithium/RawOStream.hpp>
+#include <Dilithium/SmallString.hpp>
+#include "FloatFormat.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <ostream>
+#include <thread>
 #include <unordered_set>
 
 namespace
@@ -62,7 +70,7 @@ namespace
 
 	// PrintEscapedString - Print each character of the specified string, escaping
 	// it if it is not printable or if it is an escape char.
-	void PrintEscapedString(std::string_view name, std::ostream& os)
+	void PrintEscapedString(std::string_view name, RawOStream& os)
 	{
 		for (size_t i = 0, e = name.size(); i != e; ++ i)
 		{
@@ -73,7 +81,8 @@ namespace
 			}
 			else
 			{
-				os << '\\' << std::hex << static_cast<int>(c);
+				os << '\\';
+				os.WriteHex(c, 2);
 			}
 		}
 	}
@@ -81,7 +90,7 @@ namespace
 	/// PrintLLVMName - Turn the specified name into an 'LLVM name', which is either
 	/// prefixed with % (if the string only contains simple characters) or is
 	/// surrounded with ""'s (if it has special chars in it).  Print it out.
-	void PrintLLVMName(std::ostream& os, std::string_view name, PrefixType prefix)
+	void PrintLLVMName(RawOStream& os, std::string_view name, PrefixType prefix)
 	{
 		BOOST_ASSERT_MSG(!name.empty(), "Cannot get empty name!");
 		switch (prefix)
@@ -134,12 +143,12 @@ namespace
 		os << '"';
 	}
 
-	void PrintLLVMName(std::ostream& os, Value const * v)
+	void PrintLLVMName(RawOStream& os, Value const * v)
 	{
 		PrintLLVMName(os, v->Name(), isa<GlobalValue>(v) ? GlobalPrefix : LocalPrefix);
 	}
 
-	void PrintLinkage(GlobalValue::LinkageTypes lt, std::ostream& os)
+	void PrintLinkage(GlobalValue::LinkageTypes lt, RawOStream& os)
 	{
 		switch (lt)
 		{
@@ -178,7 +187,7 @@ namespace
 		}
 	}
 
-	void PrintVisibility(GlobalValue::VisibilityTypes vis, std::ostream& os)
+	void PrintVisibility(GlobalValue::VisibilityTypes vis, RawOStream& os)
 	{
 		switch (vis)
 		{
@@ -193,7 +202,7 @@ namespace
 		}
 	}
 
-	void PrintDLLStorageClass(GlobalValue::DLLStorageClassTypes sct, std::ostream& os)
+	void PrintDLLStorageClass(GlobalValue::DLLStorageClassTypes sct, RawOStream& os)
 	{
 		switch (sct)
 		{
@@ -208,7 +217,7 @@ namespace
 		}
 	}
 
-	void PrintMetadataIdentifier(std::string_view name, std::ostream& os)
+	void PrintMetadataIdentifier(std::string_view name, RawOStream& os)
 	{
 		if (name.empty())
 		{
@@ -222,7 +231,8 @@ namespace
 			}
 			else
 			{
-				os << '\\' << std::hex << static_cast<int>(name[0]);
+				os << '\\';
+				os.WriteHex(static_cast<uint8_t>(name[0]), 2);
 			}
 			for (size_t i = 1, e = name.size(); i != e; ++ i)
 			{
@@ -233,13 +243,14 @@ namespace
 				}
 				else
 				{
-					os << '\\' << std::hex << static_cast<int>(c);
+					os << '\\';
+					os.WriteHex(c, 2);
 				}
 			}
 		}
 	}
 
-	void WriteConstantInternal(std::ostream& os, Constant const * cv, TypePrinting& type_printer, SlotTracker* machine,
+	void WriteConstantInternal(RawOStream& os, Constant const * cv, TypePrinting& type_printer, SlotTracker* machine,
 		LLVMModule const * context)
 	{
 		auto ci = dyn_cast<ConstantInt>(cv);
@@ -250,7 +261,17 @@ namespace
 				os << (ci->ZExtValue() ? "true" : "false");
 				return;
 			}
-			os << ci->GetValue();
+			MPInt const & val = ci->GetValue();
+			if (val.IsSingleWord())
+			{
+				os << val.SExtValue();
+			}
+			else
+			{
+				SmallString<40> str;
+				val.ToString(str, 10, true, false);
+				os.Write(str.data(), str.size());
+			}
 			return;
 		}
 
@@ -260,11 +281,6 @@ namespace
 			if ((&cfp->GetValueMPF().Semantics() == &MPFloat::IEEESingle)
 				|| (&cfp->GetValueMPF().Semantics() == &MPFloat::IEEEDouble))
 			{
-				// We would like to output the FP constant value in exponential notation,
-				// but we cannot do this if doing so will lose precision.  Check here to
-				// make sure that we only output it in exponential format if we can parse
-				// the value back and get the same value.
-				//
 				bool ignored;
 				bool is_half = &cfp->GetValueMPF().Semantics() == &MPFloat::IEEEHalf;
 				bool is_double = &cfp->GetValueMPF().Semantics() == &MPFloat::IEEEDouble;
@@ -272,26 +288,14 @@ namespace
 				bool is_nan = cfp->GetValueMPF().IsNaN();
 				if (!is_half && !is_inf && !is_nan)
 				{
+					// Print the shortest decimal that parses back to the same double. Floats are widened exactly,
+					// so it also reads back as the same float.
 					double val = is_double ? cfp->GetValueMPF().ConvertToDouble() : cfp->GetValueMPF().ConvertToFloat();
-					std::string str_val = std::to_string(val);
-
-					// Check to make sure that the stringized number is not some string like
-					// "Inf" or NaN, that atof will accept, but the lexer will not.  Check
-					// that the string matches the "[-+]?[0-9]" regex.
-					//
-					if (((str_val[0] >= '0') && (str_val[0] <= '9'))
-						|| (((str_val[0] == '-') || (str_val[0] == '+')) && ((str_val[1] >= '0') && (str_val[1] <= '9'))))
-					{
-						// Reparse stringized version!
-						if (MPFloat(MPFloat::IEEEDouble, str_val).ConvertToDouble() == val)
-						{
-							os << str_val;
-							return;
-						}
-					}
+					char buf[FloatFormatBufferSize];
+					os.Write(buf, FormatShortestDouble(val, buf));
+					return;
 				}
-				// Otherwise we could not reparse it to exactly the same value, so we must
-				// output the string in hexadecimal format!  Note that loading and storing
+				// Infinities and NaNs are printed in hexadecimal format. Note that loading and storing
 				// floating point types changes the bits of NaNs on some hosts, notably
 				// x86, so we must not use these types.
 				static_assert(sizeof(double) == sizeof(uint64_t), "assuming that double is 64 bits!");
@@ -301,7 +305,8 @@ namespace
 				{
 					mpf.Convert(MPFloat::IEEEDouble, &ignored);
 				}
-				os << "0x" << std::hex << mpf.BitcastToMPInt().ZExtValue();
+				os << "0x";
+				os.WriteHex(mpf.BitcastToMPInt().ZExtValue());
 				return;
 			}
 
@@ -322,7 +327,7 @@ namespace
 			}
 			// api needed to prevent premature destruction
 			MPInt mpi = cfp->GetValueMPF().BitcastToMPInt();
-			uint64_t const word = mpi.RawData();
+			uint64_t const word = mpi.RawData()[0];
 			int const width = mpi.BitWidth();
 			BOOST_ASSERT(width <= 64);
 			for (int j = 0; j < width; j += 4, shift_count -= 4)
@@ -330,11 +335,11 @@ namespace
 				uint32_t nibble = (word >> shift_count) & 15;
 				if (nibble < 10)
 				{
-					os << static_cast<uint8_t>(nibble + '0');
+					os << static_cast<char>(nibble + '0');
 				}
 				else
 				{
-					os << static_cast<uint8_t>(nibble - 10 + 'A');
+					os << static_cast<char>(nibble - 10 + 'A');
 				}
 			}
 			return;
@@ -511,9 +516,9 @@ namespace
 		DILITHIUM_NOT_IMPLEMENTED;
 	}
 
-	void WriteAsOperandInternal(std::ostream& os, Metadata const * md, TypePrinting* type_printer, SlotTracker* machine,
+	void WriteAsOperandInternal(RawOStream& os, Metadata const * md, TypePrinting* type_printer, SlotTracker* machine,
 		LLVMModule const * context, bool from_value = false);
-	void WriteAsOperandInternal(std::ostream& os, Value const * v, TypePrinting* type_printer, SlotTracker* machine,
+	void WriteAsOperandInternal(RawOStream& os, Value const * v, TypePrinting* type_printer, SlotTracker* machine,
 		LLVMModule const * context);
 
 	/// This class provides computation of slot numbers for LLVM Assembly writing.
@@ -531,7 +536,7 @@ namespace
 		/// within a function (even if no functions have been initialized).
 		explicit SlotTracker(LLVMModule const * module, bool should_initialize_all_metadata = false)
 			: module_(module), function_(nullptr), function_processed_(false),
-				should_initialize_all_metadata_(should_initialize_all_metadata),
+				should_initialize_all_metadata_(should_initialize_all_metadata), module_slots_(nullptr),
 				module_next_(0), function_next_(0), mdn_next_(0), as_next_(0)
 		{
 		}
@@ -542,9 +547,20 @@ namespace
 		/// within a function (even if no functions have been initialized).
 		explicit SlotTracker(Function const * func, bool should_initialize_all_metadata = false)
 			: module_(func ? func->Parent() : nullptr), function_(func), function_processed_(false),
-				should_initialize_all_metadata_(should_initialize_all_metadata),
+				should_initialize_all_metadata_(should_initialize_all_metadata), module_slots_(nullptr),
+				module_next_(0), function_next_(0), mdn_next_(0), as_next_(0)
+		{
+		}
+		/// Construct a function level tracker on top of an initialized module
+		/// level one. Metadata and attribute group slots are looked up in
+		/// module_slots, which must already hold every slot the function uses.
+		/// Several of these can be used on different threads at the same time.
+		SlotTracker(SlotTracker const & module_slots, Function const * func)
+			: module_(nullptr), function_(func), function_processed_(false),
+				should_initialize_all_metadata_(false), module_slots_(&module_slots),
 				module_next_(0), function_next_(0), mdn_next_(0), as_next_(0)
 		{
+			BOOST_ASSERT_MSG(!module_slots.module_ && !module_slots.function_, "Module slots are not initialized!");
 		}
 
 		/// Return the slot number of the specified value in it's type
@@ -566,18 +582,38 @@ namespace
 		}
 		int GetMetadataSlot(MDNode const * n)
 		{
+			if (module_slots_)
+			{
+				return module_slots_->FindMetadataSlot(n);
+			}
+
 			// Check for uninitialized state and do lazy initialization.
 			this->Initialize();
 
-			// Find the MDNode in the module map
-			auto iter = mdn_map_.find(n);
-			return iter == mdn_map_.end() ? -1 : static_cast<int>(iter->second);
+			return this->FindMetadataSlot(n);
 		}
 		int GetAttributeGroupSlot(AttributeSet as)
 		{
+			if (module_slots_)
+			{
+				return module_slots_->FindAttributeGroupSlot(as);
+			}
+
 			// Check for uninitialized state and do lazy initialization.
 			this->Initialize();
 
+			return this->FindAttributeGroupSlot(as);
+		}
+
+		/// Look up an already created slot, without initializing anything.
+		int FindMetadataSlot(MDNode const * n) const
+		{
+			// Find the MDNode in the module map
+			auto iter = mdn_map_.find(n);
+			return iter == mdn_map_.end() ? -1 : static_cast<int>(iter->second);
+		}
+		int FindAttributeGroupSlot(AttributeSet as) const
+		{
 			// Find the AttributeSet in the module map.
 			auto iter = as_map_.find(as);
 			return iter == as_map_.end() ? -1 : static_cast<int>(iter->second);
@@ -779,7 +815,11 @@ namespace
 					this->CreateFunctionSlot(bb.get());
 				}
 
-				this->ProcessFunctionMetadata(*function_);
+				// Shared module slots already have the metadata and attribute groups.
+				if (!module_slots_)
+				{
+					this->ProcessFunctionMetadata(*function_);
+				}
 
 				for (auto& inst : *bb)
 				{
@@ -788,6 +828,11 @@ namespace
 						this->CreateFunctionSlot(inst.get());
 					}
 
+					if (module_slots_)
+					{
+						continue;
+					}
+
 					// We allow direct calls to any llvm.foo function here, because the
 					// target may not be linked into the optimizer.
 					auto const * ci = dyn_cast<CallInst>(inst.get());
@@ -855,6 +900,9 @@ namespace
 		bool function_processed_;
 		bool should_initialize_all_metadata_;
 
+		/// module_slots_ - Shared module level slots, if this only tracks a function.
+		SlotTracker const * module_slots_;
+
 		/// module_map_ - The slot map for the module level data.
 		ValueMap module_map_;
 		uint32_t module_next_;
@@ -1169,7 +1217,7 @@ namespace
 			named_types_.erase(next_to_use, named_types_.end());
 		}
 
-		void Print(Type* ty, std::ostream& os)
+		void Print(Type* ty, RawOStream& os)
 		{
 			switch (ty->GetTypeId())
 			{
@@ -1288,7 +1336,7 @@ namespace
 			
 			DILITHIUM_UNREACHABLE("Invalid TypeID");
 		}
-		void PrintStructBody(StructType const * ty, std::ostream& os)
+		void PrintStructBody(StructType const * ty, RawOStream& os)
 		{
 			if (ty->IsOpaque())
 			{
@@ -1363,7 +1411,7 @@ namespace
 		return std::unique_ptr<SlotTracker>();
 	}
 
-	void WriteMDTuple(std::ostream& os, MDTuple const * node, TypePrinting* type_printer, SlotTracker* machine,
+	void WriteMDTuple(RawOStream& os, MDTuple const * node, TypePrinting* type_printer, SlotTracker* machine,
 		LLVMModule const * context)
 	{
 		os << "!{";
@@ -1399,7 +1447,7 @@ namespace
 		os << "}";
 	}
 
-	void WriteMDNodeBodyInternal(std::ostream& os, MDNode const * node, TypePrinting* type_printer, SlotTracker* machine,
+	void WriteMDNodeBodyInternal(RawOStream& os, MDNode const * node, TypePrinting* type_printer, SlotTracker* machine,
 		LLVMModule const * context)
 	{
 		if (node->IsDistinct())
@@ -1426,7 +1474,7 @@ namespace
 
 	// Full implementation of printing a Value as an operand with support for
 	// TypePrinting, etc.
-	void WriteAsOperandInternal(std::ostream& os, Value const * v, TypePrinting* type_printer, SlotTracker* machine,
+	void WriteAsOperandInternal(RawOStream& os, Value const * v, TypePrinting* type_printer, SlotTracker* machine,
 		LLVMModule const * context)
 	{
 		if (v->HasName())
@@ -1511,7 +1559,7 @@ namespace
 		}
 	}
 
-	void WriteAsOperandInternal(std::ostream& os, Metadata const * md, TypePrinting* type_printer, SlotTracker* machine,
+	void WriteAsOperandInternal(RawOStream& os, Metadata const * md, TypePrinting* type_printer, SlotTracker* machine,
 		LLVMModule const * context, bool from_value)
 	{
 		auto n = dyn_cast<MDNode>(md);
@@ -1555,14 +1603,62 @@ namespace
 		WriteAsOperandInternal(os, v->GetValue(), type_printer, machine, context);
 	}
 
+	LLVMModule const * GetModuleFromVal(Value const * v)
+	{
+		auto arg = dyn_cast<Argument>(v);
+		if (arg)
+		{
+			return arg->Parent() ? arg->Parent()->Parent() : nullptr;
+		}
+
+		auto bb = dyn_cast<BasicBlock>(v);
+		if (bb)
+		{
+			return bb->Parent() ? bb->Parent()->Parent() : nullptr;
+		}
+
+		auto inst = dyn_cast<Instruction>(v);
+		if (inst)
+		{
+			auto func = inst->Parent() ? inst->Parent()->Parent() : nullptr;
+			return func ? func->Parent() : nullptr;
+		}
+
+		auto gv = dyn_cast<GlobalValue>(v);
+		if (gv)
+		{
+			return gv->Parent();
+		}
+
+		return nullptr;
+	}
+
 	class AssemblyWriter
 	{
 	public:
-		AssemblyWriter(std::ostream& os, SlotTracker& mac, LLVMModule const * module, AssemblyAnnotationWriter* aaw)
-			: os_(os), module_(module), machine_(mac), annotation_writer_(aaw)
+		AssemblyWriter(RawOStream& os, SlotTracker& mac, LLVMModule const * module, AssemblyAnnotationWriter* aaw)
+			: os_(os), annotation_buf_(os), annotation_os_(&annotation_buf_),
+				module_(module), machine_(mac),
+				type_printer_storage_(std::make_unique<TypePrinting>()), type_printer_(*type_printer_storage_),
+				annotation_writer_(aaw)
 		{
 			this->Init();
 		}
+		/// Construct a writer that uses type names already incorporated into
+		/// type_printer, instead of collecting them from the module again.
+		AssemblyWriter(RawOStream& os, SlotTracker& mac, TypePrinting& type_printer, LLVMModule const * module,
+			AssemblyAnnotationWriter* aaw)
+			: os_(os), annotation_buf_(os), annotation_os_(&annotation_buf_),
+				module_(module), machine_(mac), type_printer_(type_printer), annotation_writer_(aaw)
+		{
+		}
+		/// Construct a writer for printing functions of the parent's module. It
+		/// shares the parent's type printer and metadata kind names read-only.
+		AssemblyWriter(RawOStream& os, SlotTracker& mac, AssemblyWriter const & parent)
+			: AssemblyWriter(os, mac, parent.type_printer_, parent.module_, parent.annotation_writer_)
+		{
+			md_names_ = parent.md_names_;
+		}
 
 		void PrintMDNodeBody(MDNode const * node)
 		{
@@ -1592,7 +1688,7 @@ namespace
 			os_ << "}\n";
 		}
 
-		void PrintModule(LLVMModule const * module)
+		void PrintModule(LLVMModule const * module, uint32_t num_threads)
 		{
 			machine_.Initialize();
 
@@ -1617,9 +1713,16 @@ namespace
 			this->PrintTypeIdentities();
 
 			// Output all of the functions.
-			for (auto& func : *module)
+			if (num_threads > 1)
 			{
-				this->PrintFunction(func.get());
+				this->PrintFunctionsParallel(module, num_threads);
+			}
+			else
+			{
+				for (auto& func : *module)
+				{
+					this->PrintFunction(func.get());
+				}
 			}
 
 			// Output all attribute groups.
@@ -1760,7 +1863,56 @@ namespace
 				os_ << '\n';
 			}
 		}
-		void PrintGlobal(GlobalVariable const * gv);
+		void PrintGlobal(GlobalVariable const * gv)
+		{
+			WriteAsOperandInternal(os_, gv, &type_printer_, &machine_, gv->Parent());
+			os_ << " = ";
+
+			if (!gv->HasInitializer() && (gv->Linkage() == GlobalValue::ExternalLinkage))
+			{
+				os_ << "external ";
+			}
+
+			PrintLinkage(gv->Linkage(), os_);
+			PrintVisibility(gv->Visibility(), os_);
+			PrintDLLStorageClass(gv->DLLStorageClass(), os_);
+			if (gv->HasUnnamedAddr())
+			{
+				os_ << "unnamed_addr ";
+			}
+
+			auto pty = cast<PointerType>(gv->GetType());
+			if (pty->AddressSpace() != 0)
+			{
+				os_ << "addrspace(" << pty->AddressSpace() << ") ";
+			}
+			if (gv->IsExternallyInitialized())
+			{
+				os_ << "externally_initialized ";
+			}
+			os_ << (gv->IsConstant() ? "constant " : "global ");
+			type_printer_.Print(pty->ElementType(), os_);
+
+			if (gv->HasInitializer())
+			{
+				os_ << ' ';
+				this->WriteOperand(gv->GetInitializer(), false);
+			}
+
+			if (gv->HasSection())
+			{
+				os_ << ", section \"";
+				PrintEscapedString(gv->GetSection(), os_);
+				os_ << '"';
+			}
+			if (gv->GetAlignment())
+			{
+				os_ << ", align " << gv->GetAlignment();
+			}
+
+			this->PrintInfoComment(*gv);
+		}
+
 		void PrintFunction(Function const * func)
 		{
 			// Print out the return type and name.
@@ -1768,7 +1920,7 @@ namespace
 
 			if (annotation_writer_)
 			{
-				annotation_writer_->EmitFunctionAnnot(func, os_);
+				annotation_writer_->EmitFunctionAnnot(func, annotation_os_);
 			}
 
 			if (func->IsMaterializable())
@@ -1835,7 +1987,13 @@ namespace
 			os_ << ' ';
 			WriteAsOperandInternal(os_, func, &type_printer_, &machine_, func->Parent());
 			os_ << '(';
-			machine_.IncorporateFunction(func);
+			// Value::Print incorporates the function through its ModuleSlotTracker, which keeps the function numbered
+			// after this
+			bool const incorporate = (machine_.GetFunction() != func);
+			if (incorporate)
+			{
+				machine_.IncorporateFunction(func);
+			}
 
 			// Loop over the arguments, printing them...
 
@@ -1939,7 +2097,72 @@ namespace
 				os_ << "}\n";
 			}
 
-			machine_.PurgeFunction();
+			if (incorporate)
+			{
+				machine_.PurgeFunction();
+			}
+		}
+
+		/// Print each function into its own buffer on a pool of threads, and
+		/// append the buffers in order. The output is the same as PrintFunction
+		/// on every function, but the annotation writer is called concurrently.
+		void PrintFunctionsParallel(LLVMModule const * module, uint32_t num_threads)
+		{
+			std::vector<Function const *> funcs;
+			for (auto& func : *module)
+			{
+				funcs.push_back(func.get());
+			}
+
+			// Printing a function numbers the metadata and attribute groups it
+			// uses. Do that up front in the same function order, so the workers
+			// only read the module level slots.
+			for (auto func : funcs)
+			{
+				machine_.IncorporateFunction(func);
+				machine_.Initialize();
+				machine_.PurgeFunction();
+			}
+			if (md_names_.empty())
+			{
+				module_->MdKindNames(md_names_);
+			}
+
+			std::vector<std::unique_ptr<RawOStream>> buffers(funcs.size());
+			std::atomic<size_t> next_func(0);
+			auto worker = [this, &funcs, &buffers, &next_func]()
+			{
+				for (;;)
+				{
+					size_t const i = next_func.fetch_add(1);
+					if (i >= funcs.size())
+					{
+						break;
+					}
+
+					buffers[i] = std::make_unique<RawOStream>();
+					SlotTracker func_slots(machine_, funcs[i]);
+					AssemblyWriter w(*buffers[i], func_slots, *this);
+					w.PrintFunction(funcs[i]);
+				}
+			};
+
+			num_threads = static_cast<uint32_t>(std::min<size_t>(num_threads, funcs.size()));
+			std::vector<std::future<void>> workers;
+			for (uint32_t i = 1; i < num_threads; ++ i)
+			{
+				workers.push_back(std::async(std::launch::async, worker));
+			}
+			worker();
+			for (auto& w : workers)
+			{
+				w.get();
+			}
+
+			for (auto const & buffer : buffers)
+			{
+				os_ << buffer->Str();
+			}
 		}
 
 		void PrintArgument(Argument const * fa, AttributeSet attrs, uint32_t idx)
@@ -2007,7 +2230,7 @@ namespace
 
 			if (annotation_writer_)
 			{
-				annotation_writer_->EmitBasicBlockStartAnnot(bb, os_);
+				annotation_writer_->EmitBasicBlockStartAnnot(bb, annotation_os_);
 			}
 
 			// Output all of the instructions in the basic block...
@@ -2018,7 +2241,7 @@ namespace
 
 			if (annotation_writer_)
 			{
-				annotation_writer_->EmitBasicBlockEndAnnot(bb, os_);
+				annotation_writer_->EmitBasicBlockEndAnnot(bb, annotation_os_);
 			}
 		}
 
@@ -2032,7 +2255,7 @@ namespace
 		{
 			if (annotation_writer_)
 			{
-				annotation_writer_->EmitInstructionAnnot(&inst, os_);
+				annotation_writer_->EmitInstructionAnnot(&inst, annotation_os_);
 			}
 
 			// Print out indentation for an instruction.
@@ -2160,7 +2383,7 @@ namespace
 			if (mds.empty())
 				return;
 
-			if (md_names_.empty())
+			if (md_names_.empty() && module_)
 			{
 				module_->MdKindNames(md_names_);
 			}
@@ -2189,16 +2412,20 @@ namespace
 		{
 			if (annotation_writer_)
 			{
-				annotation_writer_->PrintInfoComment(val, os_);
+				annotation_writer_->PrintInfoComment(val, annotation_os_);
 			}
 		}
 
 	private:
-		std::ostream& os_;
+		RawOStream& os_;
+		// AssemblyAnnotationWriter takes a std::ostream, give it one that writes into os_
+		RawOStreamBuf annotation_buf_;
+		std::ostream annotation_os_;
 		LLVMModule const * module_;
 		std::unique_ptr<SlotTracker> slot_tracker_storage_;
 		SlotTracker& machine_;
-		TypePrinting type_printer_;
+		std::unique_ptr<TypePrinting> type_printer_storage_;
+		TypePrinting& type_printer_;
 		AssemblyAnnotationWriter* annotation_writer_;
 		boost::container::small_vector<std::string_view, 8> md_names_;
 	};
@@ -2206,6 +2433,68 @@ namespace
 
 namespace Dilithium
 {
+	struct ModuleSlotTrackerImpl
+	{
+		ModuleSlotTrackerImpl(LLVMModule const * mod, bool should_initialize_all_metadata)
+			: module(mod), function(nullptr), types_incorporated(false)
+		{
+			if (module)
+			{
+				machine = std::make_unique<SlotTracker>(module, should_initialize_all_metadata);
+			}
+		}
+
+		TypePrinting& TypePrinter()
+		{
+			if (!types_incorporated && module)
+			{
+				type_printer.IncorporateTypes(*module);
+			}
+			types_incorporated = true;
+			return type_printer;
+		}
+
+		LLVMModule const * module;
+		Function const * function;
+
+		// nullptr if there is no module
+		std::unique_ptr<SlotTracker> machine;
+
+		TypePrinting type_printer;
+		bool types_incorporated;
+	};
+
+
+	ModuleSlotTracker::ModuleSlotTracker(LLVMModule const * module, bool should_initialize_all_metadata)
+		: impl_(std::make_unique<ModuleSlotTrackerImpl>(module, should_initialize_all_metadata))
+	{
+	}
+
+	ModuleSlotTracker::~ModuleSlotTracker()
+	{
+	}
+
+	LLVMModule const * ModuleSlotTracker::GetModule() const
+	{
+		return impl_->module;
+	}
+
+	void ModuleSlotTracker::IncorporateFunction(Function const & func)
+	{
+		if (!impl_->machine || (impl_->function == &func))
+		{
+			return;
+		}
+
+		if (impl_->function)
+		{
+			impl_->machine->PurgeFunction();
+		}
+		impl_->machine->IncorporateFunction(&func);
+		impl_->function = &func;
+	}
+
+
 	AssemblyAnnotationWriter::~AssemblyAnnotationWriter()
 	{
 	}
@@ -2241,10 +2530,153 @@ namespace Dilithium
 	}
 
 
-	void LLVMModule::Print(std::ostream& os, AssemblyAnnotationWriter* aaw) const
+	void Value::Print(std::ostream& os) const
+	{
+		bool should_initialize_all_metadata = false;
+		if (isa<Function>(this) || isa<MetadataAsValue>(this))
+		{
+			should_initialize_all_metadata = true;
+		}
+		else
+		{
+			auto inst = dyn_cast<Instruction>(this);
+			if (inst)
+			{
+				for (uint32_t i = 0, e = inst->NumOperands(); i != e; ++ i)
+				{
+					auto mdv = dyn_cast_or_null<MetadataAsValue>(inst->Operand(i));
+					if (mdv && isa<MDNode>(mdv->GetMetadata()))
+					{
+						should_initialize_all_metadata = true;
+						break;
+					}
+				}
+			}
+		}
+
+		ModuleSlotTracker mst(GetModuleFromVal(this), should_initialize_all_metadata);
+		this->Print(os, mst);
+	}
+
+	void Value::Print(std::ostream& os, ModuleSlotTracker& mst) const
 	{
+		RawOStream raw_os(os);
+
+		auto& impl = mst.Impl();
+		SlotTracker empty_slot_table(static_cast<LLVMModule const *>(nullptr));
+		SlotTracker& slot_table = impl.machine ? *impl.machine : empty_slot_table;
+
+		auto inst = dyn_cast<Instruction>(this);
+		if (inst)
+		{
+			auto func = inst->Parent() ? inst->Parent()->Parent() : nullptr;
+			if (func)
+			{
+				mst.IncorporateFunction(*func);
+			}
+			AssemblyWriter w(raw_os, slot_table, impl.TypePrinter(), GetModuleFromVal(inst), nullptr);
+			w.PrintInstruction(*inst);
+			return;
+		}
+
+		auto bb = dyn_cast<BasicBlock>(this);
+		if (bb)
+		{
+			if (bb->Parent())
+			{
+				mst.IncorporateFunction(*bb->Parent());
+			}
+			AssemblyWriter w(raw_os, slot_table, impl.TypePrinter(), GetModuleFromVal(bb), nullptr);
+			w.PrintBasicBlock(bb);
+			return;
+		}
+
+		auto func = dyn_cast<Function>(this);
+		if (func)
+		{
+			mst.IncorporateFunction(*func);
+			AssemblyWriter w(raw_os, slot_table, impl.TypePrinter(), func->Parent(), nullptr);
+			w.PrintFunction(func);
+			return;
+		}
+
+		auto gv = dyn_cast<GlobalVariable>(this);
+		if (gv)
+		{
+			AssemblyWriter w(raw_os, slot_table, impl.TypePrinter(), gv->Parent(), nullptr);
+			w.PrintGlobal(gv);
+			return;
+		}
+
+		auto mdv = dyn_cast<MetadataAsValue>(this);
+		if (mdv)
+		{
+			WriteAsOperandInternal(raw_os, mdv->GetMetadata(), &impl.TypePrinter(), impl.machine.get(), impl.module,
+				true);
+			return;
+		}
+
+		auto c = dyn_cast<Constant>(this);
+		if (c && !isa<GlobalValue>(c))
+		{
+			auto& type_printer = impl.TypePrinter();
+			type_printer.Print(c->GetType(), raw_os);
+			raw_os << ' ';
+			WriteConstantInternal(raw_os, c, type_printer, impl.machine.get(), nullptr);
+			return;
+		}
+
+		BOOST_ASSERT_MSG(isa<Argument>(this), "Unknown value to print out!");
+		this->PrintAsOperand(os, true, mst);
+	}
+
+	void Value::PrintAsOperand(std::ostream& os, bool print_type, LLVMModule const * mod) const
+	{
+		if (!mod)
+		{
+			mod = GetModuleFromVal(this);
+		}
+		ModuleSlotTracker mst(mod, isa<MetadataAsValue>(this));
+		this->PrintAsOperand(os, print_type, mst);
+	}
+
+	void Value::PrintAsOperand(std::ostream& os, bool print_type, ModuleSlotTracker& mst) const
+	{
+		RawOStream raw_os(os);
+
+		auto& impl = mst.Impl();
+
+		// Fast path: Don't incorporate the types if we won't be needing any types printed.
+		if (!print_type && ((!isa<Constant>(this) && !isa<MetadataAsValue>(this)) || this->HasName() || isa<GlobalValue>(this)))
+		{
+			WriteAsOperandInternal(raw_os, this, nullptr, nullptr, impl.module);
+			return;
+		}
+
+		auto& type_printer = impl.TypePrinter();
+		if (print_type)
+		{
+			type_printer.Print(this->GetType(), raw_os);
+			raw_os << ' ';
+		}
+		WriteAsOperandInternal(raw_os, this, &type_printer, impl.machine.get(), impl.module);
+	}
+
+	void LLVMModule::Print(std::ostream& os, AssemblyAnnotationWriter* aaw, uint32_t num_threads) const
+	{
+		RawOStream raw_os(os);
+		this->Print(raw_os, aaw, num_threads);
+	}
+
+	void LLVMModule::Print(RawOStream& os, AssemblyAnnotationWriter* aaw, uint32_t num_threads) const
+	{
+		if (num_threads == 0)
+		{
+			num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+		}
+
 		SlotTracker slot_table(this);
 		AssemblyWriter w(os, slot_table, this, aaw);
-		w.PrintModule(this);
+		w.PrintModule(this, num_threads);
 	}
 }
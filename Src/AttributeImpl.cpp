@@ -280,135 +280,169 @@ namespace Dilithium
 	}
 
 
-	AttributeSetNode::AttributeSetNode(ArrayRef<Attribute> attrs)
-		: attrs_(attrs.ToVector())
+	static_assert(Attribute::AK_EndAttrKinds <= 64, "Attribute kinds don't fit in the kind mask");
+
+	AttributeSetNode::PackedAttributes::PackedAttributes()
+		: kind_mask(0), alignment(0), stack_alignment(0), deref_bytes(0), deref_or_null_bytes(0)
 	{
 	}
 
-	AttributeSetNode* AttributeSetNode::Get(LLVMContext& context, ArrayRef<Attribute> attrs)
+	void AttributeSetNode::PackedAttributes::Add(Attribute attr)
 	{
-		if (attrs.empty())
-		{
-			return nullptr;
-		}
-		else
-		{
-			auto& context_impl = context.Impl();
-
-			boost::container::small_vector<Attribute, 8> SortedAttrs(attrs.begin(), attrs.end());
-			std::sort(SortedAttrs.begin(), SortedAttrs.end());
-
-			size_t hash_val = 0;
-			for (auto iter = SortedAttrs.begin(), end_iter = SortedAttrs.end(); iter != end_iter; ++iter)
-			{
-				boost::hash_combine(hash_val, iter->RawPointer());
-			}
+		BOOST_ASSERT(!attr.IsStringAttribute());
 
-			auto iter = context_impl.attrs_set_nodes.find(hash_val);
-			if (iter == context_impl.attrs_set_nodes.end())
+		Attribute::AttrKind const kind = attr.KindAsEnum();
+		kind_mask |= KindBit(kind);
+		if (attr.IsIntAttribute())
+		{
+			uint64_t* val;
+			switch (kind)
 			{
-				auto pa = std::make_unique<AttributeSetNode>(SortedAttrs);
-				iter = context_impl.attrs_set_nodes.emplace(hash_val, std::move(pa)).first;
+			case Attribute::AK_Alignment:
+				val = &alignment;
+				break;
+			case Attribute::AK_StackAlignment:
+				val = &stack_alignment;
+				break;
+			case Attribute::AK_Dereferenceable:
+				val = &deref_bytes;
+				break;
+			case Attribute::AK_DereferenceableOrNull:
+				val = &deref_or_null_bytes;
+				break;
+
+			default:
+				DILITHIUM_UNREACHABLE("Wrong kind for int attribute!");
 			}
 
-			return iter->second.get();
+			BOOST_ASSERT_MSG(!*val || (*val == attr.ValueAsInt()), "Conflicting values of an int attribute");
+			*val = attr.ValueAsInt();
 		}
 	}
 
-	bool AttributeSetNode::HasAttribute(Attribute::AttrKind kind) const
+	size_t AttributeSetNode::PackedAttributes::Hash() const
 	{
-		for (auto const & attr : *this)
-		{
-			if (attr.HasAttribute(kind))
-			{
-				return true;
-			}
-		}
-		return false;
+		size_t hash_val = 0;
+		boost::hash_combine(hash_val, kind_mask);
+		boost::hash_combine(hash_val, alignment);
+		boost::hash_combine(hash_val, stack_alignment);
+		boost::hash_combine(hash_val, deref_bytes);
+		boost::hash_combine(hash_val, deref_or_null_bytes);
+		return hash_val;
 	}
 
-	bool AttributeSetNode::HasAttribute(std::string_view kind) const
+	bool AttributeSetNode::PackedAttributes::operator==(PackedAttributes const & rhs) const
 	{
-		for (auto const & attr : *this)
-		{
-			if (attr.HasAttribute(kind))
-			{
-				return true;
-			}
-		}
-		return false;
+		return (kind_mask == rhs.kind_mask) && (alignment == rhs.alignment) && (stack_alignment == rhs.stack_alignment)
+			&& (deref_bytes == rhs.deref_bytes) && (deref_or_null_bytes == rhs.deref_or_null_bytes);
 	}
 
-	Attribute AttributeSetNode::GetAttribute(Attribute::AttrKind kind) const
+
+	AttributeSetNode::AttributeSetNode(ArrayRef<Attribute> attrs)
+		: attrs_(attrs.begin(), attrs.end()), num_kind_attrs_(0)
 	{
-		for (auto const & attr : *this)
+		std::sort(attrs_.begin(), attrs_.end());
+		attrs_.erase(std::unique(attrs_.begin(), attrs_.end()), attrs_.end());
+
+		for (auto const & attr : attrs_)
 		{
-			if (attr.HasAttribute(kind))
+			if (attr.IsStringAttribute())
 			{
-				return attr;
+				break;
 			}
+
+			packed_.Add(attr);
+			++ num_kind_attrs_;
 		}
-		return Attribute();
 	}
 
-	Attribute AttributeSetNode::GetAttribute(std::string_view kind) const
+	AttributeSetNode* AttributeSetNode::Get(LLVMContext& context, ArrayRef<Attribute> attrs)
 	{
-		for (auto const & attr : *this)
+		if (attrs.empty())
+		{
+			return nullptr;
+		}
+		else
 		{
-			if (attr.HasAttribute(kind))
+			auto& context_impl = context.Impl();
+
+			// Only the string attributes need to be sorted, the others are keyed by the packed mask and values
+			PackedAttributes packed;
+			boost::container::small_vector<Attribute, 4> string_attrs;
+			for (auto const & attr : attrs)
+			{
+				if (attr.IsStringAttribute())
+				{
+					string_attrs.push_back(attr);
+				}
+				else
+				{
+					packed.Add(attr);
+				}
+			}
+			if (string_attrs.size() > 1)
 			{
-				return attr;
+				std::sort(string_attrs.begin(), string_attrs.end());
+				string_attrs.erase(std::unique(string_attrs.begin(), string_attrs.end()), string_attrs.end());
 			}
-		}
-		return Attribute();
-	}
 
-	uint32_t AttributeSetNode::Alignment() const
-	{
-		for (auto const & attr : *this)
-		{
-			if (attr.HasAttribute(Attribute::AK_Alignment))
+			size_t hash_val = packed.Hash();
+			for (auto const & attr : string_attrs)
 			{
-				return attr.Alignment();
+				boost::hash_combine(hash_val, attr.RawPointer());
 			}
+
+			ArrayRef<Attribute> sorted_string_attrs(string_attrs);
+			return context_impl.attrs_set_nodes.FindOrInsert(context_impl.concurrent_uniquing, hash_val,
+				[&packed, sorted_string_attrs](AttributeSetNode const * node)
+				{
+					return (node->packed_ == packed)
+						&& std::equal(node->StringBegin(), node->end(), sorted_string_attrs.begin(), sorted_string_attrs.end());
+				},
+				[attrs]()
+				{
+					return new AttributeSetNode(attrs);
+				});
 		}
-		return 0;
 	}
 
-	uint32_t AttributeSetNode::StackAlignment() const
+	bool AttributeSetNode::HasAttribute(std::string_view kind) const
 	{
-		for (auto const & attr : *this)
+		for (auto iter = this->StringBegin(), end_iter = this->end(); iter != end_iter; ++ iter)
 		{
-			if (attr.HasAttribute(Attribute::AK_StackAlignment))
+			if (iter->HasAttribute(kind))
 			{
-				return attr.StackAlignment();
+				return true;
 			}
 		}
-		return 0;
+		return false;
 	}
 
-	uint64_t AttributeSetNode::DereferenceableBytes() const
+	Attribute AttributeSetNode::GetAttribute(Attribute::AttrKind kind) const
 	{
-		for (auto const & attr : *this)
+		if (this->HasAttribute(kind))
 		{
-			if (attr.HasAttribute(Attribute::AK_Dereferenceable))
+			for (auto iter = this->begin(), end_iter = this->StringBegin(); iter != end_iter; ++ iter)
 			{
-				return attr.DereferenceableBytes();
+				if (iter->HasAttribute(kind))
+				{
+					return *iter;
+				}
 			}
 		}
-		return 0;
+		return Attribute();
 	}
 
-	uint64_t AttributeSetNode::DereferenceableOrNullBytes() const
+	Attribute AttributeSetNode::GetAttribute(std::string_view kind) const
 	{
-		for (auto const & attr : *this)
+		for (auto iter = this->StringBegin(), end_iter = this->end(); iter != end_iter; ++ iter)
 		{
-			if (attr.HasAttribute(Attribute::AK_DereferenceableOrNull))
+			if (iter->HasAttribute(kind))
 			{
-				return attr.DereferenceableOrNullBytes();
+				return *iter;
 			}
 		}
-		return 0;
+		return Attribute();
 	}
 
 	std::string AttributeSetNode::GetAsString(bool in_attr_grp) const
@@ -150,7 +150,10 @@ namespace Dilithium
 
 		static AttributeSetNode* Get(LLVMContext& context, ArrayRef<Attribute> attrs);
 
-		bool HasAttribute(Attribute::AttrKind kind) const;
+		bool HasAttribute(Attribute::AttrKind kind) const
+		{
+			return (packed_.kind_mask & KindBit(kind)) != 0;
+		}
 		bool HasAttribute(std::string_view kind) const;
 		bool HasAttributes() const
 		{
@@ -160,10 +163,22 @@ namespace Dilithium
 		Attribute GetAttribute(Attribute::AttrKind kind) const;
 		Attribute GetAttribute(std::string_view kind) const;
 
-		uint32_t Alignment() const;
-		uint32_t StackAlignment() const;
-		uint64_t DereferenceableBytes() const;
-		uint64_t DereferenceableOrNullBytes() const;
+		uint32_t Alignment() const
+		{
+			return static_cast<uint32_t>(packed_.alignment);
+		}
+		uint32_t StackAlignment() const
+		{
+			return static_cast<uint32_t>(packed_.stack_alignment);
+		}
+		uint64_t DereferenceableBytes() const
+		{
+			return packed_.deref_bytes;
+		}
+		uint64_t DereferenceableOrNullBytes() const
+		{
+			return packed_.deref_or_null_bytes;
+		}
 		std::string GetAsString(bool in_attr_grp) const;
 
 		iterator begin() const
@@ -176,7 +191,39 @@ namespace Dilithium
 		}
 
 	private:
+		// Enum and int attributes as one bit per kind, plus the values of the int ones. String attributes aren't
+		// included.
+		struct PackedAttributes
+		{
+			uint64_t kind_mask;
+			uint64_t alignment;
+			uint64_t stack_alignment;
+			uint64_t deref_bytes;
+			uint64_t deref_or_null_bytes;
+
+			PackedAttributes();
+
+			void Add(Attribute attr);
+			size_t Hash() const;
+
+			bool operator==(PackedAttributes const & rhs) const;
+		};
+
+		static uint64_t KindBit(Attribute::AttrKind kind)
+		{
+			return 1ULL << kind;
+		}
+
+		iterator StringBegin() const
+		{
+			return attrs_.data() + num_kind_attrs_;
+		}
+
+	private:
+		// Sorted, so the string attributes are at the end
 		std::vector<Attribute> attrs_;
+		uint32_t num_kind_attrs_;
+		PackedAttributes packed_;
 	};
 
 	class AttributeSetImpl : boost::noncopyable
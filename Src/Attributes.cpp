@@ -61,22 +61,31 @@ namespace Dilithium
 			boost::hash_combine(hash_val, val);
 		}
 
-		auto iter = context_impl.attrs_set.find(hash_val);
-		if (iter == context_impl.attrs_set.end())
-		{
-			std::unique_ptr<AttributeImpl> pa;
-			if (!val)
+		auto pa = context_impl.attrs_set.FindOrInsert(context_impl.concurrent_uniquing, hash_val,
+			[kind, val](AttributeImpl const * attr)
 			{
-				pa = std::make_unique<EnumAttributeImpl>(kind);
-			}
-			else
+				if (val)
+				{
+					return attr->IsIntAttribute() && (attr->KindAsEnum() == kind) && (attr->ValueAsInt() == val);
+				}
+				else
+				{
+					return attr->IsEnumAttribute() && (attr->KindAsEnum() == kind);
+				}
+			},
+			[kind, val]() -> AttributeImpl*
 			{
-				pa = std::make_unique<IntAttributeImpl>(kind, val);
-			}
-			iter = context_impl.attrs_set.emplace(hash_val, std::move(pa)).first;
-		}
+				if (!val)
+				{
+					return new EnumAttributeImpl(kind);
+				}
+				else
+				{
+					return new IntAttributeImpl(kind, val);
+				}
+			});
 
-		return Attribute(iter->second.get());
+		return Attribute(pa);
 	}
 
 	Attribute Attribute::Get(LLVMContext& context, std::string_view kind, std::string_view val)
@@ -135,48 +144,77 @@ namespace Dilithium
 
 	bool Attribute::HasAttribute(std::string_view val) const
 	{
-		DILITHIUM_UNUSED(val);
-		DILITHIUM_NOT_IMPLEMENTED;
+		if (!this->IsStringAttribute())
+		{
+			return false;
+		}
+		return impl_ && impl_->HasAttribute(val);
 	}
 
 	Attribute::AttrKind Attribute::KindAsEnum() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		if (!impl_)
+		{
+			return AK_None;
+		}
+		BOOST_ASSERT_MSG(this->IsEnumAttribute() || this->IsIntAttribute(), "Invalid attribute type to get the kind as an enum!");
+		return impl_->KindAsEnum();
 	}
 
 	uint64_t Attribute::ValueAsInt() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		if (!impl_)
+		{
+			return 0;
+		}
+		BOOST_ASSERT_MSG(this->IsIntAttribute(), "Expected the attribute to be an integer attribute!");
+		return impl_->ValueAsInt();
 	}
 
 	std::string_view Attribute::KindAsString() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		if (!impl_)
+		{
+			return std::string_view();
+		}
+		BOOST_ASSERT_MSG(this->IsStringAttribute(), "Invalid attribute type to get the kind as a string!");
+		return impl_->KindAsString();
 	}
 
 	std::string_view Attribute::ValueAsString() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		if (!impl_)
+		{
+			return std::string_view();
+		}
+		BOOST_ASSERT_MSG(this->IsStringAttribute(), "Invalid attribute type to get the value as a string!");
+		return impl_->ValueAsString();
 	}
 
 	uint32_t Attribute::Alignment() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		BOOST_ASSERT_MSG(this->HasAttribute(Attribute::AK_Alignment), "Trying to get alignment from non-alignment attribute!");
+		return static_cast<uint32_t>(impl_->ValueAsInt());
 	}
 
 	uint32_t Attribute::StackAlignment() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		BOOST_ASSERT_MSG(this->HasAttribute(Attribute::AK_StackAlignment), "Trying to get alignment from non-alignment attribute!");
+		return static_cast<uint32_t>(impl_->ValueAsInt());
 	}
 
 	uint64_t Attribute::DereferenceableBytes() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		BOOST_ASSERT_MSG(this->HasAttribute(Attribute::AK_Dereferenceable),
+			"Trying to get dereferenceable bytes from non-dereferenceable attribute!");
+		return impl_->ValueAsInt();
 	}
 
 	uint64_t Attribute::DereferenceableOrNullBytes() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		BOOST_ASSERT_MSG(this->HasAttribute(Attribute::AK_DereferenceableOrNull),
+			"Trying to get dereferenceable bytes from non-dereferenceable attribute!");
+		return impl_->ValueAsInt();
 	}
 
 	std::string Attribute::GetAsString(bool in_attr_grp) const
@@ -621,14 +659,28 @@ namespace Dilithium
 			boost::hash_combine(hash_val, iter->second);
 		}
 
-		auto iter = context_impl.attrs_lists.find(hash_val);
-		if (iter == context_impl.attrs_lists.end())
-		{
-			auto pa = std::make_unique<AttributeSetImpl>(context, attrs);
-			iter = context_impl.attrs_lists.emplace(hash_val, std::move(pa)).first;
-		}
+		auto pa = context_impl.attrs_lists.FindOrInsert(context_impl.concurrent_uniquing, hash_val,
+			[attrs](AttributeSetImpl const * impl)
+			{
+				if (impl->NumAttributes() != attrs.size())
+				{
+					return false;
+				}
+				for (uint32_t i = 0; i < impl->NumAttributes(); ++ i)
+				{
+					if ((impl->SlotIndex(i) != attrs[i].first) || (impl->SlotNode(i) != attrs[i].second))
+					{
+						return false;
+					}
+				}
+				return true;
+			},
+			[&context, attrs]()
+			{
+				return new AttributeSetImpl(context, attrs);
+			});
 
-		return AttributeSet(iter->second.get());
+		return AttributeSet(pa);
 	}
 
 	AttributeSet AttributeSet::GetFnAttributes() const
@@ -34,6 +34,8 @@
 
 #include <Dilithium/Dilithium.hpp>
 #include <Dilithium/BasicBlock.hpp>
+#include <Dilithium/Function.hpp>
+#include <Dilithium/InstrTypes.hpp>
 #include <Dilithium/Type.hpp>
 #include <Dilithium/SymbolTableList.hpp>
 #include <Dilithium/ValueSymbolTable.hpp>
@@ -41,7 +43,8 @@
 namespace Dilithium 
 {
 	BasicBlock::BasicBlock(LLVMContext& context, std::string_view name, Function* new_parent)
-		: Value(Type::LabelType(context), Value::BasicBlockVal), parent_(nullptr)
+		: Value(Type::LabelType(context), Value::BasicBlockVal), parent_(nullptr),
+			number_(new_parent->next_block_number_ ++)
 	{
 		new_parent->BasicBlockList().push_back(std::unique_ptr<BasicBlock>(this));
 		AddToSymbolTableList(this, new_parent);
@@ -74,6 +77,24 @@ namespace Dilithium
 		return new BasicBlock(context, name, parent);
 	}
 
+	TerminatorInst const * BasicBlock::GetTerminator() const
+	{
+		if (inst_list_.empty())
+		{
+			return nullptr;
+		}
+		return dyn_cast<TerminatorInst>(inst_list_.back().get());
+	}
+
+	TerminatorInst* BasicBlock::GetTerminator()
+	{
+		if (inst_list_.empty())
+		{
+			return nullptr;
+		}
+		return dyn_cast<TerminatorInst>(inst_list_.back().get());
+	}
+
 	ValueSymbolTable* BasicBlock::GetValueSymbolTable()
 	{
 		Function* func = this->Parent();
@@ -51,9 +51,10 @@
 #include <Dilithium/Metadata.hpp>
 #include <Dilithium/SmallString.hpp>
 #include <Dilithium/SymbolTableList.hpp>
-#include <Dilithium/TrackingMDRef.hpp>
 #include <Dilithium/Use.hpp>
 #include <Dilithium/ValueHandle.hpp>
+#include <Dilithium/dxc/HLSL/DxilOperations.hpp>
+#include "LLVMContextImpl.hpp"
 
 #include <deque>
 #include <map>
@@ -495,11 +496,6 @@ namespace
 	class BitcodeReaderMDValueList : boost::noncopyable
 	{
 	public:
-		BitcodeReaderMDValueList()
-			: num_fwd_refs_(0)
-		{
-		}
-
 		// vector compatibility methods
 		size_t size() const
 		{
@@ -511,7 +507,7 @@ namespace
 		}
 		void push_back(Metadata* md)
 		{
-			md_value_ptrs_.emplace_back(md);
+			md_value_ptrs_.push_back(md);
 		}
 		void clear()
 		{
@@ -523,7 +519,7 @@ namespace
 		}
 		Metadata* back() const
 		{
-			return md_value_ptrs_.back().Get();
+			return md_value_ptrs_.back();
 		}
 		void pop_back()
 		{
@@ -537,23 +533,18 @@ namespace
 		Metadata* operator[](uint32_t i) const
 		{
 			BOOST_ASSERT(i < md_value_ptrs_.size());
-			return md_value_ptrs_[i].Get();
+			return md_value_ptrs_[i];
 		}
 
-		Metadata* ValueFwdRef(uint32_t idx)
+		// Returns nullptr if the slot isn't assigned yet. Forward references inside a metadata block are patched by
+		// BitcodeReader::BuildPendingMetadata, so the list holds no placeholder nodes and doesn't track its entries.
+		Metadata* ValueFwdRef(uint32_t idx) const
 		{
 			if (idx >= this->size())
 			{
-				this->resize(idx + 1);
-			}
-
-			Metadata* md = md_value_ptrs_[idx].Get();
-			if (md)
-			{
-				return md;
+				return nullptr;
 			}
-
-			DILITHIUM_NOT_IMPLEMENTED;
+			return md_value_ptrs_[idx];
 		}
 		void AssignValue(Metadata* md, uint32_t idx)
 		{
@@ -568,22 +559,38 @@ namespace
 				this->resize(idx + 1);
 			}
 
-			auto& old_md = md_value_ptrs_[idx];
-			if (!old_md.Get())
-			{
-				old_md.Reset(md);
-				return;
-			}
-
-			// If there was a forward reference to this value, replace it.
-			TempMDTuple prev_md(cast<MDTuple>(old_md.Get()));
-			prev_md->ReplaceAllUsesWith(md);
-			-- num_fwd_refs_;
+			BOOST_ASSERT_MSG(!md_value_ptrs_[idx], "Metadata value number assigned twice");
+			md_value_ptrs_[idx] = md;
 		}
 
 	private:
-		uint32_t num_fwd_refs_;
-		std::vector<TrackingMDRef> md_value_ptrs_;
+		std::vector<Metadata*> md_value_ptrs_;
+	};
+
+	// A reference from operand op of the node in slot md_value_no to the node in slot target, recorded while the
+	// target is still being built.
+	struct MDFwdRef
+	{
+		uint32_t md_value_no;
+		uint32_t op;
+		uint32_t target;
+	};
+
+	// A node record of the metadata block being parsed. Operands are in the record encoding, 0 for null and
+	// the metadata value number + 1 otherwise.
+	struct PendingMDNode
+	{
+		uint32_t md_value_no;
+		uint32_t ops_begin;
+		uint32_t num_ops;
+		bool distinct;
+	};
+
+	struct PendingNamedMDNode
+	{
+		std::string name;
+		uint32_t ops_begin;
+		uint32_t num_ops;
 	};
 
 	class BitcodeReader : boost::noncopyable, public GVMaterializer
@@ -800,6 +807,12 @@ namespace
 			will_materialize_all_forward_refs_ = false;
 		}
 
+		StructType* CreateIdentifiedStructType(LLVMContext& context, std::string_view name)
+		{
+			auto ret = StructType::Create(context, name);
+			identified_struct_types_.push_back(ret);
+			return ret;
+		}
 		StructType* CreateIdentifiedStructType(LLVMContext& context)
 		{
 			auto ret = StructType::Create(context);
@@ -833,7 +846,12 @@ namespace
 		}
 		Metadata* FnMetadataByID(uint32_t id)
 		{
-			return md_value_list_.ValueFwdRef(id);
+			Metadata* md = md_value_list_.ValueFwdRef(id);
+			if (!md)
+			{
+				this->Error("Invalid record");
+			}
+			return md;
 		}
 		BasicBlock* GetBasicBlock(uint32_t id) const
 		{
@@ -1650,37 +1668,106 @@ namespace
 					continue;
 
 				case BitCode::TypeCode::StructNamed: // STRUCT: [ispacked, eltty x N]
-					if (record.size() < 1)
 					{
-						this->Error("Invalid record");
-						return;
-					}
+						if (record.size() < 1)
+						{
+							this->Error("Invalid record");
+							return;
+						}
 
-					if (num_records >= type_list_.size())
-					{
-						this->Error("Invalid TYPE table");
-						return;
-					}
+						if (num_records >= type_list_.size())
+						{
+							this->Error("Invalid TYPE table");
+							return;
+						}
 
-					// TODO
-					DILITHIUM_NOT_IMPLEMENTED;
+						// Check to see if this was forward referenced, if so fill in the temp.
+						StructType* res = cast_or_null<StructType>(type_list_[num_records]);
+						if (res)
+						{
+							res->Name(std::string_view(type_name.data(), type_name.size()));
+							type_list_[num_records] = nullptr;
+						}
+
+						boost::container::small_vector<Type*, 8> elt_tys;
+						for (uint32_t i = 1, e = static_cast<uint32_t>(record.size()); i != e; ++ i)
+						{
+							Type* t = this->TypeByID(static_cast<uint32_t>(record[i]));
+							if (t)
+							{
+								elt_tys.push_back(t);
+							}
+							else
+							{
+								break;
+							}
+						}
+						if (elt_tys.size() != record.size() - 1)
+						{
+							this->Error("Invalid record");
+							return;
+						}
+
+						if (!res)
+						{
+							// A self reference in the body leaves a placeholder behind
+							res = cast_or_null<StructType>(type_list_[num_records]);
+							if (res)
+							{
+								res->Name(std::string_view(type_name.data(), type_name.size()));
+								type_list_[num_records] = nullptr;
+							}
+							else
+							{
+								if (context_->HasDxilPrelude())
+								{
+									// Share the dx.types.* structs of the context instead of creating a renamed copy
+									result_ty = context_->GetDxilPrelude().FindStructType(std::string_view(type_name.data(), type_name.size()), elt_tys, record[0] != 0);
+								}
+								if (!result_ty)
+								{
+									res = this->CreateIdentifiedStructType(*context_, std::string_view(type_name.data(), type_name.size()));
+								}
+							}
+						}
+						type_name.clear();
+
+						if (res)
+						{
+							res->Body(elt_tys, record[0] != 0);
+							result_ty = res;
+						}
+					}
 					break;
 
 				case BitCode::TypeCode::Opaque: // OPAQUE: []
-					if (record.size() != 1)
 					{
-						this->Error("Invalid record");
-						return;
-					}
+						if (record.size() != 1)
+						{
+							this->Error("Invalid record");
+							return;
+						}
 
-					if (num_records >= type_list_.size())
-					{
-						this->Error("Invalid TYPE table");
-						return;
-					}
+						if (num_records >= type_list_.size())
+						{
+							this->Error("Invalid TYPE table");
+							return;
+						}
 
-					// TODO
-					DILITHIUM_NOT_IMPLEMENTED;
+						// Check to see if this was forward referenced, if so fill in the temp.
+						StructType* res = cast_or_null<StructType>(type_list_[num_records]);
+						if (res)
+						{
+							res->Name(std::string_view(type_name.data(), type_name.size()));
+							type_list_[num_records] = nullptr;
+						}
+						else
+						{
+							res = this->CreateIdentifiedStructType(*context_, std::string_view(type_name.data(), type_name.size()));
+						}
+						type_name.clear();
+						result_ty = res;
+					}
 					break;
 
 				case BitCode::TypeCode::Array: // ARRAY: [numelts, eltty]
@@ -1893,8 +1980,47 @@ namespace
 					v = ConstantInt::Get(cur_ty, this->DecodeSignRotatedValue(record[0]));
 					break;
 		
-				case BitCode::ConstantsCode::WideInteger:	// WIDE_INTEGER: [n x intval]
 				case BitCode::ConstantsCode::Float:			// FLOAT: [fpval]
+					if (record.empty())
+					{
+						this->Error("Invalid record");
+						return;
+					}
+					if (cur_ty->IsHalfType())
+					{
+						v = ConstantFP::Get(*context_, MPFloat(MPFloat::IEEEHalf, MPInt(16, static_cast<uint16_t>(record[0]))));
+					}
+					else if (cur_ty->IsFloatType())
+					{
+						v = ConstantFP::Get(*context_, MPFloat(MPFloat::IEEESingle, MPInt(32, static_cast<uint32_t>(record[0]))));
+					}
+					else if (cur_ty->IsDoubleType())
+					{
+						v = ConstantFP::Get(*context_, MPFloat(MPFloat::IEEEDouble, MPInt(64, record[0])));
+					}
+					else
+					{
+						v = UndefValue::Get(cur_ty);
+					}
+					break;
+
+				case BitCode::ConstantsCode::WideInteger:	// WIDE_INTEGER: [n x intval]
+					{
+						if (!cur_ty->IsIntegerType() || record.empty())
+						{
+							this->Error("Invalid record");
+							return;
+						}
+
+						boost::container::small_vector<uint64_t, 4> words;
+						for (auto word : record)
+						{
+							words.push_back(this->DecodeSignRotatedValue(word));
+						}
+						v = ConstantInt::Get(*context_, MPInt(cur_ty->IntegerBitWidth(), words));
+					}
+					break;
+
 				case BitCode::ConstantsCode::Aggregate:		// AGGREGATE: [n x value number]
 				case BitCode::ConstantsCode::String:		// STRING: [values]
 				case BitCode::ConstantsCode::CString:		// CSTRING: [values]
@@ -2388,6 +2514,13 @@ namespace
 			}
 
 			boost::container::small_vector<uint64_t, 64> record;
+			SmallString<64> md_string_buf;
+
+			// Nodes and named nodes are collected and built once the whole block is read
+			uint32_t const first_md_value_no = next_md_value_no;
+			std::vector<PendingMDNode> pending_nodes;
+			std::vector<PendingNamedMDNode> pending_named_nodes;
+			std::vector<uint64_t> pending_ops;
 
 			for (;;)
 			{
@@ -2401,6 +2534,7 @@ namespace
 					break;
 
 				case BitStreamEntry::EndBlock:
+					this->BuildPendingMetadata(first_md_value_no, pending_nodes, pending_named_nodes, pending_ops);
 					return;
 
 				case BitStreamEntry::Record:
@@ -2426,18 +2560,12 @@ namespace
 							return;
 						}
 
-						uint32_t size = static_cast<uint32_t>(record.size());
-						NamedMDNode* nmd = the_module_->GetOrInsertNamedMetadata(name);
-						for (uint32_t i = 0; i != size; ++ i)
-						{
-							MDNode* md = dyn_cast_or_null<MDNode>(md_value_list_.ValueFwdRef(static_cast<uint32_t>(record[i])));
-							if (!md)
-							{
-								this->Error("Invalid record");
-								return;
-							}
-							nmd->AddOperand(md);
-						}
+						PendingNamedMDNode nmd;
+						nmd.name.assign(name.begin(), name.end());
+						nmd.ops_begin = static_cast<uint32_t>(pending_ops.size());
+						nmd.num_ops = static_cast<uint32_t>(record.size());
+						pending_ops.insert(pending_ops.end(), record.begin(), record.end());
+						pending_named_nodes.push_back(std::move(nmd));
 					}
 					break;
 
@@ -2479,14 +2607,13 @@ namespace
 					// fallthrough...
 				case BitCode::MetadataCode::Node:
 					{
-						boost::container::small_vector<Metadata*, 8> elts;
-						elts.reserve(record.size());
-						for (auto id : record)
-						{
-							elts.push_back(id ? md_value_list_.ValueFwdRef(static_cast<uint32_t>(id - 1)) : nullptr);
-						}
-						md_value_list_.AssignValue(distinct ? MDNode::GetDistinct(*context_, elts) : MDNode::Get(*context_, elts),
-							next_md_value_no);
+						PendingMDNode node;
+						node.md_value_no = next_md_value_no;
+						node.ops_begin = static_cast<uint32_t>(pending_ops.size());
+						node.num_ops = static_cast<uint32_t>(record.size());
+						node.distinct = distinct;
+						pending_ops.insert(pending_ops.end(), record.begin(), record.end());
+						pending_nodes.push_back(node);
 						++ next_md_value_no;
 					}
 					break;
@@ -2518,7 +2645,9 @@ namespace
 
 				case BitCode::MetadataCode::String:
 					{
-						std::string str(record.begin(), record.end());
+						// Narrowed into a reused buffer, MDString::Get makes the only copy
+						md_string_buf.assign(record.begin(), record.end());
+						std::string_view str(md_string_buf.data(), md_string_buf.size());
 						// TODO: LLVM upgrades the MDStringConstant here. But it doesn't seems we need it for DXIL.
 						BOOST_ASSERT(str != "llvm.vectorizer.unroll");
 						BOOST_ASSERT(str.find("llvm.vectorizer.") != 0);
@@ -2552,10 +2681,190 @@ namespace
 				}
 			}
 		}
-		void ParseMetadataAttachment(Function& func)
+		// Creates the collected nodes of a metadata block. Distinct nodes are created empty first, their identity
+		// doesn't depend on the operands. Uniqued nodes are then built depth-first, operands before users, so each is
+		// hashed once with its final operands and forward references inside the block need no temporary node or RAUW.
+		// A cycle through uniqued nodes alone leaves one reference unresolved. It's recorded in a flat list, the node
+		// holding it is created distinct, and after the walk all of them are patched in one pass and the nodes are
+		// uniqued again.
+		void BuildPendingMetadata(uint32_t first_md_value_no, std::vector<PendingMDNode> const & nodes,
+			std::vector<PendingNamedMDNode> const & named_nodes, std::vector<uint64_t> const & ops)
 		{
-			DILITHIUM_UNUSED(func);
+			std::vector<uint32_t> node_index;
+			uint32_t num_uniqued = 0;
+			for (uint32_t i = 0; i < nodes.size(); ++ i)
+			{
+				uint32_t const slot = nodes[i].md_value_no - first_md_value_no;
+				if (slot >= node_index.size())
+				{
+					node_index.resize(slot + 1, UINT32_MAX);
+				}
+				node_index[slot] = i;
+				if (!nodes[i].distinct)
+				{
+					++ num_uniqued;
+				}
+			}
+			auto pending_node = [first_md_value_no, &node_index](uint64_t md_value_no)
+			{
+				if ((md_value_no < first_md_value_no) || (md_value_no - first_md_value_no >= node_index.size()))
+				{
+					return UINT32_MAX;
+				}
+				return node_index[static_cast<size_t>(md_value_no - first_md_value_no)];
+			};
+
+			auto& impl = context_->Impl();
+			impl.MDTuples.Reserve(impl.concurrent_uniquing, num_uniqued);
+
+			boost::container::small_vector<Metadata*, 8> elts;
+			for (auto const & node : nodes)
+			{
+				if (node.distinct)
+				{
+					elts.assign(node.num_ops, nullptr);
+					md_value_list_.AssignValue(MDNode::GetDistinct(*context_, elts), node.md_value_no);
+				}
+			}
+
+			enum : uint8_t
+			{
+				NotBuilt,
+				InProgress,
+				Built
+			};
+			std::vector<uint8_t> states(nodes.size(), NotBuilt);
+			std::vector<MDFwdRef> fwd_refs;
+			std::vector<MDNode*> cyclic_nodes;
+			// Node index and the next operand to visit
+			std::vector<std::pair<uint32_t, uint32_t>> stack;
+			for (uint32_t root = 0; root < nodes.size(); ++ root)
+			{
+				if (nodes[root].distinct || (states[root] != NotBuilt))
+				{
+					continue;
+				}
+
+				states[root] = InProgress;
+				stack.emplace_back(root, 0);
+				while (!stack.empty())
+				{
+					uint32_t const curr = stack.back().first;
+					auto const & node = nodes[curr];
+
+					uint32_t dep = UINT32_MAX;
+					for (uint32_t& next_op = stack.back().second; next_op < node.num_ops;)
+					{
+						uint64_t const id = ops[node.ops_begin + next_op];
+						++ next_op;
+						if (id)
+						{
+							uint32_t const op_node = pending_node(id - 1);
+							if ((op_node != UINT32_MAX) && !nodes[op_node].distinct && (states[op_node] == NotBuilt))
+							{
+								dep = op_node;
+								break;
+							}
+						}
+					}
+
+					if (dep != UINT32_MAX)
+					{
+						states[dep] = InProgress;
+						stack.emplace_back(dep, 0);
+					}
+					else
+					{
+						bool has_fwd_ref = false;
+						elts.clear();
+						for (uint32_t i = 0; i < node.num_ops; ++ i)
+						{
+							uint64_t const id = ops[node.ops_begin + i];
+							Metadata* md = nullptr;
+							if (id)
+							{
+								md = md_value_list_.ValueFwdRef(static_cast<uint32_t>(id - 1));
+								if (!md)
+								{
+									uint32_t const op_node = pending_node(id - 1);
+									if ((op_node == UINT32_MAX) || (states[op_node] != InProgress))
+									{
+										this->Error("Invalid record");
+										return;
+									}
+
+									fwd_refs.push_back({ node.md_value_no, i, static_cast<uint32_t>(id - 1) });
+									has_fwd_ref = true;
+								}
+							}
+							elts.push_back(md);
+						}
+						if (has_fwd_ref)
+						{
+							MDNode* md = MDNode::GetDistinct(*context_, elts);
+							cyclic_nodes.push_back(md);
+							md_value_list_.AssignValue(md, node.md_value_no);
+						}
+						else
+						{
+							md_value_list_.AssignValue(MDNode::Get(*context_, elts), node.md_value_no);
+						}
+						states[curr] = Built;
+						stack.pop_back();
+					}
+				}
+			}
+
+			for (auto const & ref : fwd_refs)
+			{
+				cast<MDNode>(md_value_list_[ref.md_value_no])->ReplaceOperandWith(ref.op, md_value_list_[ref.target]);
+			}
+			for (auto md : cyclic_nodes)
+			{
+				md->UniquifyDistinct();
+			}
+
+			for (auto const & node : nodes)
+			{
+				if (node.distinct)
+				{
+					MDNode* md = cast<MDNode>(md_value_list_[node.md_value_no]);
+					for (uint32_t i = 0; i < node.num_ops; ++ i)
+					{
+						uint64_t const id = ops[node.ops_begin + i];
+						if (id)
+						{
+							Metadata* op = md_value_list_.ValueFwdRef(static_cast<uint32_t>(id - 1));
+							if (!op)
+							{
+								this->Error("Invalid record");
+								return;
+							}
+							md->ReplaceOperandWith(i, op);
+						}
+					}
+				}
+			}
+
+			for (auto const & named_node : named_nodes)
+			{
+				NamedMDNode* nmd = the_module_->GetOrInsertNamedMetadata(named_node.name);
+				for (uint32_t i = 0; i < named_node.num_ops; ++ i)
+				{
+					MDNode* md = dyn_cast_or_null<MDNode>(
+						md_value_list_.ValueFwdRef(static_cast<uint32_t>(ops[named_node.ops_begin + i])));
+					if (!md)
+					{
+						this->Error("Invalid record");
+						return;
+					}
+					nmd->AddOperand(md);
+				}
+			}
+		}
 
+		void ParseMetadataAttachment(Function& func)
+		{
 			if (stream_cursor_.EnterSubBlock(BitCode::BlockId::MetadataAttachment))
 			{
 				this->Error("Invalid record");
@@ -2586,7 +2895,65 @@ namespace
 				switch (stream_cursor_.ReadRecord(entry.id, record))
 				{
 				case BitCode::MetadataCode::Attachment:
-					DILITHIUM_NOT_IMPLEMENTED;
+					{
+						uint32_t record_len = static_cast<uint32_t>(record.size());
+						if (record.empty())
+						{
+							this->Error("Invalid record");
+							return;
+						}
+
+						if (record_len % 2 == 0)
+						{
+							// A function attachment.
+							for (uint32_t i = 0; i != record_len; i += 2)
+							{
+								auto kind = md_kind_map_.find(static_cast<uint32_t>(record[i]));
+								if (kind == md_kind_map_.end())
+								{
+									this->Error("Invalid ID");
+									return;
+								}
+								auto md = dyn_cast_or_null<MDNode>(md_value_list_.ValueFwdRef(static_cast<uint32_t>(record[i + 1])));
+								if (!md)
+								{
+									this->Error("Invalid record");
+									return;
+								}
+								func.SetMetadata(kind->second, md);
+							}
+							break;
+						}
+
+						// An instruction attachment.
+						if (record[0] >= instruction_list_.size())
+						{
+							this->Error("Invalid ID");
+							return;
+						}
+						Instruction* inst = instruction_list_[static_cast<uint32_t>(record[0])];
+						for (uint32_t i = 1; i != record_len; i += 2)
+						{
+							auto kind = md_kind_map_.find(static_cast<uint32_t>(record[i]));
+							if (kind == md_kind_map_.end())
+							{
+								this->Error("Invalid ID");
+								return;
+							}
+							auto md = md_value_list_.ValueFwdRef(static_cast<uint32_t>(record[i + 1]));
+							if (!md)
+							{
+								this->Error("Invalid record");
+								return;
+							}
+							if (isa<LocalAsMetadata>(md))
+							{
+								// Drop the attachment. This used to be legal, but there's no upgrade path.
+								break;
+							}
+							inst->SetMetadata(kind->second, cast<MDNode>(md));
+						}
+					}
 					break;
 
 				default:
@@ -2767,7 +3134,12 @@ namespace Dilithium
 {
 	std::unique_ptr<LLVMModule> LoadLLVMModule(uint8_t const * data, uint32_t data_length, std::string const & name)
 	{
-		auto context = std::make_shared<LLVMContext>();
+		return LoadLLVMModule(data, data_length, name, std::make_shared<LLVMContext>());
+	}
+
+	std::unique_ptr<LLVMModule> LoadLLVMModule(uint8_t const * data, uint32_t data_length, std::string const & name,
+		std::shared_ptr<LLVMContext> const & context)
+	{
 		auto reader = std::make_shared<BitcodeReader>(data, data_length, context);
 		auto mod = std::make_unique<LLVMModule>(name, context);
 		mod->Materializer(reader);
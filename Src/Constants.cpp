@@ -70,14 +70,32 @@ namespace Dilithium
 	ConstantInt* ConstantInt::Get(LLVMContext& context, MPInt const & v)
 	{
 		auto& impl = context.Impl();
-		auto& slot = impl.int_constants[v];
-		if (!slot)
+		auto slot = impl.SmallIntConstantSlot(v);
+		if (slot)
 		{
-			IntegerType* ity = IntegerType::Get(context, v.BitWidth());
-			slot = new ConstantInt(ity, v);
+			auto ci = slot->load(std::memory_order_acquire);
+			if (ci)
+			{
+				return ci;
+			}
 		}
-		BOOST_ASSERT(slot->GetType() == IntegerType::Get(context, v.BitWidth()));
-		return slot;
+
+		auto ci = impl.int_constants.FindOrInsert(impl.concurrent_uniquing, std::hash<MPInt>()(v),
+			[&v](ConstantInt const * c)
+			{
+				return std::equal_to<MPInt>()(c->GetValue(), v);
+			},
+			[&context, &v]()
+			{
+				IntegerType* ity = IntegerType::Get(context, v.BitWidth());
+				return new ConstantInt(ity, v);
+			});
+		BOOST_ASSERT(ci->GetType() == IntegerType::Get(context, v.BitWidth()));
+		if (slot)
+		{
+			slot->store(ci, std::memory_order_release);
+		}
+		return ci;
 	}
 
 	ConstantInt* ConstantInt::Get(IntegerType* ty, std::string_view str, uint8_t radix)
@@ -102,11 +120,40 @@ namespace Dilithium
 	}
 
 
+	ConstantFP::ConstantFP(Type* ty, MPFloat const & v)
+		: Constant(ty, ConstantFPVal, 0, 0),
+			val_(v)
+	{
+		BOOST_ASSERT_MSG(MPFloat::SizeInBits(v.Semantics()) == ty->PrimitiveSizeInBits(), "Invalid constant for type");
+	}
+
 	Constant* ConstantFP::Get(Type* ty, double v)
 	{
-		DILITHIUM_UNUSED(ty);
-		DILITHIUM_UNUSED(v);
-		DILITHIUM_NOT_IMPLEMENTED;
+		MPFloat fv(v);
+		Type* scalar_ty = ty->ScalarType();
+		if (scalar_ty->IsHalfType())
+		{
+			fv.Convert(MPFloat::IEEEHalf, nullptr);
+		}
+		else if (scalar_ty->IsFloatType())
+		{
+			fv.Convert(MPFloat::IEEESingle, nullptr);
+		}
+		else
+		{
+			BOOST_ASSERT_MSG(scalar_ty->IsDoubleType(), "Unsupported floating point type");
+		}
+		Constant* ret = ConstantFP::Get(ty->Context(), fv);
+
+		VectorType* vty = dyn_cast<VectorType>(ty);
+		if (vty)
+		{
+			return ConstantVector::GetSplat(vty->NumElements(), ret);
+		}
+		else
+		{
+			return ret;
+		}
 	}
 
 	Constant* ConstantFP::Get(Type* ty, std::string_view str)
@@ -118,9 +165,33 @@ namespace Dilithium
 
 	ConstantFP* ConstantFP::Get(LLVMContext& context, MPFloat const & v)
 	{
-		DILITHIUM_UNUSED(context);
-		DILITHIUM_UNUSED(v);
-		DILITHIUM_NOT_IMPLEMENTED;
+		// Uniqued by bits, so -0.0 and each NaN payload get their own constant
+		MPInt const bits = v.BitcastToMPInt();
+		auto& impl = context.Impl();
+		return impl.fp_constants.FindOrInsert(impl.concurrent_uniquing, std::hash<MPInt>()(bits),
+			[&v, &bits](ConstantFP const * c)
+			{
+				return (&c->GetValueMPF().Semantics() == &v.Semantics())
+					&& std::equal_to<MPInt>()(c->GetValueMPF().BitcastToMPInt(), bits);
+			},
+			[&context, &v]()
+			{
+				Type* ty;
+				if (&v.Semantics() == &MPFloat::IEEEHalf)
+				{
+					ty = Type::HalfType(context);
+				}
+				else if (&v.Semantics() == &MPFloat::IEEESingle)
+				{
+					ty = Type::FloatType(context);
+				}
+				else
+				{
+					BOOST_ASSERT_MSG(&v.Semantics() == &MPFloat::IEEEDouble, "Unknown FP format");
+					ty = Type::DoubleType(context);
+				}
+				return new ConstantFP(ty, v);
+			});
 	}
 
 
@@ -199,7 +270,9 @@ namespace Dilithium
 
 	UndefValue* UndefValue::Get(Type* ty)
 	{
-		auto& entry = ty->Context().Impl().uv_constants[ty];
+		auto& impl = ty->Context().Impl();
+		auto lock = impl.ConcurrentLock(impl.uv_constants_mutex);
+		auto& entry = impl.uv_constants[ty];
 		if (!entry)
 		{
 			entry = new UndefValue(ty);
@@ -328,12 +328,25 @@ namespace Dilithium
 
 	StructLayout const * DataLayout::GetStructLayout(StructType* ty) const
 	{
-		auto& sl = layout_map_[ty];
-		if (!sl)
 		{
-			sl = std::make_unique<StructLayout>(ty, *this);
+			std::lock_guard<std::mutex> lock(layout_map_mutex_);
+			auto iter = layout_map_.find(ty);
+			if (iter != layout_map_.end())
+			{
+				return iter->second.get();
+			}
+		}
+
+		// Built outside of the lock, since nested structs come back here. If another thread wins the race, its layout is kept.
+		auto sl = std::make_unique<StructLayout>(ty, *this);
+
+		std::lock_guard<std::mutex> lock(layout_map_mutex_);
+		auto& entry = layout_map_[ty];
+		if (!entry)
+		{
+			entry = std::move(sl);
 		}
-		return sl.get();
+		return entry.get();
 	}
 
 	DataLayout::PointersTy::iterator DataLayout::FindPointerLowerBound(uint32_t addr_space)
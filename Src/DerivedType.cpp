@@ -37,6 +37,8 @@
 #include <Dilithium/LLVMContext.hpp>
 #include "LLVMContextImpl.hpp"
 
+#include <algorithm>
+
 namespace Dilithium 
 {
 	IntegerType::IntegerType(LLVMContext& context, uint32_t num_bits)
@@ -70,7 +72,10 @@ namespace Dilithium
 			break;
 		}
 
-		auto& entry = context.Impl().integer_types[num_bits];
+		auto& impl = context.Impl();
+		auto lock = impl.ConcurrentLock(impl.integer_types_mutex);
+
+		auto& entry = impl.integer_types[num_bits];
 		if (!entry)
 		{
 			entry = std::make_unique<IntegerType>(context, num_bits);
@@ -104,14 +109,17 @@ namespace Dilithium
 		boost::hash_combine(hash_val, boost::hash_range(params.begin(), params.end()));
 		boost::hash_combine(hash_val, is_var_args);
 
-		auto iter = impl.function_types.find(hash_val);
-		if (iter == impl.function_types.end())
-		{
-			auto ft = std::make_unique<FunctionType>(return_type, params, is_var_args);
-			iter = impl.function_types.emplace(hash_val, std::move(ft)).first;
-		}
-
-		return iter->second.get();
+		return impl.function_types.FindOrInsert(impl.concurrent_uniquing, hash_val,
+			[return_type, params, is_var_args](FunctionType const * type)
+			{
+				return (type->ReturnType() == return_type) && (type->IsVarArg() == is_var_args)
+					&& (type->NumParams() == params.size())
+					&& std::equal(type->ParamBegin(), type->ParamEnd(), params.begin());
+			},
+			[return_type, params, is_var_args]()
+			{
+				return new FunctionType(return_type, params, is_var_args);
+			});
 	}
 
 	FunctionType* FunctionType::Get(Type* return_type, bool is_var_args)
@@ -167,45 +175,46 @@ namespace Dilithium
 
 	StructType* StructType::Create(LLVMContext& context, std::string_view name)
 	{
-		DILITHIUM_UNUSED(context);
-		DILITHIUM_UNUSED(name);
-		DILITHIUM_NOT_IMPLEMENTED;
+		auto& impl = context.Impl();
+		StructType* st;
+		{
+			auto lock = impl.ConcurrentLock(impl.struct_types_mutex);
+			impl.identified_struct_types.emplace_back(std::make_unique<StructType>(context));
+			st = impl.identified_struct_types.back().get();
+		}
+		if (!name.empty())
+		{
+			st->Name(name);
+		}
+		return st;
 	}
 
 	StructType* StructType::Create(LLVMContext& context)
 	{
-		DILITHIUM_UNUSED(context);
-		DILITHIUM_NOT_IMPLEMENTED;
+		return StructType::Create(context, "");
 	}
 
 	StructType* StructType::Create(ArrayRef<Type*> elements, std::string_view name, bool is_packed)
 	{
-		DILITHIUM_UNUSED(elements);
-		DILITHIUM_UNUSED(name);
-		DILITHIUM_UNUSED(is_packed);
-		DILITHIUM_NOT_IMPLEMENTED;
+		BOOST_ASSERT_MSG(!elements.empty(), "This method may not be invoked with an empty list");
+		return StructType::Create(elements[0]->Context(), elements, name, is_packed);
 	}
 
 	StructType* StructType::Create(ArrayRef<Type*> elements)
 	{
-		DILITHIUM_UNUSED(elements);
-		DILITHIUM_NOT_IMPLEMENTED;
+		return StructType::Create(elements, "");
 	}
 
 	StructType* StructType::Create(LLVMContext& context, ArrayRef<Type*> elements, std::string_view name, bool is_packed)
 	{
-		DILITHIUM_UNUSED(context);
-		DILITHIUM_UNUSED(elements);
-		DILITHIUM_UNUSED(name);
-		DILITHIUM_UNUSED(is_packed);
-		DILITHIUM_NOT_IMPLEMENTED;
+		StructType* st = StructType::Create(context, name);
+		st->Body(elements, is_packed);
+		return st;
 	}
 
 	StructType* StructType::Create(LLVMContext& context, ArrayRef<Type*> elements)
 	{
-		DILITHIUM_UNUSED(context);
-		DILITHIUM_UNUSED(elements);
-		DILITHIUM_NOT_IMPLEMENTED;
+		return StructType::Create(context, elements, "");
 	}
 
 	StructType* StructType::Create(std::string_view name, Type* type, ...)
@@ -217,17 +226,29 @@ namespace Dilithium
 
 	StructType* StructType::Get(LLVMContext& context, ArrayRef<Type*> elements, bool is_packed)
 	{
-		DILITHIUM_UNUSED(context);
-		DILITHIUM_UNUSED(elements);
-		DILITHIUM_UNUSED(is_packed);
-		DILITHIUM_NOT_IMPLEMENTED;
+		auto& impl = context.Impl();
+
+		uint64_t hash_val = boost::hash_range(elements.begin(), elements.end());
+		boost::hash_combine(hash_val, is_packed);
+
+		return impl.anon_struct_types.FindOrInsert(impl.concurrent_uniquing, hash_val,
+			[elements, is_packed](StructType const * type)
+			{
+				return (type->IsPacked() == is_packed)
+					&& std::equal(type->ElementBegin(), type->ElementEnd(), elements.begin(), elements.end());
+			},
+			[&context, elements, is_packed]()
+			{
+				auto st = new StructType(context);
+				st->SubclassData(SCDB_IsLiteral);
+				st->Body(elements, is_packed);
+				return st;
+			});
 	}
 
 	StructType* StructType::Get(LLVMContext& context, bool is_packed)
 	{
-		DILITHIUM_UNUSED(context);
-		DILITHIUM_UNUSED(is_packed);
-		DILITHIUM_NOT_IMPLEMENTED;
+		return StructType::Get(context, ArrayRef<Type*>(), is_packed);
 	}
 
 	StructType* StructType::Get(Type* type, ...)
@@ -238,25 +259,75 @@ namespace Dilithium
 
 	bool StructType::IsSized() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		if ((this->SubclassData() & SCDB_IsSized) != 0)
+		{
+			return true;
+		}
+		if (this->IsOpaque())
+		{
+			return false;
+		}
+
+		for (auto iter = this->ElementBegin(), end_iter = this->ElementEnd(); iter != end_iter; ++ iter)
+		{
+			if (!(*iter)->IsSized())
+			{
+				return false;
+			}
+		}
+
+		// Cache the answer, a struct can't go back to being unsized
+		const_cast<StructType*>(this)->SubclassData(this->SubclassData() | SCDB_IsSized);
+		return true;
 	}
 
 	std::string_view StructType::Name() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		return symbol_table_name_;
 	}
 
 	void StructType::Name(std::string_view name)
 	{
-		DILITHIUM_UNUSED(name);
-		DILITHIUM_NOT_IMPLEMENTED;
+		if (name == symbol_table_name_)
+		{
+			return;
+		}
+
+		auto& impl = this->Context().Impl();
+		auto lock = impl.ConcurrentLock(impl.struct_types_mutex);
+		if (this->HasName())
+		{
+			impl.named_struct_types.erase(symbol_table_name_);
+		}
+
+		if (name.empty())
+		{
+			symbol_table_name_.clear();
+			return;
+		}
+
+		// Append a unique suffix if the name is already taken
+		std::string unique_name(name);
+		while (!impl.named_struct_types.emplace(unique_name, this).second)
+		{
+			unique_name = std::string(name) + "." + std::to_string(impl.named_struct_types_unique_id);
+			++ impl.named_struct_types_unique_id;
+		}
+		symbol_table_name_ = std::move(unique_name);
 	}
 
 	void StructType::Body(ArrayRef<Type*> elements, bool is_packed)
 	{
-		DILITHIUM_UNUSED(elements);
-		DILITHIUM_UNUSED(is_packed);
-		DILITHIUM_NOT_IMPLEMENTED;
+		BOOST_ASSERT_MSG(this->IsOpaque(), "Struct body already set!");
+
+		uint32_t data = this->SubclassData() | SCDB_HasBody;
+		if (is_packed)
+		{
+			data |= SCDB_Packed;
+		}
+		this->SubclassData(data);
+
+		contained_types_.assign(elements.begin(), elements.end());
 	}
 
 	void StructType::Body(Type* type, ...)
@@ -267,14 +338,23 @@ namespace Dilithium
 
 	bool StructType::IsValidElementType(Type* elem_type)
 	{
-		DILITHIUM_UNUSED(elem_type);
-		DILITHIUM_NOT_IMPLEMENTED;
+		return !elem_type->IsVoidType() && !elem_type->IsLabelType() && !elem_type->IsMetadataType()
+			&& !elem_type->IsFunctionType();
 	}
 
 	bool StructType::IsLayoutIdentical(StructType* rhs) const
 	{
-		DILITHIUM_UNUSED(rhs);
-		DILITHIUM_NOT_IMPLEMENTED;
+		if (this == rhs)
+		{
+			return true;
+		}
+
+		if ((this->IsPacked() != rhs->IsPacked()) || this->IsOpaque() || rhs->IsOpaque())
+		{
+			return false;
+		}
+
+		return std::equal(this->ElementBegin(), this->ElementEnd(), rhs->ElementBegin(), rhs->ElementEnd());
 	}
 
 
@@ -293,15 +373,23 @@ namespace Dilithium
 
 	ArrayType* ArrayType::Get(Type* elem_type, uint64_t num_elements)
 	{
-		DILITHIUM_UNUSED(elem_type);
-		DILITHIUM_UNUSED(num_elements);
-		DILITHIUM_NOT_IMPLEMENTED;
+		BOOST_ASSERT_MSG(ArrayType::IsValidElementType(elem_type), "Invalid type for array element!");
+
+		auto& impl = elem_type->Context().Impl();
+		auto lock = impl.ConcurrentLock(impl.sequential_types_mutex);
+
+		auto& entry = impl.array_types[std::make_pair(elem_type, num_elements)];
+		if (!entry)
+		{
+			entry = std::make_unique<ArrayType>(elem_type, num_elements);
+		}
+		return entry.get();
 	}
 
 	bool ArrayType::IsValidElementType(Type* elem_type)
 	{
-		DILITHIUM_UNUSED(elem_type);
-		DILITHIUM_NOT_IMPLEMENTED;
+		return !elem_type->IsVoidType() && !elem_type->IsLabelType() && !elem_type->IsMetadataType()
+			&& !elem_type->IsFunctionType();
 	}
 
 
@@ -313,9 +401,19 @@ namespace Dilithium
 
 	VectorType* VectorType::Get(Type* elem_type, uint32_t num_elements)
 	{
-		DILITHIUM_UNUSED(elem_type);
-		DILITHIUM_UNUSED(num_elements);
-		DILITHIUM_NOT_IMPLEMENTED;
+		BOOST_ASSERT_MSG(num_elements > 0, "#Elements of a VectorType must be greater than 0");
+		BOOST_ASSERT_MSG(VectorType::IsValidElementType(elem_type), "Element type of a VectorType must be an integer, "
+			"floating point, or pointer type.");
+
+		auto& impl = elem_type->Context().Impl();
+		auto lock = impl.ConcurrentLock(impl.sequential_types_mutex);
+
+		auto& entry = impl.vector_types[std::make_pair(elem_type, num_elements)];
+		if (!entry)
+		{
+			entry = std::make_unique<VectorType>(elem_type, num_elements);
+		}
+		return entry.get();
 	}
 
 	VectorType* VectorType::Integer(VectorType* vec_type)
@@ -356,8 +454,7 @@ namespace Dilithium
 
 	bool VectorType::IsValidElementType(Type* elem_type)
 	{
-		DILITHIUM_UNUSED(elem_type);
-		DILITHIUM_NOT_IMPLEMENTED;
+		return elem_type->IsIntegerType() || elem_type->IsFloatingPointType() || elem_type->IsPointerType();
 	}
 
 
@@ -373,6 +470,7 @@ namespace Dilithium
 		BOOST_ASSERT_MSG(PointerType::IsValidElementType(elem_type), "Invalid type for pointer element!");
 
 		auto& impl = elem_type->Context().Impl();
+		auto lock = impl.ConcurrentLock(impl.sequential_types_mutex);
 
 		auto& entry = (address_space == 0) ? impl.pointer_types[elem_type]
 			: impl.as_pointer_types[std::make_pair(elem_type, address_space)];
@@ -0,0 +1,491 @@
+/**
+ * @file Dominators.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/Dominators.hpp>
+#include <Dilithium/CFG.hpp>
+
+#include <algorithm>
+
+namespace
+{
+	using namespace Dilithium;
+
+	uint32_t const INVALID_NUMBER = DominatorTreeBase::INVALID_NUMBER;
+
+	// Adjacency list in CSR form, the edges of node n are edges[offsets[n] .. offsets[n + 1])
+	struct DenseGraph
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> edges;
+
+		uint32_t const * EdgeBegin(uint32_t node) const
+		{
+			return edges.data() + offsets[node];
+		}
+		uint32_t const * EdgeEnd(uint32_t node) const
+		{
+			return edges.data() + offsets[node + 1];
+		}
+	};
+
+	DenseGraph Transpose(DenseGraph const & graph)
+	{
+		uint32_t const num_nodes = static_cast<uint32_t>(graph.offsets.size() - 1);
+
+		DenseGraph ret;
+		ret.offsets.assign(num_nodes + 1, 0);
+		for (auto to : graph.edges)
+		{
+			++ ret.offsets[to + 1];
+		}
+		for (uint32_t i = 0; i < num_nodes; ++ i)
+		{
+			ret.offsets[i + 1] += ret.offsets[i];
+		}
+
+		ret.edges.resize(graph.edges.size());
+		std::vector<uint32_t> fill(ret.offsets.begin(), ret.offsets.end() - 1);
+		for (uint32_t from = 0; from < num_nodes; ++ from)
+		{
+			for (auto iter = graph.EdgeBegin(from), end_iter = graph.EdgeEnd(from); iter != end_iter; ++ iter)
+			{
+				ret.edges[fill[*iter] ++] = from;
+			}
+		}
+		return ret;
+	}
+
+	class SemiNCA
+	{
+	public:
+		// Returns the immediate dominator of every node. The root dominates itself, unreachable nodes get INVALID_NUMBER.
+		std::vector<uint32_t> Run(uint32_t root, DenseGraph const & graph, DenseGraph const & rev_graph)
+		{
+			uint32_t const num_nodes = static_cast<uint32_t>(graph.offsets.size() - 1);
+
+			this->NumberNodes(root, graph, num_nodes);
+			uint32_t const num_reachable = static_cast<uint32_t>(vertex_.size());
+
+			semi_.resize(num_reachable);
+			label_.resize(num_reachable);
+			for (uint32_t i = 0; i < num_reachable; ++ i)
+			{
+				semi_[i] = i;
+				label_[i] = i;
+			}
+			ancestor_ = parent_;
+
+			// Semidominators, in reverse preorder
+			for (uint32_t i = num_reachable - 1; i >= 1; -- i)
+			{
+				uint32_t semi = parent_[i];
+				for (auto iter = rev_graph.EdgeBegin(vertex_[i]), end_iter = rev_graph.EdgeEnd(vertex_[i]);
+					iter != end_iter; ++ iter)
+				{
+					uint32_t const v = dfs_num_[*iter];
+					if (v != INVALID_NUMBER)
+					{
+						semi = std::min(semi, semi_[this->Eval(v, i + 1)]);
+					}
+				}
+				semi_[i] = semi;
+			}
+
+			// NCA step: the idom is the nearest ancestor in the DFS tree that isn't below the semidominator
+			std::vector<uint32_t> idom = parent_;
+			for (uint32_t i = 1; i < num_reachable; ++ i)
+			{
+				uint32_t candidate = idom[i];
+				while (candidate > semi_[i])
+				{
+					candidate = idom[candidate];
+				}
+				idom[i] = candidate;
+			}
+
+			std::vector<uint32_t> ret(num_nodes, INVALID_NUMBER);
+			for (uint32_t i = 0; i < num_reachable; ++ i)
+			{
+				ret[vertex_[i]] = vertex_[idom[i]];
+			}
+			return ret;
+		}
+
+	private:
+		void NumberNodes(uint32_t root, DenseGraph const & graph, uint32_t num_nodes)
+		{
+			dfs_num_.assign(num_nodes, INVALID_NUMBER);
+			vertex_.clear();
+			parent_.clear();
+
+			std::vector<std::pair<uint32_t, uint32_t const *>> stack;
+			dfs_num_[root] = 0;
+			vertex_.push_back(root);
+			parent_.push_back(0);
+			stack.emplace_back(root, graph.EdgeBegin(root));
+			while (!stack.empty())
+			{
+				uint32_t const node = stack.back().first;
+				auto& iter = stack.back().second;
+				if (iter == graph.EdgeEnd(node))
+				{
+					stack.pop_back();
+				}
+				else
+				{
+					uint32_t const succ = *iter;
+					++ iter;
+					if (dfs_num_[succ] == INVALID_NUMBER)
+					{
+						dfs_num_[succ] = static_cast<uint32_t>(vertex_.size());
+						vertex_.push_back(succ);
+						parent_.push_back(dfs_num_[node]);
+						stack.emplace_back(succ, graph.EdgeBegin(succ));
+					}
+				}
+			}
+		}
+
+		// Path-compressed evaluation over the nodes already linked to the forest (DFS numbers >= last_linked)
+		uint32_t Eval(uint32_t v, uint32_t last_linked)
+		{
+			if (ancestor_[v] < last_linked)
+			{
+				return label_[v];
+			}
+
+			eval_stack_.clear();
+			do
+			{
+				eval_stack_.push_back(v);
+				v = ancestor_[v];
+			} while (ancestor_[v] >= last_linked);
+
+			uint32_t p = v;
+			uint32_t p_label = label_[p];
+			do
+			{
+				v = eval_stack_.back();
+				eval_stack_.pop_back();
+
+				ancestor_[v] = ancestor_[p];
+				if (semi_[p_label] < semi_[label_[v]])
+				{
+					label_[v] = p_label;
+				}
+				else
+				{
+					p_label = label_[v];
+				}
+				p = v;
+			} while (!eval_stack_.empty());
+
+			return label_[v];
+		}
+
+	private:
+		// Indexed by node
+		std::vector<uint32_t> dfs_num_;
+
+		// Indexed by DFS number
+		std::vector<uint32_t> vertex_;
+		std::vector<uint32_t> parent_;
+		std::vector<uint32_t> ancestor_;
+		std::vector<uint32_t> semi_;
+		std::vector<uint32_t> label_;
+
+		std::vector<uint32_t> eval_stack_;
+	};
+}
+
+namespace Dilithium
+{
+	DominatorTreeBase::DominatorTreeBase(bool is_post_dom)
+		: is_post_dom_(is_post_dom), func_(nullptr)
+	{
+	}
+
+	void DominatorTreeBase::Recalculate(Function const & func)
+	{
+		this->Clear();
+		func_ = &func;
+		if (func.empty())
+		{
+			return;
+		}
+
+		// The post-dominator tree has one more node, the virtual exit, linked from every block without successors
+		uint32_t const num_blocks = func.MaxBlockNumber();
+		uint32_t const num_nodes = num_blocks + (is_post_dom_ ? 1 : 0);
+		uint32_t const virtual_exit = num_blocks;
+
+		blocks_.assign(num_blocks, nullptr);
+		DenseGraph cfg;
+		cfg.offsets.assign(num_nodes + 1, 0);
+		{
+			std::vector<std::pair<uint32_t, uint32_t>> edges;
+			for (auto const & bb : func)
+			{
+				uint32_t const from = bb->Number();
+				blocks_[from] = bb.get();
+
+				bool has_succ = false;
+				for (auto succ : successors(bb.get()))
+				{
+					edges.emplace_back(from, succ->Number());
+					has_succ = true;
+				}
+				if (is_post_dom_ && !has_succ)
+				{
+					edges.emplace_back(from, virtual_exit);
+				}
+			}
+
+			std::stable_sort(edges.begin(), edges.end(),
+				[](std::pair<uint32_t, uint32_t> const & lhs, std::pair<uint32_t, uint32_t> const & rhs)
+				{
+					return lhs.first < rhs.first;
+				});
+			cfg.edges.reserve(edges.size());
+			for (auto const & edge : edges)
+			{
+				++ cfg.offsets[edge.first + 1];
+				cfg.edges.push_back(edge.second);
+			}
+			for (uint32_t i = 0; i < num_nodes; ++ i)
+			{
+				cfg.offsets[i + 1] += cfg.offsets[i];
+			}
+		}
+		DenseGraph rev_cfg = Transpose(cfg);
+
+		uint32_t root;
+		std::vector<uint32_t> idom;
+		{
+			SemiNCA snca;
+			if (is_post_dom_)
+			{
+				root = virtual_exit;
+				idom = snca.Run(root, rev_cfg, cfg);
+			}
+			else
+			{
+				root = func.EntryBlock().Number();
+				idom = snca.Run(root, cfg, rev_cfg);
+			}
+		}
+
+		// Tree children in CSR form, and the DFS intervals for O(1) dominance queries
+		std::vector<uint32_t> child_offsets(num_nodes + 1, 0);
+		for (uint32_t i = 0; i < num_nodes; ++ i)
+		{
+			if ((i != root) && (idom[i] != INVALID_NUMBER))
+			{
+				++ child_offsets[idom[i] + 1];
+			}
+		}
+		for (uint32_t i = 0; i < num_nodes; ++ i)
+		{
+			child_offsets[i + 1] += child_offsets[i];
+		}
+		std::vector<uint32_t> children(child_offsets.back());
+		{
+			std::vector<uint32_t> fill(child_offsets.begin(), child_offsets.end() - 1);
+			for (uint32_t i = 0; i < num_nodes; ++ i)
+			{
+				if ((i != root) && (idom[i] != INVALID_NUMBER))
+				{
+					children[fill[idom[i]] ++] = i;
+				}
+			}
+		}
+
+		std::vector<uint32_t> dfs_in(num_nodes, INVALID_NUMBER);
+		std::vector<uint32_t> dfs_out(num_nodes, INVALID_NUMBER);
+		std::vector<uint32_t> level(num_nodes, 0);
+		{
+			uint32_t counter = 0;
+			std::vector<std::pair<uint32_t, uint32_t>> stack;
+			dfs_in[root] = counter ++;
+			stack.emplace_back(root, child_offsets[root]);
+			while (!stack.empty())
+			{
+				uint32_t const node = stack.back().first;
+				uint32_t& next = stack.back().second;
+				if (next == child_offsets[node + 1])
+				{
+					dfs_out[node] = counter ++;
+					stack.pop_back();
+				}
+				else
+				{
+					uint32_t const child = children[next];
+					++ next;
+					dfs_in[child] = counter ++;
+					level[child] = level[node] + 1;
+					stack.emplace_back(child, child_offsets[child]);
+				}
+			}
+		}
+
+		// Drop the virtual exit, its children are the roots of the post-dominator tree
+		if (is_post_dom_)
+		{
+			for (uint32_t i = child_offsets[virtual_exit]; i < child_offsets[virtual_exit + 1]; ++ i)
+			{
+				roots_.push_back(blocks_[children[i]]);
+				idom[children[i]] = INVALID_NUMBER;
+			}
+			for (uint32_t i = 0; i < num_blocks; ++ i)
+			{
+				if (dfs_in[i] != INVALID_NUMBER)
+				{
+					-- level[i];
+				}
+			}
+			children.resize(child_offsets[virtual_exit]);
+		}
+		else
+		{
+			roots_.push_back(blocks_[root]);
+		}
+		idom.resize(num_blocks);
+		idom[root] = INVALID_NUMBER;
+		level.resize(num_blocks);
+		dfs_in.resize(num_blocks);
+		dfs_out.resize(num_blocks);
+		child_offsets.resize(num_blocks + 1);
+
+		children_.resize(children.size());
+		for (size_t i = 0; i < children.size(); ++ i)
+		{
+			children_[i] = blocks_[children[i]];
+		}
+
+		idom_ = std::move(idom);
+		level_ = std::move(level);
+		dfs_in_ = std::move(dfs_in);
+		dfs_out_ = std::move(dfs_out);
+		child_offsets_ = std::move(child_offsets);
+	}
+
+	bool DominatorTreeBase::IsReachable(BasicBlock const * bb) const
+	{
+		BOOST_ASSERT_MSG((bb->Parent() == func_) && (bb->Number() < blocks_.size()), "Block is not in the tree");
+		return dfs_in_[bb->Number()] != INVALID_NUMBER;
+	}
+
+	BasicBlock const * DominatorTreeBase::IDom(BasicBlock const * bb) const
+	{
+		BOOST_ASSERT(bb->Parent() == func_);
+		uint32_t const idom = idom_[bb->Number()];
+		return (idom == INVALID_NUMBER) ? nullptr : blocks_[idom];
+	}
+
+	ArrayRef<BasicBlock const *> DominatorTreeBase::Children(BasicBlock const * bb) const
+	{
+		BOOST_ASSERT(bb->Parent() == func_);
+		uint32_t const n = bb->Number();
+		return ArrayRef<BasicBlock const *>(children_.data() + child_offsets_[n], children_.data() + child_offsets_[n + 1]);
+	}
+
+	uint32_t DominatorTreeBase::Level(BasicBlock const * bb) const
+	{
+		BOOST_ASSERT(bb->Parent() == func_);
+		return level_[bb->Number()];
+	}
+
+	bool DominatorTreeBase::Dominates(BasicBlock const * a, BasicBlock const * b) const
+	{
+		if (a == b)
+		{
+			return true;
+		}
+		if (!this->IsReachable(b))
+		{
+			return true;
+		}
+		if (!this->IsReachable(a))
+		{
+			return false;
+		}
+
+		uint32_t const na = a->Number();
+		uint32_t const nb = b->Number();
+		return (dfs_in_[na] <= dfs_in_[nb]) && (dfs_out_[nb] <= dfs_out_[na]);
+	}
+
+	bool DominatorTreeBase::ProperlyDominates(BasicBlock const * a, BasicBlock const * b) const
+	{
+		return (a != b) && this->Dominates(a, b);
+	}
+
+	BasicBlock const * DominatorTreeBase::FindNearestCommonDominator(BasicBlock const * a, BasicBlock const * b) const
+	{
+		if (!this->IsReachable(a) || !this->IsReachable(b))
+		{
+			return nullptr;
+		}
+
+		uint32_t na = a->Number();
+		uint32_t nb = b->Number();
+		while (na != nb)
+		{
+			if (level_[na] < level_[nb])
+			{
+				std::swap(na, nb);
+			}
+			na = idom_[na];
+			if (na == INVALID_NUMBER)
+			{
+				return nullptr;
+			}
+		}
+		return blocks_[na];
+	}
+
+	void DominatorTreeBase::Clear()
+	{
+		func_ = nullptr;
+		roots_.clear();
+		blocks_.clear();
+		idom_.clear();
+		level_.clear();
+		dfs_in_.clear();
+		dfs_out_.clear();
+		child_offsets_.clear();
+		children_.clear();
+	}
+}
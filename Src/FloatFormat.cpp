@@ -0,0 +1,384 @@
+/**
+ * @file FloatFormat.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include "FloatFormat.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	using namespace Dilithium;
+
+	uint64_t const DpSignificandMask = 0x000FFFFFFFFFFFFFULL;
+	uint64_t const DpExponentMask = 0x7FF0000000000000ULL;
+	uint64_t const DpHiddenBit = 0x0010000000000000ULL;
+	int const DpSignificandSize = 52;
+	int const DpExponentBias = 0x3FF + DpSignificandSize;
+	int const DpMinExponent = -DpExponentBias;
+	int const DiySignificandSize = 64;
+
+	uint32_t const Pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+	// A floating point number as f * 2^e with a 64-bit significand
+	struct DiyFp
+	{
+		uint64_t f;
+		int e;
+
+		DiyFp(uint64_t f, int e)
+			: f(f), e(e)
+		{
+		}
+
+		explicit DiyFp(double d)
+		{
+			uint64_t u;
+			std::memcpy(&u, &d, sizeof(u));
+			int const biased_e = static_cast<int>((u & DpExponentMask) >> DpSignificandSize);
+			uint64_t const significand = u & DpSignificandMask;
+			if (biased_e != 0)
+			{
+				f = significand + DpHiddenBit;
+				e = biased_e - DpExponentBias;
+			}
+			else
+			{
+				f = significand;
+				e = DpMinExponent + 1;
+			}
+		}
+
+		DiyFp operator-(DiyFp const & rhs) const
+		{
+			BOOST_ASSERT((e == rhs.e) && (f >= rhs.f));
+			return DiyFp(f - rhs.f, e);
+		}
+
+		// The upper 64 bits of the product, rounded
+		DiyFp operator*(DiyFp const & rhs) const
+		{
+			uint64_t const mask32 = 0xFFFFFFFFULL;
+			uint64_t const a = f >> 32;
+			uint64_t const b = f & mask32;
+			uint64_t const c = rhs.f >> 32;
+			uint64_t const d = rhs.f & mask32;
+			uint64_t const ac = a * c;
+			uint64_t const bc = b * c;
+			uint64_t const ad = a * d;
+			uint64_t const bd = b * d;
+			uint64_t tmp = (bd >> 32) + (ad & mask32) + (bc & mask32);
+			tmp += 1ULL << 31;
+			return DiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), e + rhs.e + 64);
+		}
+
+		DiyFp Normalize() const
+		{
+			DiyFp ret = *this;
+			while (!(ret.f & DpHiddenBit))
+			{
+				ret.f <<= 1;
+				-- ret.e;
+			}
+			ret.f <<= DiySignificandSize - DpSignificandSize - 1;
+			ret.e -= DiySignificandSize - DpSignificandSize - 1;
+			return ret;
+		}
+
+		DiyFp NormalizeBoundary() const
+		{
+			DiyFp ret = *this;
+			while (!(ret.f & (DpHiddenBit << 1)))
+			{
+				ret.f <<= 1;
+				-- ret.e;
+			}
+			ret.f <<= DiySignificandSize - DpSignificandSize - 2;
+			ret.e -= DiySignificandSize - DpSignificandSize - 2;
+			return ret;
+		}
+
+		// The midpoints to the neighboring doubles, with the exponent of the normalized upper one
+		void NormalizedBoundaries(DiyFp& minus, DiyFp& plus) const
+		{
+			plus = DiyFp((f << 1) + 1, e - 1).NormalizeBoundary();
+			minus = (f == DpHiddenBit) ? DiyFp((f << 2) - 1, e - 2) : DiyFp((f << 1) - 1, e - 1);
+			minus.f <<= minus.e - plus.e;
+			minus.e = plus.e;
+		}
+	};
+
+	// 10^k for k = -348, -340, ..., 340, normalized to a 64-bit significand
+	uint64_t const CachedPowersF[] =
+	{
+		0xFA8FD5A0081C0288ULL, 0xBAAEE17FA23EBF76ULL, 0x8B16FB203055AC76ULL, 0xCF42894A5DCE35EAULL,
+		0x9A6BB0AA55653B2DULL, 0xE61ACF033D1A45DFULL, 0xAB70FE17C79AC6CAULL, 0xFF77B1FCBEBCDC4FULL,
+		0xBE5691EF416BD60CULL, 0x8DD01FAD907FFC3CULL, 0xD3515C2831559A83ULL, 0x9D71AC8FADA6C9B5ULL,
+		0xEA9C227723EE8BCBULL, 0xAECC49914078536DULL, 0x823C12795DB6CE57ULL, 0xC21094364DFB5637ULL,
+		0x9096EA6F3848984FULL, 0xD77485CB25823AC7ULL, 0xA086CFCD97BF97F4ULL, 0xEF340A98172AACE5ULL,
+		0xB23867FB2A35B28EULL, 0x84C8D4DFD2C63F3BULL, 0xC5DD44271AD3CDBAULL, 0x936B9FCEBB25C996ULL,
+		0xDBAC6C247D62A584ULL, 0xA3AB66580D5FDAF6ULL, 0xF3E2F893DEC3F126ULL, 0xB5B5ADA8AAFF80B8ULL,
+		0x87625F056C7C4A8BULL, 0xC9BCFF6034C13053ULL, 0x964E858C91BA2655ULL, 0xDFF9772470297EBDULL,
+		0xA6DFBD9FB8E5B88FULL, 0xF8A95FCF88747D94ULL, 0xB94470938FA89BCFULL, 0x8A08F0F8BF0F156BULL,
+		0xCDB02555653131B6ULL, 0x993FE2C6D07B7FACULL, 0xE45C10C42A2B3B06ULL, 0xAA242499697392D3ULL,
+		0xFD87B5F28300CA0EULL, 0xBCE5086492111AEBULL, 0x8CBCCC096F5088CCULL, 0xD1B71758E219652CULL,
+		0x9C40000000000000ULL, 0xE8D4A51000000000ULL, 0xAD78EBC5AC620000ULL, 0x813F3978F8940984ULL,
+		0xC097CE7BC90715B3ULL, 0x8F7E32CE7BEA5C70ULL, 0xD5D238A4ABE98068ULL, 0x9F4F2726179A2245ULL,
+		0xED63A231D4C4FB27ULL, 0xB0DE65388CC8ADA8ULL, 0x83C7088E1AAB65DBULL, 0xC45D1DF942711D9AULL,
+		0x924D692CA61BE758ULL, 0xDA01EE641A708DEAULL, 0xA26DA3999AEF774AULL, 0xF209787BB47D6B85ULL,
+		0xB454E4A179DD1877ULL, 0x865B86925B9BC5C2ULL, 0xC83553C5C8965D3DULL, 0x952AB45CFA97A0B3ULL,
+		0xDE469FBD99A05FE3ULL, 0xA59BC234DB398C25ULL, 0xF6C69A72A3989F5CULL, 0xB7DCBF5354E9BECEULL,
+		0x88FCF317F22241E2ULL, 0xCC20CE9BD35C78A5ULL, 0x98165AF37B2153DFULL, 0xE2A0B5DC971F303AULL,
+		0xA8D9D1535CE3B396ULL, 0xFB9B7CD9A4A7443CULL, 0xBB764C4CA7A44410ULL, 0x8BAB8EEFB6409C1AULL,
+		0xD01FEF10A657842CULL, 0x9B10A4E5E9913129ULL, 0xE7109BFBA19C0C9DULL, 0xAC2820D9623BF429ULL,
+		0x80444B5E7AA7CF85ULL, 0xBF21E44003ACDD2DULL, 0x8E679C2F5E44FF8FULL, 0xD433179D9C8CB841ULL,
+		0x9E19DB92B4E31BA9ULL, 0xEB96BF6EBADF77D9ULL, 0xAF87023B9BF0EE6BULL
+	};
+	int16_t const CachedPowersE[] =
+	{
+		-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+		-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+		-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+		-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+		56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+		375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+		694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+		1013, 1039, 1066
+	};
+
+	// A cached power c_mk = 10^-k so that the product with a significand of binary exponent e lands in [-60, -32]
+	DiyFp CachedPower(int e, int& k)
+	{
+		double const dk = (-61 - e) * 0.30102999566398114 + 347;
+		int ik = static_cast<int>(dk);
+		if (dk - ik > 0.0)
+		{
+			++ ik;
+		}
+
+		uint32_t const index = static_cast<uint32_t>((ik >> 3) + 1);
+		k = -(-348 + static_cast<int>(index << 3));
+		return DiyFp(CachedPowersF[index], CachedPowersE[index]);
+	}
+
+	// Moves the last digit towards w while it stays inside the rounding interval
+	void GrisuRound(char* buf, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w)
+	{
+		while ((rest < wp_w) && (delta - rest >= ten_kappa)
+			&& ((rest + ten_kappa < wp_w) || (wp_w - rest > rest + ten_kappa - wp_w)))
+		{
+			-- buf[len - 1];
+			rest += ten_kappa;
+		}
+	}
+
+	int CountDecimalDigits(uint32_t n)
+	{
+		int digits = 1;
+		while ((digits < 10) && (n >= Pow10[digits]))
+		{
+			++ digits;
+		}
+		return digits;
+	}
+
+	void DigitGen(DiyFp const & w, DiyFp const & mp, uint64_t delta, char* buf, int& len, int& k)
+	{
+		DiyFp const one(1ULL << -mp.e, mp.e);
+		DiyFp const wp_w = mp - w;
+		uint32_t p1 = static_cast<uint32_t>(mp.f >> -one.e);
+		uint64_t p2 = mp.f & (one.f - 1);
+		int kappa = CountDecimalDigits(p1);
+		len = 0;
+
+		while (kappa > 0)
+		{
+			uint32_t const d = p1 / Pow10[kappa - 1];
+			p1 %= Pow10[kappa - 1];
+			if (d || len)
+			{
+				buf[len] = static_cast<char>('0' + d);
+				++ len;
+			}
+			-- kappa;
+
+			uint64_t const rest = (static_cast<uint64_t>(p1) << -one.e) + p2;
+			if (rest <= delta)
+			{
+				k += kappa;
+				GrisuRound(buf, len, delta, rest, static_cast<uint64_t>(Pow10[kappa]) << -one.e, wp_w.f);
+				return;
+			}
+		}
+
+		for (;;)
+		{
+			p2 *= 10;
+			delta *= 10;
+			char const d = static_cast<char>(p2 >> -one.e);
+			if (d || len)
+			{
+				buf[len] = static_cast<char>('0' + d);
+				++ len;
+			}
+			p2 &= one.f - 1;
+			-- kappa;
+
+			if (p2 < delta)
+			{
+				k += kappa;
+				GrisuRound(buf, len, delta, p2, one.f, (-kappa < 10) ? wp_w.f * Pow10[-kappa] : 0);
+				return;
+			}
+		}
+	}
+
+	// Digits of a positive double and the decimal exponent of the last one
+	void Grisu2(double val, char* buf, int& len, int& k)
+	{
+		DiyFp const v(val);
+		DiyFp w_m(0, 0);
+		DiyFp w_p(0, 0);
+		v.NormalizedBoundaries(w_m, w_p);
+
+		DiyFp const c_mk = CachedPower(w_p.e, k);
+		DiyFp const w = v.Normalize() * c_mk;
+		DiyFp wp = w_p * c_mk;
+		DiyFp wm = w_m * c_mk;
+		++ wm.f;
+		-- wp.f;
+		DigitGen(w, wp, wp.f - wm.f, buf, len, k);
+	}
+
+	char* WriteExponent(int exp, char* p)
+	{
+		*p = 'e';
+		++ p;
+		if (exp < 0)
+		{
+			*p = '-';
+			exp = -exp;
+		}
+		else
+		{
+			*p = '+';
+		}
+		++ p;
+
+		if (exp >= 100)
+		{
+			*p = static_cast<char>('0' + exp / 100);
+			++ p;
+			exp %= 100;
+		}
+		*p = static_cast<char>('0' + exp / 10);
+		++ p;
+		*p = static_cast<char>('0' + exp % 10);
+		++ p;
+		return p;
+	}
+
+	// Lays out len digits, worth digits * 10^k, in place
+	char* Prettify(char* buf, int len, int k)
+	{
+		int const point = len + k;	// Position of the decimal point relative to the first digit
+
+		if ((k >= 0) && (point <= 17))
+		{
+			// 1234e5 -> 123400000.0
+			std::memset(buf + len, '0', k);
+			buf[point] = '.';
+			buf[point + 1] = '0';
+			return buf + point + 2;
+		}
+		else if ((point > 0) && (point <= 17))
+		{
+			// 1234e-2 -> 12.34
+			std::memmove(buf + point + 1, buf + point, len - point);
+			buf[point] = '.';
+			return buf + len + 1;
+		}
+		else if ((point > -5) && (point <= 0))
+		{
+			// 1234e-6 -> 0.001234
+			int const offset = 2 - point;
+			std::memmove(buf + offset, buf, len);
+			buf[0] = '0';
+			buf[1] = '.';
+			std::memset(buf + 2, '0', offset - 2);
+			return buf + len + offset;
+		}
+		else
+		{
+			// 1234e30 -> 1.234e+33
+			std::memmove(buf + 2, buf + 1, len - 1);
+			buf[1] = '.';
+			if (len == 1)
+			{
+				buf[2] = '0';
+				++ len;
+			}
+			return WriteExponent(point - 1, buf + len + 1);
+		}
+	}
+}
+
+namespace Dilithium
+{
+	uint32_t FormatShortestDouble(double val, char* buf)
+	{
+		char* p = buf;
+		if (std::signbit(val))
+		{
+			*p = '-';
+			++ p;
+			val = -val;
+		}
+
+		if (val == 0)
+		{
+			p[0] = '0';
+			p[1] = '.';
+			p[2] = '0';
+			return static_cast<uint32_t>(p + 3 - buf);
+		}
+
+		BOOST_ASSERT_MSG(std::isfinite(val), "Only finite values can be formatted");
+
+		int len;
+		int k;
+		Grisu2(val, p, len, k);
+		return static_cast<uint32_t>(Prettify(p, len, k) - buf);
+	}
+}
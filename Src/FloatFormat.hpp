@@ -0,0 +1,53 @@
+/**
+ * @file FloatFormat.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DILITHIUM_FLOAT_FORMAT_HPP
+#define _DILITHIUM_FLOAT_FORMAT_HPP
+
+#pragma once
+
+#include <cstdint>
+
+namespace Dilithium
+{
+	// Large enough for the sign, 17 significant digits, the decimal point and a 3-digit exponent.
+	uint32_t const FloatFormatBufferSize = 32;
+
+	// Writes a finite double as the shortest decimal that parses back to the same value, using Grisu2. The text
+	// always has a decimal point ("1.0", "0.015625", "1.5e+300"), so it's accepted by the LLVM IR lexer. Returns the
+	// number of characters written, without a terminating null.
+	uint32_t FormatShortestDouble(double val, char* buf);
+}
+
+#endif		// _DILITHIUM_FLOAT_FORMAT_HPP
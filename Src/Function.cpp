@@ -43,7 +43,7 @@ namespace Dilithium
 {
 	Function::Function(FunctionType* ty, LinkageTypes linkage, std::string_view name, LLVMModule* mod)
 		: GlobalObject(PointerType::Get(ty, 0), Value::FunctionVal, 0, 1, linkage, name),
-			ty_(ty)
+			ty_(ty), next_block_number_(0)
 	{
 		BOOST_ASSERT_MSG(FunctionType::IsValidReturnType(this->GetReturnType()), "invalid return type");
 		this->GlobalObjectSubClassData(0);
@@ -272,6 +272,17 @@ namespace Dilithium
 		this->SetValueSubclassData(pd_data);
 	}
 
+	void Function::RenumberBlocks()
+	{
+		uint32_t number = 0;
+		for (auto& bb : basic_blocks_)
+		{
+			bb->number_ = number;
+			++ number;
+		}
+		next_block_number_ = number;
+	}
+
 	void Function::DropAllReferences()
 	{
 		this->IsMaterializable(false);
@@ -303,6 +314,29 @@ namespace Dilithium
 		Context().Impl().function_metadata[this].GetAll(mds);
 	}
 
+	void Function::SetMetadata(uint32_t kind_id, MDNode* node)
+	{
+		if (!node && !this->HasMetadata())
+		{
+			return;
+		}
+
+		auto& info = this->Context().Impl().function_metadata[this];
+		if (node)
+		{
+			info.Set(kind_id, *node);
+			this->HasMetadataHashEntry(true);
+		}
+		else
+		{
+			info.Erase(kind_id);
+			if (info.empty())
+			{
+				this->ClearMetadata();
+			}
+		}
+	}
+
 	void Function::CheckLazyArguments() const
 	{
 		if (this->HasLazyArguments())
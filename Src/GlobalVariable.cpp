@@ -34,9 +34,62 @@
 
 #include <Dilithium/Dilithium.hpp>
 #include <Dilithium/GlobalVariable.hpp>
+#include <Dilithium/Constant.hpp>
+#include <Dilithium/DerivedType.hpp>
 
 namespace Dilithium 
 {
+	GlobalVariable::GlobalVariable(Type* ty, bool is_constant, LinkageTypes linkage, Constant* initializer,
+		std::string_view name, uint32_t address_space)
+		: GlobalObject(PointerType::Get(ty, address_space), Value::GlobalVariableVal, initializer ? 1 : 0, 1, linkage, name),
+			is_constant_(is_constant), is_externally_initialized_(false)
+	{
+		if (initializer)
+		{
+			BOOST_ASSERT_MSG(initializer->GetType() == ty, "Initializer should be the same type as the GlobalVariable!");
+			this->Op<0>().Set(initializer);
+		}
+	}
+
+	GlobalVariable::~GlobalVariable()
+	{
+		this->DropAllReferences();
+	}
+
+	GlobalVariable* GlobalVariable::Create(Type* ty, bool is_constant, LinkageTypes linkage, Constant* initializer,
+		std::string_view name, uint32_t address_space)
+	{
+		return new GlobalVariable(ty, is_constant, linkage, initializer, name, address_space);
+	}
+
+	Constant* GlobalVariable::GetInitializer() const
+	{
+		BOOST_ASSERT_MSG(this->HasInitializer(), "GV doesn't have initializer!");
+		return cast<Constant>(this->Op<0>());
+	}
+
+	void GlobalVariable::SetInitializer(Constant* initializer)
+	{
+		if (!initializer)
+		{
+			if (this->HasInitializer())
+			{
+				this->Op<0>().Set(nullptr);
+				this->GlobalVariableOrFunctionNumOperands(0);
+			}
+		}
+		else
+		{
+			BOOST_ASSERT_MSG(initializer->GetType() == cast<PointerType>(this->GetType())->ElementType(),
+				"Initializer type must match GlobalVariable type");
+			if (!this->HasInitializer())
+			{
+				this->GlobalVariableOrFunctionNumOperands(1);
+			}
+			this->Op<0>().Set(initializer);
+		}
+	}
+
 	bool GlobalVariable::classof(Value const * v)
 	{
 		return v->GetValueId() == Value::GlobalVariableVal;
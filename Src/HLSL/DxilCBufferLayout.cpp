@@ -0,0 +1,251 @@
+/**
+ * @file DxilCBufferLayout.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/dxc/HLSL/DxilCBufferLayout.hpp>
+
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/MathExtras.hpp>
+#include <Dilithium/dxc/HLSL/DxilTypeSystem.hpp>
+#include <Dilithium/dxc/HLSL/HLMatrixLowerHelper.hpp>
+
+#include <algorithm>
+
+#include <boost/assert.hpp>
+
+namespace
+{
+	using namespace Dilithium;
+
+	uint32_t const CBufferRowSize = 16;
+
+	uint32_t AlignTo(uint32_t offset, uint32_t align)
+	{
+		return static_cast<uint32_t>(RoundUpToAlignment(offset, align));
+	}
+
+	// Scalars narrower than 32 bits are stored as 32 bits with min precision, which is the only mode DXIL supports here
+	uint32_t ScalarSize(Type* ty)
+	{
+		return (ty->PrimitiveSizeInBits() == 64) ? 8 : 4;
+	}
+
+	// Where a field of size bytes lands after offset. Same rule as fxc and dxc.
+	uint32_t PlaceField(uint32_t offset, uint32_t size, uint32_t scalar_size, bool new_row)
+	{
+		if (new_row || ((offset % CBufferRowSize) + size > CBufferRowSize))
+		{
+			return AlignTo(offset, CBufferRowSize);
+		}
+		return AlignTo(offset, scalar_size);
+	}
+}
+
+namespace Dilithium
+{
+	DxilCBufferLayout::DxilCBufferLayout(DxilTypeSystem& type_system)
+		: type_system_(type_system)
+	{
+	}
+
+	DxilCBufferStructLayout const * DxilCBufferLayout::GetStructLayout(StructType const * st) const
+	{
+		{
+			std::lock_guard<std::mutex> lock(layouts_mutex_);
+			auto iter = layouts_.find(st);
+			if (iter != layouts_.end())
+			{
+				return iter->second.get();
+			}
+		}
+
+		// Same as DataLayout::GetStructLayout, nested structs are laid out without holding the lock
+		auto layout = this->LayoutStruct(st);
+
+		std::lock_guard<std::mutex> lock(layouts_mutex_);
+		auto& entry = layouts_[st];
+		if (!entry)
+		{
+			entry = std::move(layout);
+		}
+		return entry.get();
+	}
+
+	void DxilCBufferLayout::Precompute() const
+	{
+		for (auto const & anno : type_system_.GetStructAnnotationMap())
+		{
+			this->GetStructLayout(anno.first);
+		}
+	}
+
+	uint32_t DxilCBufferLayout::TypeSize(Type* ty, DxilFieldAnnotation const * annotation) const
+	{
+		return this->MeasureField(ty, annotation).size;
+	}
+
+	bool DxilCBufferLayout::VerifyAnnotation(StructType const * st) const
+	{
+		auto annotation = type_system_.GetStructAnnotation(st);
+		if (!annotation)
+		{
+			return false;
+		}
+
+		auto layout = this->GetStructLayout(st);
+		if ((annotation->CBufferSize() != layout->SizeInBytes()) || (annotation->NumFields() != layout->NumElements()))
+		{
+			return false;
+		}
+		for (uint32_t i = 0; i < annotation->NumFields(); ++ i)
+		{
+			auto const & field = annotation->FieldAnnotation(i);
+			if (field.HasCBufferOffset() && (field.GetCBufferOffset() != layout->ElementOffset(i)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void DxilCBufferLayout::SynthesizeAnnotation(StructType const * st)
+	{
+		auto layout = this->GetStructLayout(st);
+
+		auto annotation = type_system_.GetStructAnnotation(st);
+		if (!annotation)
+		{
+			annotation = type_system_.AddStructAnnotation(st);
+		}
+
+		// A layout cached before the struct got its body has fewer elements than the annotation. The extra fields are left alone.
+		annotation->CBufferSize(layout->SizeInBytes());
+		uint32_t const num_fields = std::min(annotation->NumFields(), layout->NumElements());
+		for (uint32_t i = 0; i < num_fields; ++ i)
+		{
+			annotation->FieldAnnotation(i).SetCBufferOffset(layout->ElementOffset(i));
+		}
+	}
+
+	DxilCBufferLayout::FieldPlacement DxilCBufferLayout::MeasureField(Type* ty, DxilFieldAnnotation const * annotation) const
+	{
+		FieldPlacement ret;
+		if (ty->IsArrayType())
+		{
+			uint64_t num_elems = 1;
+			while (ty->IsArrayType())
+			{
+				num_elems *= ty->ArrayNumElements();
+				ty = ty->ArrayElementType();
+			}
+
+			auto const elem = this->MeasureField(ty, annotation);
+			ret.size = (num_elems == 0) ? 0
+				: static_cast<uint32_t>((num_elems - 1) * AlignTo(elem.size, CBufferRowSize) + elem.size);
+			ret.scalar_size = elem.scalar_size;
+			ret.new_row = true;
+		}
+		else if (HLMatrixLower::IsMatrixType(ty))
+		{
+			uint32_t num_arrays;
+			uint32_t vec_size;
+			Type* elem_ty = HLMatrixLower::GetMatrixInfo(ty, num_arrays, vec_size);
+
+			// class.matrix.T.R.C is { [R x <C x T>] }
+			uint32_t rows = num_arrays;
+			uint32_t cols = vec_size;
+			MatrixOrientation orientation = MatrixOrientation::ColumnMajor;
+			if (annotation && annotation->HasMatrixAnnotation())
+			{
+				auto const & matrix = annotation->GetMatrixAnnotation();
+				rows = matrix.rows;
+				cols = matrix.cols;
+				orientation = matrix.orientation;
+			}
+
+			uint32_t const num_vectors = (orientation == MatrixOrientation::RowMajor) ? rows : cols;
+			uint32_t const vector_length = (orientation == MatrixOrientation::RowMajor) ? cols : rows;
+			ret.scalar_size = ScalarSize(elem_ty);
+			ret.size = ((num_vectors == 0) || (vector_length == 0)) ? 0
+				: (num_vectors - 1) * CBufferRowSize + vector_length * ret.scalar_size;
+			ret.new_row = num_vectors > 1;
+		}
+		else if (ty->IsStructType())
+		{
+			ret.size = this->GetStructLayout(cast<StructType>(ty))->SizeInBytes();
+			ret.scalar_size = 4;
+			ret.new_row = true;
+		}
+		else if (ty->IsVectorType())
+		{
+			ret.scalar_size = ScalarSize(ty->VectorElementType());
+			ret.size = ty->VectorNumElements() * ret.scalar_size;
+			ret.new_row = false;
+		}
+		else
+		{
+			ret.scalar_size = ScalarSize(ty);
+			ret.size = ret.scalar_size;
+			ret.new_row = false;
+		}
+		return ret;
+	}
+
+	std::unique_ptr<DxilCBufferStructLayout> DxilCBufferLayout::LayoutStruct(StructType const * st) const
+	{
+		auto annotation = type_system_.GetStructAnnotation(st);
+		auto layout = std::make_unique<DxilCBufferStructLayout>();
+
+		uint32_t offset = 0;
+		if (!annotation || !annotation->IsEmptyStruct())
+		{
+			uint32_t const num_elems = st->NumElements();
+			layout->offsets_.resize(num_elems);
+			layout->sizes_.resize(num_elems);
+			for (uint32_t i = 0; i < num_elems; ++ i)
+			{
+				DxilFieldAnnotation const * field = (annotation && (i < annotation->NumFields())) ? &annotation->FieldAnnotation(i) : nullptr;
+				auto const placement = this->MeasureField(st->ElementType(i), field);
+
+				offset = PlaceField(offset, placement.size, placement.scalar_size, placement.new_row);
+				layout->offsets_[i] = offset;
+				layout->sizes_[i] = placement.size;
+				offset += placement.size;
+			}
+		}
+		layout->size_ = offset;
+
+		return layout;
+	}
+}
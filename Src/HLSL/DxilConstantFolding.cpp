@@ -0,0 +1,726 @@
+/**
+ * @file DxilConstantFolding.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/dxc/HLSL/DxilConstantFolding.hpp>
+
+#include <Dilithium/BasicBlock.hpp>
+#include <Dilithium/Constants.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/Function.hpp>
+#include <Dilithium/Instructions.hpp>
+#include <Dilithium/LLVMModule.hpp>
+#include <Dilithium/MathExtras.hpp>
+#include <Dilithium/MPFloat.hpp>
+#include <Dilithium/MPInt.hpp>
+#include <Dilithium/dxc/HLSL/DxilOperations.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/assert.hpp>
+
+namespace
+{
+	using namespace Dilithium;
+
+	double const HalfMinNormal = 6.103515625e-05;
+
+	// f16/f32 denormals may or may not be flushed by the driver, so nothing that touches one is folded. f64 keeps them.
+	bool IsDenormal(double v, Type const * ty)
+	{
+		if (ty->IsDoubleType() || (v == 0) || !std::isfinite(v))
+		{
+			return false;
+		}
+		return std::fabs(v) < (ty->IsHalfType() ? HalfMinNormal : static_cast<double>(FLT_MIN));
+	}
+
+	// Rounds v to the precision of ty, the same way ConstantFP stores it.
+	// Returns false if the rounded value is a denormal, which can't be folded.
+	bool RoundToType(double& v, Type const * ty)
+	{
+		if (!ty->IsDoubleType())
+		{
+			MPFloat f(v);
+			f.Convert(ty->IsHalfType() ? MPFloat::IEEEHalf : MPFloat::IEEESingle, nullptr);
+			f.Convert(MPFloat::IEEEDouble, nullptr);
+			v = f.ConvertToDouble();
+		}
+		return !IsDenormal(v, ty);
+	}
+
+	bool FloatArg(CallInst const & call, uint32_t idx, double& v)
+	{
+		auto c = dyn_cast<ConstantFP>(call.ArgOperand(idx));
+		if (!c)
+		{
+			return false;
+		}
+
+		MPFloat f = c->GetValueMPF();
+		f.Convert(MPFloat::IEEEDouble, nullptr);
+		v = f.ConvertToDouble();
+		return !IsDenormal(v, c->GetType());
+	}
+
+	bool IntArg(CallInst const & call, uint32_t idx, uint64_t& v)
+	{
+		auto c = dyn_cast<ConstantInt>(call.ArgOperand(idx));
+		if (!c || (c->GetValue().BitWidth() > 64))
+		{
+			return false;
+		}
+
+		v = c->ZExtValue();
+		return true;
+	}
+
+	uint64_t MaskToWidth(uint64_t v, uint32_t width)
+	{
+		return (width >= 64) ? v : (v & ((1ULL << width) - 1));
+	}
+
+	int64_t SignExtend(uint64_t v, uint32_t width)
+	{
+		uint32_t const shift = 64 - width;
+		return static_cast<int64_t>(v << shift) >> shift;
+	}
+
+	Constant* FloatResult(double v, Type* ty)
+	{
+		if (!RoundToType(v, ty))
+		{
+			return nullptr;
+		}
+		return ConstantFP::Get(ty, v);
+	}
+
+	Constant* IntResult(uint64_t v, Type* ty)
+	{
+		auto int_ty = cast<IntegerType>(ty);
+		return ConstantInt::Get(int_ty, MaskToWidth(v, int_ty->BitWidth()));
+	}
+
+	// Leading zeros of a non-zero value counted within the low width bits
+	uint32_t LeadingZeros(uint64_t v, uint32_t width)
+	{
+		BOOST_ASSERT(v != 0);
+		return static_cast<uint32_t>(CountLeadingZeros(v)) - (64 - width);
+	}
+
+	uint32_t TrailingZeros(uint64_t v)
+	{
+		BOOST_ASSERT(v != 0);
+		return CountPopulation((v & (0 - v)) - 1);
+	}
+
+	Constant* FoldUnaryFloat(OpCode op, CallInst const & call, Type* ty)
+	{
+		double a;
+		if (!FloatArg(call, 1, a))
+		{
+			return nullptr;
+		}
+
+		double r;
+		switch (op)
+		{
+		case OpCode::FAbs:
+			r = std::fabs(a);
+			break;
+		case OpCode::Saturate:
+			// NaN and -0 both go to +0
+			r = (a > 0) ? std::min(a, 1.0) : 0.0;
+			break;
+		case OpCode::Cos:
+			r = std::cos(a);
+			break;
+		case OpCode::Sin:
+			r = std::sin(a);
+			break;
+		case OpCode::Tan:
+			r = std::tan(a);
+			break;
+		case OpCode::Acos:
+			r = std::acos(a);
+			break;
+		case OpCode::Asin:
+			r = std::asin(a);
+			break;
+		case OpCode::Atan:
+			r = std::atan(a);
+			break;
+		case OpCode::Hcos:
+			r = std::cosh(a);
+			break;
+		case OpCode::Hsin:
+			r = std::sinh(a);
+			break;
+		case OpCode::Htan:
+			r = std::tanh(a);
+			break;
+		case OpCode::Exp:
+			r = std::exp2(a);
+			break;
+		case OpCode::Log:
+			r = std::log2(a);
+			break;
+		case OpCode::Frc:
+			r = a - std::floor(a);
+			break;
+		case OpCode::Sqrt:
+			r = std::sqrt(a);
+			break;
+		case OpCode::Rsqrt:
+			r = 1 / std::sqrt(a);
+			break;
+		case OpCode::Round_ne:
+			r = std::nearbyint(a);
+			break;
+		case OpCode::Round_ni:
+			r = std::floor(a);
+			break;
+		case OpCode::Round_pi:
+			r = std::ceil(a);
+			break;
+		case OpCode::Round_z:
+			r = std::trunc(a);
+			break;
+
+		default:
+			return nullptr;
+		}
+
+		return FloatResult(r, ty);
+	}
+
+	Constant* FoldIsSpecialFloat(OpCode op, CallInst const & call, Type* ty)
+	{
+		double a;
+		if (!FloatArg(call, 1, a))
+		{
+			return nullptr;
+		}
+
+		bool r;
+		switch (op)
+		{
+		case OpCode::IsNaN:
+			r = std::isnan(a);
+			break;
+		case OpCode::IsInf:
+			r = std::isinf(a);
+			break;
+		case OpCode::IsFinite:
+			r = std::isfinite(a);
+			break;
+		case OpCode::IsNormal:
+			// Denormal inputs are already rejected by FloatArg
+			r = std::isfinite(a) && (a != 0);
+			break;
+
+		default:
+			return nullptr;
+		}
+
+		return IntResult(r ? 1 : 0, ty);
+	}
+
+	Constant* FoldUnaryInt(OpCode op, CallInst const & call, Type* ty)
+	{
+		uint64_t a;
+		if (!IntArg(call, 1, a))
+		{
+			return nullptr;
+		}
+		uint32_t const width = call.ArgOperand(1)->GetType()->IntegerBitWidth();
+
+		uint64_t r;
+		switch (op)
+		{
+		case OpCode::Bfrev:
+			r = 0;
+			for (uint32_t i = 0; i < width; ++ i)
+			{
+				r |= ((a >> i) & 1ULL) << (width - 1 - i);
+			}
+			break;
+		case OpCode::Countbits:
+			r = CountPopulation(a);
+			break;
+		case OpCode::FirstbitLo:
+			r = (a == 0) ? ~0ULL : TrailingZeros(a);
+			break;
+		case OpCode::FirstbitHi:
+			// Counted from the MSB
+			r = (a == 0) ? ~0ULL : LeadingZeros(a, width);
+			break;
+		case OpCode::FirstbitSHi:
+			if (SignExtend(a, width) < 0)
+			{
+				a = MaskToWidth(~a, width);
+			}
+			r = (a == 0) ? ~0ULL : LeadingZeros(a, width);
+			break;
+
+		default:
+			return nullptr;
+		}
+
+		return IntResult(r, ty);
+	}
+
+	Constant* FoldBinary(OpCode op, CallInst const & call, Type* ty)
+	{
+		if ((op == OpCode::FMax) || (op == OpCode::FMin))
+		{
+			double a;
+			double b;
+			if (!FloatArg(call, 1, a) || !FloatArg(call, 2, b))
+			{
+				return nullptr;
+			}
+			if ((a == 0) && (b == 0) && (std::signbit(a) != std::signbit(b)))
+			{
+				// The order of -0 and +0 is left to the implementation
+				return nullptr;
+			}
+
+			// IEEE maxNum/minNum, a NaN operand returns the other one
+			return FloatResult((op == OpCode::FMax) ? std::fmax(a, b) : std::fmin(a, b), ty);
+		}
+
+		uint64_t a;
+		uint64_t b;
+		if (!IntArg(call, 1, a) || !IntArg(call, 2, b))
+		{
+			return nullptr;
+		}
+		uint32_t const width = ty->IntegerBitWidth();
+
+		switch (op)
+		{
+		case OpCode::IMax:
+			return IntResult((SignExtend(a, width) > SignExtend(b, width)) ? a : b, ty);
+		case OpCode::IMin:
+			return IntResult((SignExtend(a, width) < SignExtend(b, width)) ? a : b, ty);
+		case OpCode::UMax:
+			return IntResult(std::max(a, b), ty);
+		case OpCode::UMin:
+			return IntResult(std::min(a, b), ty);
+
+		default:
+			return nullptr;
+		}
+	}
+
+	// D3D bitfield extract, args are (width, offset, value)
+	uint64_t BitfieldExtract(uint64_t width, uint64_t offset, uint64_t value, uint32_t bits, bool is_signed)
+	{
+		width &= bits - 1;
+		offset &= bits - 1;
+		if (width == 0)
+		{
+			return 0;
+		}
+
+		int64_t const sv = SignExtend(value, bits);
+		if (width + offset < bits)
+		{
+			uint32_t const up = static_cast<uint32_t>(64 - width - offset);
+			uint32_t const down = static_cast<uint32_t>(64 - width);
+			return is_signed ? static_cast<uint64_t>(static_cast<int64_t>(value << up) >> down) : ((value << up) >> down);
+		}
+		else
+		{
+			return is_signed ? static_cast<uint64_t>(sv >> offset) : (value >> offset);
+		}
+	}
+
+	uint64_t MaskedSad(uint64_t ref, uint64_t src, uint64_t accum)
+	{
+		for (uint32_t i = 0; i < 4; ++ i)
+		{
+			uint32_t const r = (ref >> (i * 8)) & 0xFF;
+			uint32_t const s = (src >> (i * 8)) & 0xFF;
+			if (s != 0)
+			{
+				accum += (r > s) ? (r - s) : (s - r);
+			}
+		}
+		return accum;
+	}
+
+	Constant* FoldTertiary(OpCode op, CallInst const & call, Type* ty)
+	{
+		if ((op == OpCode::FMad) || (op == OpCode::Fma))
+		{
+			double a;
+			double b;
+			double c;
+			if (!FloatArg(call, 1, a) || !FloatArg(call, 2, b) || !FloatArg(call, 3, c))
+			{
+				return nullptr;
+			}
+
+			if (op == OpCode::Fma)
+			{
+				return FloatResult(std::fma(a, b, c), ty);
+			}
+
+			// FMad isn't required to be fused, fold it as a rounded multiply then a rounded add
+			double ab = a * b;
+			if (!RoundToType(ab, ty))
+			{
+				return nullptr;
+			}
+			return FloatResult(ab + c, ty);
+		}
+
+		uint64_t a;
+		uint64_t b;
+		uint64_t c;
+		if (!IntArg(call, 1, a) || !IntArg(call, 2, b) || !IntArg(call, 3, c))
+		{
+			return nullptr;
+		}
+		uint32_t const width = ty->IntegerBitWidth();
+
+		switch (op)
+		{
+		case OpCode::IMad:
+		case OpCode::UMad:
+			// Identical in two's complement once truncated to the width
+			return IntResult(a * b + c, ty);
+		case OpCode::Msad:
+			if (width != 32)
+			{
+				return nullptr;
+			}
+			return IntResult(MaskedSad(a, b, c), ty);
+		case OpCode::Ibfe:
+		case OpCode::Ubfe:
+			return IntResult(BitfieldExtract(a, b, c, width, op == OpCode::Ibfe), ty);
+
+		default:
+			return nullptr;
+		}
+	}
+
+	// Args are (width, offset, value, base)
+	Constant* FoldBfi(CallInst const & call, Type* ty)
+	{
+		uint64_t width;
+		uint64_t offset;
+		uint64_t value;
+		uint64_t base;
+		if (!IntArg(call, 1, width) || !IntArg(call, 2, offset) || !IntArg(call, 3, value) || !IntArg(call, 4, base))
+		{
+			return nullptr;
+		}
+
+		width &= 31;
+		offset &= 31;
+		uint64_t const mask = (((1ULL << width) - 1) << offset) & 0xFFFFFFFFULL;
+		return IntResult(((value << offset) & mask) | (base & ~mask), ty);
+	}
+
+	// Args are (a0, ..., an-1, b0, ..., bn-1). Every product and partial sum is rounded in order.
+	Constant* FoldDot(uint32_t n, CallInst const & call, Type* ty)
+	{
+		double sum = 0;
+		for (uint32_t i = 0; i < n; ++ i)
+		{
+			double a;
+			double b;
+			if (!FloatArg(call, 1 + i, a) || !FloatArg(call, 1 + n + i, b))
+			{
+				return nullptr;
+			}
+
+			double prod = a * b;
+			if (!RoundToType(prod, ty))
+			{
+				return nullptr;
+			}
+			if (i == 0)
+			{
+				sum = prod;
+			}
+			else
+			{
+				sum += prod;
+				if (!RoundToType(sum, ty))
+				{
+					return nullptr;
+				}
+			}
+		}
+
+		return FloatResult(sum, ty);
+	}
+
+	Constant* FoldLegacy(OpCode op, CallInst const & call, Type* ty)
+	{
+		switch (op)
+		{
+		case OpCode::LegacyF16ToF32:
+			{
+				uint64_t bits;
+				if (!IntArg(call, 1, bits))
+				{
+					return nullptr;
+				}
+				bits &= 0xFFFF;
+				if (((bits & 0x7C00) == 0) && ((bits & 0x03FF) != 0))
+				{
+					return nullptr;
+				}
+
+				MPFloat f(MPFloat::IEEEHalf, MPInt(16, bits));
+				f.Convert(MPFloat::IEEEDouble, nullptr);
+				return FloatResult(f.ConvertToDouble(), ty);
+			}
+
+		case OpCode::LegacyDoubleToFloat:
+			{
+				double a;
+				if (!FloatArg(call, 1, a))
+				{
+					return nullptr;
+				}
+				return FloatResult(a, ty);
+			}
+
+		case OpCode::LegacyDoubleToSInt32:
+		case OpCode::LegacyDoubleToUInt32:
+			{
+				double a;
+				if (!FloatArg(call, 1, a) || std::isnan(a))
+				{
+					return nullptr;
+				}
+
+				a = std::trunc(a);
+				bool const is_signed = (op == OpCode::LegacyDoubleToSInt32);
+				double const lo = is_signed ? -2147483648.0 : 0.0;
+				double const hi = is_signed ? 2147483647.0 : 4294967295.0;
+				if ((a < lo) || (a > hi))
+				{
+					return nullptr;
+				}
+				return IntResult(is_signed ? static_cast<uint64_t>(static_cast<int64_t>(a)) : static_cast<uint64_t>(a), ty);
+			}
+
+		default:
+			// LegacyF32ToF16's rounding is up to the hardware
+			return nullptr;
+		}
+	}
+
+	bool ArgsAreConstant(CallInst const & call)
+	{
+		for (uint32_t i = 0; i < call.NumArgOperands(); ++ i)
+		{
+			auto arg = call.ArgOperand(i);
+			if (!isa<ConstantInt>(arg) && !isa<ConstantFP>(arg))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	uint32_t NumFoldableArgs(OpCodeClass op_class)
+	{
+		switch (op_class)
+		{
+		case OpCodeClass::Unary:
+		case OpCodeClass::UnaryBits:
+		case OpCodeClass::IsSpecialFloat:
+		case OpCodeClass::LegacyF16ToF32:
+		case OpCodeClass::LegacyDoubleToFloat:
+		case OpCodeClass::LegacyDoubleToSInt32:
+		case OpCodeClass::LegacyDoubleToUInt32:
+			return 2;
+		case OpCodeClass::Binary:
+			return 3;
+		case OpCodeClass::Tertiary:
+			return 4;
+		case OpCodeClass::Quaternary:
+			return 5;
+		case OpCodeClass::Dot2:
+			return 5;
+		case OpCodeClass::Dot3:
+			return 7;
+		case OpCodeClass::Dot4:
+			return 9;
+
+		default:
+			return 0;
+		}
+	}
+}
+
+namespace Dilithium
+{
+	Constant* ConstantFoldDxilCall(CallInst const & call)
+	{
+		auto func = call.CalledFunction();
+		if (!func || !OP::IsDxilOpFunc(func) || (call.NumArgOperands() == 0))
+		{
+			return nullptr;
+		}
+
+		uint64_t op_value;
+		if (!IntArg(call, 0, op_value) || (op_value >= static_cast<uint64_t>(OpCode::NumOpCodes)))
+		{
+			return nullptr;
+		}
+		OpCode const op = static_cast<OpCode>(op_value);
+		if (OP::GetFunctionAttribute(op) != Attribute::AK_ReadNone)
+		{
+			return nullptr;
+		}
+
+		OpCodeClass const op_class = OP::GetOpCodeClass(op);
+		uint32_t const num_args = NumFoldableArgs(op_class);
+		if ((num_args == 0) || (call.NumArgOperands() != num_args) || !ArgsAreConstant(call))
+		{
+			return nullptr;
+		}
+
+		Type* ty = call.GetType();
+		switch (op_class)
+		{
+		case OpCodeClass::Unary:
+			if (ty->IsIntegerType())
+			{
+				return FoldUnaryInt(op, call, ty);
+			}
+			else
+			{
+				return FoldUnaryFloat(op, call, ty);
+			}
+		case OpCodeClass::UnaryBits:
+			return FoldUnaryInt(op, call, ty);
+		case OpCodeClass::IsSpecialFloat:
+			return FoldIsSpecialFloat(op, call, ty);
+		case OpCodeClass::Binary:
+			return FoldBinary(op, call, ty);
+		case OpCodeClass::Tertiary:
+			return FoldTertiary(op, call, ty);
+		case OpCodeClass::Quaternary:
+			return (op == OpCode::Bfi) ? FoldBfi(call, ty) : nullptr;
+		case OpCodeClass::Dot2:
+			return FoldDot(2, call, ty);
+		case OpCodeClass::Dot3:
+			return FoldDot(3, call, ty);
+		case OpCodeClass::Dot4:
+			return FoldDot(4, call, ty);
+
+		default:
+			return FoldLegacy(op, call, ty);
+		}
+	}
+
+	uint32_t FoldDxilConstants(LLVMModule& module)
+	{
+		// Reversed, so popping from the back visits calls in program order
+		std::vector<CallInst*> worklist;
+		for (auto& func : module)
+		{
+			for (auto& bb : *func)
+			{
+				for (auto& inst : *bb)
+				{
+					auto call = dyn_cast<CallInst>(inst.get());
+					if (call)
+					{
+						worklist.push_back(call);
+					}
+				}
+			}
+		}
+		std::reverse(worklist.begin(), worklist.end());
+
+		std::unordered_set<Instruction*> folded;
+		while (!worklist.empty())
+		{
+			auto call = worklist.back();
+			worklist.pop_back();
+			if (folded.find(call) != folded.end())
+			{
+				continue;
+			}
+
+			auto c = ConstantFoldDxilCall(*call);
+			if (c)
+			{
+				// Users that couldn't be folded before may be foldable once this call becomes a constant
+				for (auto user : call->Users())
+				{
+					auto user_call = dyn_cast<CallInst>(user);
+					if (user_call)
+					{
+						worklist.push_back(user_call);
+					}
+				}
+
+				call->ReplaceAllUsesWith(c);
+				folded.insert(call);
+			}
+		}
+
+		if (!folded.empty())
+		{
+			for (auto& func : module)
+			{
+				for (auto& bb : *func)
+				{
+					bb->InstList().remove_if([&folded](std::unique_ptr<Instruction> const & inst)
+						{
+							return folded.find(inst.get()) != folded.end();
+						});
+				}
+			}
+		}
+
+		return static_cast<uint32_t>(folded.size());
+	}
+}
@@ -33,8 +33,25 @@
  */
 
 #include <Dilithium/dxc/HLSL/DxilContainer.hpp>
+#include <Dilithium/dxc/HLSL/DxilPipelineStateValidation.hpp>
+#include <Dilithium/dxc/HLSL/DxilRootSignature.hpp>
 
 #include <cstddef>
+#include <cstring>
+
+namespace
+{
+	using namespace Dilithium;
+
+	static_assert(sizeof(DxilStaticSamplerDesc) == 52, "DxilStaticSamplerDesc doesn't match the serialized layout");
+
+	// Whether count elements of elem_size bytes, starting at offset, fit in size bytes. Computed in 64-bit so
+	// that hostile counts can't wrap around.
+	bool RangeFits(uint32_t offset, uint32_t count, size_t elem_size, size_t size)
+	{
+		return static_cast<uint64_t>(offset) + static_cast<uint64_t>(count) * elem_size <= size;
+	}
+}
 
 namespace Dilithium
 {
@@ -145,4 +162,147 @@ namespace Dilithium
 			&& (length >= (header->SizeInUint32 * sizeof(uint32_t)))
 			&& IsValidDxilBitcodeHeader(&header->BitcodeHeader, length - offsetof(DxilProgramHeader, BitcodeHeader));
 	}
+
+	DxilContainerReader::DxilContainerReader()
+		: header_(nullptr)
+	{
+	}
+
+	bool DxilContainerReader::Load(void const * ptr, size_t length)
+	{
+		this->Clear();
+
+		auto header = IsDxilContainerLike(ptr, length);
+		if (!IsValidDxilContainer(header, length))
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < header->PartCount; ++ i)
+		{
+			auto part = GetDxilContainerPart(header, i);
+			if (!this->FindPart(part->PartFourCC))
+			{
+				parts_.emplace_back(part->PartFourCC, part);
+			}
+		}
+		header_ = header;
+		return true;
+	}
+
+	void DxilContainerReader::Clear()
+	{
+		header_ = nullptr;
+		parts_.clear();
+	}
+
+	DxilPartHeader const * DxilContainerReader::FindPart(uint32_t four_cc) const
+	{
+		for (auto const & part : parts_)
+		{
+			if (part.first == four_cc)
+			{
+				return part.second;
+			}
+		}
+		return nullptr;
+	}
+
+	ArrayRef<uint8_t> DxilContainerReader::GetPartData(uint32_t four_cc) const
+	{
+		auto part = this->FindPart(four_cc);
+		if (!part)
+		{
+			return ArrayRef<uint8_t>();
+		}
+		return ArrayRef<uint8_t>(reinterpret_cast<uint8_t const *>(GetDxilPartData(part)), part->PartSize);
+	}
+
+	DxilProgramHeader const * DxilContainerReader::GetProgramHeader(uint32_t four_cc) const
+	{
+		BOOST_ASSERT((four_cc == DFCC_DXIL) || (four_cc == DFCC_ShaderDebugInfoDXIL));
+
+		auto data = this->GetPartData(four_cc);
+		auto header = reinterpret_cast<DxilProgramHeader const *>(data.data());
+		if (data.empty() || !IsValidDxilProgramHeader(header, static_cast<uint32_t>(data.size())))
+		{
+			return nullptr;
+		}
+		return header;
+	}
+
+	DxilProgramSignature const * DxilContainerReader::GetSignature(uint32_t four_cc) const
+	{
+		BOOST_ASSERT((four_cc == DFCC_InputSignature) || (four_cc == DFCC_OutputSignature)
+			|| (four_cc == DFCC_PatchConstantSignature));
+
+		auto data = this->GetPartData(four_cc);
+		if (data.size() < sizeof(DxilProgramSignature))
+		{
+			return nullptr;
+		}
+
+		auto signature = reinterpret_cast<DxilProgramSignature const *>(data.data());
+		if (!RangeFits(signature->ParamOffset, signature->ParamCount, sizeof(DxilProgramSignatureElement), data.size()))
+		{
+			return nullptr;
+		}
+
+		auto elements = reinterpret_cast<DxilProgramSignatureElement const *>(data.data() + signature->ParamOffset);
+		for (uint32_t i = 0; i < signature->ParamCount; ++ i)
+		{
+			// The semantic name has to be a null-terminated string inside the part
+			uint32_t const name_offset = elements[i].SemanticName;
+			if ((name_offset >= data.size())
+				|| !memchr(data.data() + name_offset, '\0', data.size() - name_offset))
+			{
+				return nullptr;
+			}
+		}
+		return signature;
+	}
+
+	DxilShaderFeatureInfo const * DxilContainerReader::GetFeatureInfo() const
+	{
+		auto data = this->GetPartData(DFCC_FeatureInfo);
+		if (data.size() < sizeof(DxilShaderFeatureInfo))
+		{
+			return nullptr;
+		}
+		return reinterpret_cast<DxilShaderFeatureInfo const *>(data.data());
+	}
+
+	PSVRuntimeInfo0 const * DxilContainerReader::GetPSVRuntimeInfo() const
+	{
+		// The part starts with the size of the runtime info, which grows with new versions
+		auto data = this->GetPartData(DFCC_PipelineStateValidation);
+		if (data.size() < sizeof(uint32_t) + sizeof(PSVRuntimeInfo0))
+		{
+			return nullptr;
+		}
+		uint32_t info_size;
+		memcpy(&info_size, data.data(), sizeof(info_size));
+		if ((info_size < sizeof(PSVRuntimeInfo0)) || !RangeFits(sizeof(uint32_t), 1, info_size, data.size()))
+		{
+			return nullptr;
+		}
+		return reinterpret_cast<PSVRuntimeInfo0 const *>(data.data() + sizeof(uint32_t));
+	}
+
+	DxilContainerRootSignatureDesc const * DxilContainerReader::GetRootSignature() const
+	{
+		auto data = this->GetPartData(DFCC_RootSignature);
+		if (data.size() < sizeof(DxilContainerRootSignatureDesc))
+		{
+			return nullptr;
+		}
+
+		auto desc = reinterpret_cast<DxilContainerRootSignatureDesc const *>(data.data());
+		if (!RangeFits(desc->RootParametersOffset, desc->NumParameters, sizeof(DxilContainerRootParameter), data.size())
+			|| !RangeFits(desc->StaticSamplersOffset, desc->NumStaticSamplers, sizeof(DxilStaticSamplerDesc), data.size()))
+		{
+			return nullptr;
+		}
+		return desc;
+	}
 }
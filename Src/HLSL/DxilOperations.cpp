@@ -36,12 +36,14 @@
 #include <Dilithium/dxc/HLSL/DxilOperations.hpp>
 
 #include <Dilithium/ArrayRef.hpp>
+#include <Dilithium/DerivedType.hpp>
 #include <Dilithium/LLVMContext.hpp>
 #include <Dilithium/LLVMModule.hpp>
 #include <Dilithium/Type.hpp>
 #include <Dilithium/Constants.hpp>
 #include <Dilithium/Instructions.hpp>
 
+#include <algorithm>
 #include <iterator>
 
 #include <boost/assert.hpp>
@@ -298,6 +300,18 @@ namespace Dilithium
 		return op_code_props_[static_cast<uint32_t>(op)].op_code_name;
 	}
 
+	OpCodeClass OP::GetOpCodeClass(OpCode op)
+	{
+		BOOST_ASSERT_MSG(op < OpCode::NumOpCodes, "Invalid opcode");
+		return op_code_props_[static_cast<uint32_t>(op)].op_code_class;
+	}
+
+	Attribute::AttrKind OP::GetFunctionAttribute(OpCode op)
+	{
+		BOOST_ASSERT_MSG(op < OpCode::NumOpCodes, "Invalid opcode");
+		return op_code_props_[static_cast<uint32_t>(op)].func_attr;
+	}
+
 	bool OP::IsDxilOpFunc(Function const * func)
 	{
 		std::string_view name = func->Name();
@@ -309,4 +323,231 @@ namespace Dilithium
 	{
 		static_assert(std::size(OP::op_code_props_) == static_cast<size_t>(OpCode::NumOpCodes), "forgot to update OP::op_code_props_");
 	}
+
+
+	namespace
+	{
+		// Same order as OpCodeProperty::allow_overload
+		char const * const overload_type_names[] = { "void", "f16", "f32", "f64", "i1", "i8", "i16", "i32", "i64" };
+
+		Type* OverloadType(LLVMContext& context, uint32_t index)
+		{
+			switch (index)
+			{
+			case 0:
+				return Type::VoidType(context);
+			case 1:
+				return Type::HalfType(context);
+			case 2:
+				return Type::FloatType(context);
+			case 3:
+				return Type::DoubleType(context);
+			case 4:
+				return Type::Int1Type(context);
+			case 5:
+				return Type::Int8Type(context);
+			case 6:
+				return Type::Int16Type(context);
+			case 7:
+				return Type::Int32Type(context);
+			case 8:
+				return Type::Int64Type(context);
+
+			default:
+				DILITHIUM_UNREACHABLE("Invalid overload index");
+			}
+		}
+
+		uint32_t OverloadIndex(Type* ty)
+		{
+			switch (ty->GetTypeId())
+			{
+			case Type::TID_Void:
+				return 0;
+			case Type::TID_Half:
+				return 1;
+			case Type::TID_Float:
+				return 2;
+			case Type::TID_Double:
+				return 3;
+			case Type::TID_Integer:
+				switch (ty->IntegerBitWidth())
+				{
+				case 1:
+					return 4;
+				case 8:
+					return 5;
+				case 16:
+					return 6;
+				case 32:
+					return 7;
+				case 64:
+					return 8;
+				default:
+					break;
+				}
+				break;
+
+			default:
+				break;
+			}
+			return static_cast<uint32_t>(std::size(overload_type_names));
+		}
+	}
+
+	DxilPrelude::DxilPrelude(LLVMContext& context)
+		: context_(context),
+			handle_ty_(nullptr), dimensions_ty_(nullptr), sample_pos_ty_(nullptr),
+			split_double_ty_(nullptr), two_i32_ty_(nullptr), i32_carry_ty_(nullptr)
+	{
+		std::fill(std::begin(res_ret_tys_), std::end(res_ret_tys_), nullptr);
+		std::fill(std::begin(cbuf_ret_tys_), std::end(cbuf_ret_tys_), nullptr);
+
+		Type* i1_ty = Type::Int1Type(context);
+		Type* i32_ty = Type::Int32Type(context);
+		Type* f32_ty = Type::FloatType(context);
+
+		handle_ty_ = this->CreateStructType("dx.types.Handle", { Type::Int8PtrType(context) });
+
+		op_code_constants_.resize(static_cast<uint32_t>(OpCode::NumOpCodes));
+		for (auto const & prop : OP::op_code_props_)
+		{
+			op_code_constants_[static_cast<uint32_t>(prop.op_code)]
+				= ConstantInt::Get(cast<IntegerType>(i32_ty), static_cast<uint32_t>(prop.op_code));
+
+			switch (prop.op_code_class)
+			{
+			case OpCodeClass::Sample:
+			case OpCodeClass::SampleBias:
+			case OpCodeClass::SampleCmp:
+			case OpCodeClass::SampleCmpLevelZero:
+			case OpCodeClass::SampleGrad:
+			case OpCodeClass::SampleLevel:
+			case OpCodeClass::TextureGather:
+			case OpCodeClass::TextureGatherCmp:
+			case OpCodeClass::TextureLoad:
+			case OpCodeClass::BufferLoad:
+				// 4 components + status
+				for (uint32_t i = 1; i < OP::NumTypeOverloads; ++ i)
+				{
+					if (prop.allow_overload[i] && !res_ret_tys_[i])
+					{
+						Type* ty = OverloadType(context, i);
+						res_ret_tys_[i] = this->CreateStructType(std::string("dx.types.ResRet.") + overload_type_names[i],
+							{ ty, ty, ty, ty, i32_ty });
+					}
+				}
+				break;
+
+			case OpCodeClass::CBufferLoadLegacy:
+				// One 16-byte row. 16-bit values are min precision, they take a 32-bit slot each.
+				for (uint32_t i = 1; i < OP::NumTypeOverloads; ++ i)
+				{
+					if (prop.allow_overload[i] && !cbuf_ret_tys_[i])
+					{
+						Type* ty = OverloadType(context, i);
+						std::vector<Type*> elems((ty->PrimitiveSizeInBits() == 64) ? 2 : 4, ty);
+						cbuf_ret_tys_[i] = this->CreateStructType(std::string("dx.types.CBufRet.") + overload_type_names[i],
+							elems);
+					}
+				}
+				break;
+
+			case OpCodeClass::GetDimensions:
+				if (!dimensions_ty_)
+				{
+					dimensions_ty_ = this->CreateStructType("dx.types.Dimensions", { i32_ty, i32_ty, i32_ty, i32_ty });
+				}
+				break;
+
+			case OpCodeClass::RenderTargetGetSamplePosition:
+			case OpCodeClass::Texture2DMSGetSamplePosition:
+				if (!sample_pos_ty_)
+				{
+					sample_pos_ty_ = this->CreateStructType("dx.types.SamplePos", { f32_ty, f32_ty });
+				}
+				break;
+
+			case OpCodeClass::SplitDouble:
+				if (!split_double_ty_)
+				{
+					split_double_ty_ = this->CreateStructType("dx.types.splitdouble", { i32_ty, i32_ty });
+				}
+				break;
+
+			case OpCodeClass::BinaryWithTwoOuts:
+				if (!two_i32_ty_)
+				{
+					two_i32_ty_ = this->CreateStructType("dx.types.twoi32", { i32_ty, i32_ty });
+				}
+				break;
+
+			case OpCodeClass::BinaryWithCarry:
+				if (!i32_carry_ty_)
+				{
+					i32_carry_ty_ = this->CreateStructType("dx.types.i32c", { i32_ty, i1_ty });
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		Attribute::AttrKind const read_none[] = { Attribute::AK_NoUnwind, Attribute::AK_ReadNone };
+		Attribute::AttrKind const read_only[] = { Attribute::AK_NoUnwind, Attribute::AK_ReadOnly };
+		Attribute::AttrKind const none[] = { Attribute::AK_NoUnwind };
+		read_none_attrs_ = AttributeSet::Get(context, AttributeSet::AI_FunctionIndex, read_none);
+		read_only_attrs_ = AttributeSet::Get(context, AttributeSet::AI_FunctionIndex, read_only);
+		no_attrs_ = AttributeSet::Get(context, AttributeSet::AI_FunctionIndex, none);
+	}
+
+	StructType* DxilPrelude::ResRetType(Type* overload) const
+	{
+		uint32_t const index = OverloadIndex(overload);
+		return index < std::size(res_ret_tys_) ? res_ret_tys_[index] : nullptr;
+	}
+
+	StructType* DxilPrelude::CBufRetType(Type* overload) const
+	{
+		uint32_t const index = OverloadIndex(overload);
+		return index < std::size(cbuf_ret_tys_) ? cbuf_ret_tys_[index] : nullptr;
+	}
+
+	AttributeSet DxilPrelude::OpFunctionAttributes(OpCode op) const
+	{
+		switch (OP::op_code_props_[static_cast<uint32_t>(op)].func_attr)
+		{
+		case Attribute::AK_ReadNone:
+			return read_none_attrs_;
+		case Attribute::AK_ReadOnly:
+			return read_only_attrs_;
+		default:
+			return no_attrs_;
+		}
+	}
+
+	StructType* DxilPrelude::FindStructType(std::string_view name, ArrayRef<Type*> elements, bool is_packed) const
+	{
+		for (auto st : struct_types_)
+		{
+			if (st->Name() == name)
+			{
+				if ((st->IsPacked() == is_packed)
+					&& std::equal(st->ElementBegin(), st->ElementEnd(), elements.begin(), elements.end()))
+				{
+					return st;
+				}
+				break;
+			}
+		}
+		return nullptr;
+	}
+
+	StructType* DxilPrelude::CreateStructType(std::string_view name, ArrayRef<Type*> elements)
+	{
+		auto st = StructType::Create(context_, elements, name);
+		struct_types_.push_back(st);
+		return st;
+	}
 }
@@ -45,23 +45,27 @@ namespace Dilithium
 
 	DxilStructAnnotation* DxilTypeSystem::AddStructAnnotation(StructType const * struct_type)
 	{
-		DILITHIUM_UNUSED(struct_type);
+		BOOST_ASSERT(struct_annotations_.find(struct_type) == struct_annotations_.end());
 
-		DILITHIUM_NOT_IMPLEMENTED;
+		auto anno = std::make_unique<DxilStructAnnotation>();
+		auto ret = anno.get();
+		struct_annotations_[struct_type] = std::move(anno);
+		ret->struct_type_ = struct_type;
+		ret->field_annotations_.resize(struct_type->NumElements());
+		ret->cbuffer_size_ = 0;
+		return ret;
 	}
 
 	DxilStructAnnotation* DxilTypeSystem::GetStructAnnotation(StructType const * struct_type)
 	{
-		DILITHIUM_UNUSED(struct_type);
-
-		DILITHIUM_NOT_IMPLEMENTED;
+		auto iter = struct_annotations_.find(struct_type);
+		return (iter != struct_annotations_.end()) ? iter->second.get() : nullptr;
 	}
 
 	void DxilTypeSystem::EraseStructAnnotation(StructType const * struct_type)
 	{
-		DILITHIUM_UNUSED(struct_type);
-
-		DILITHIUM_NOT_IMPLEMENTED;
+		BOOST_ASSERT(struct_annotations_.find(struct_type) != struct_annotations_.end());
+		struct_annotations_.erase(struct_type);
 	}
 
 	DxilFunctionAnnotation* DxilTypeSystem::AddFunctionAnnotation(Function const * function)
@@ -76,84 +80,72 @@ namespace Dilithium
 		return ret;
 	}
 
-	DxilFunctionAnnotation* GetFunctionAnnotation(Function const * function)
+	DxilFunctionAnnotation* DxilTypeSystem::GetFunctionAnnotation(Function const * function)
 	{
-		DILITHIUM_UNUSED(function);
-
-		DILITHIUM_NOT_IMPLEMENTED;
+		auto iter = function_annotations_.find(function);
+		return (iter != function_annotations_.end()) ? iter->second.get() : nullptr;
 	}
 
-	void EraseFunctionAnnotation(Function* const function)
+	void DxilTypeSystem::EraseFunctionAnnotation(Function* const function)
 	{
-		DILITHIUM_UNUSED(function);
-
-		DILITHIUM_NOT_IMPLEMENTED;
+		BOOST_ASSERT(function_annotations_.find(function) != function_annotations_.end());
+		function_annotations_.erase(function);
 	}
 
 
 	uint32_t DxilStructAnnotation::NumFields() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		return static_cast<uint32_t>(field_annotations_.size());
 	}
 
 	DxilFieldAnnotation& DxilStructAnnotation::FieldAnnotation(uint32_t index)
 	{
-		DILITHIUM_UNUSED(index);
-
-		DILITHIUM_NOT_IMPLEMENTED;
+		return field_annotations_[index];
 	}
 
 	DxilFieldAnnotation const & DxilStructAnnotation::FieldAnnotation(uint32_t index) const
 	{
-		DILITHIUM_UNUSED(index);
-
-		DILITHIUM_NOT_IMPLEMENTED;
+		return field_annotations_[index];
 	}
 
 	StructType const * DxilStructAnnotation::GetStructType() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		return struct_type_;
 	}
 
 	uint32_t DxilStructAnnotation::CBufferSize() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		return cbuffer_size_;
 	}
 
 	void DxilStructAnnotation::CBufferSize(uint32_t size)
 	{
-		DILITHIUM_UNUSED(size);
-
-		DILITHIUM_NOT_IMPLEMENTED;
+		cbuffer_size_ = size;
 	}
 
 	void DxilStructAnnotation::MarkEmptyStruct()
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		field_annotations_.clear();
 	}
 
 	bool DxilStructAnnotation::IsEmptyStruct()
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		return field_annotations_.empty();
 	}
 
 
 	DxilParameterAnnotation& DxilFunctionAnnotation::ParameterAnnotation(uint32_t index)
 	{
-		DILITHIUM_UNUSED(index);
-
-		DILITHIUM_NOT_IMPLEMENTED;
+		return parameter_annotations_[index];
 	}
 
 	DxilParameterAnnotation const & DxilFunctionAnnotation::ParameterAnnotation(uint32_t index) const
 	{
-		DILITHIUM_UNUSED(index);
-
-		DILITHIUM_NOT_IMPLEMENTED;
+		return parameter_annotations_[index];
 	}
 
 	Function const * DxilFunctionAnnotation::GetFunction() const
 	{
-		DILITHIUM_NOT_IMPLEMENTED;
+		return function_;
 	}
 }
@@ -35,6 +35,79 @@
 #include <Dilithium/Dilithium.hpp>
 #include <Dilithium/Half.hpp>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define DILITHIUM_HALF_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace
+{
+	using namespace Dilithium;
+
+	static_assert(sizeof(half) == sizeof(uint16_t), "half is expected to be 16 bits");
+
+#ifdef DILITHIUM_HALF_SSE2
+	__m128i Select(__m128i mask, __m128i a, __m128i b)
+	{
+		return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+	}
+
+	// Same steps as half::half(float) on 4 lanes, the result in the low 16 bits of each
+	__m128i FloatToHalf4(__m128i i)
+	{
+		__m128i const s = _mm_and_si128(_mm_srai_epi32(i, 16), _mm_set1_epi32(0x00008000));
+		__m128i const e = _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(i, 23), _mm_set1_epi32(0x000000FF)),
+			_mm_set1_epi32(127 - 15));
+		__m128i m = _mm_and_si128(i, _mm_set1_epi32(0x007FFFFF));
+
+		// Denormalized half. SSE2 has no per-lane shift, so (m | 0x00800000) >> (1 - e) is done as an exact
+		// multiply by 2^(e - 1) in float and a truncation.
+		__m128 const scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(e, _mm_set1_epi32(127 - 1)), 23));
+		__m128i dm = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_or_si128(m, _mm_set1_epi32(0x00800000))), scale));
+		dm = _mm_add_epi32(dm, _mm_slli_epi32(_mm_and_si128(dm, _mm_set1_epi32(0x00001000)), 1));
+		__m128i ret_denorm = _mm_or_si128(s, _mm_srli_epi32(dm, 13));
+		ret_denorm = Select(_mm_cmplt_epi32(e, _mm_set1_epi32(-10)), s, ret_denorm);
+
+		// Normalized half, infinity and NaN
+		__m128i const is_inf_nan = _mm_cmpeq_epi32(e, _mm_set1_epi32(0xFF - (127 - 15)));
+		m = _mm_add_epi32(m, _mm_andnot_si128(is_inf_nan, _mm_slli_epi32(_mm_and_si128(m, _mm_set1_epi32(0x00001000)), 1)));
+		// Overflow in significand, adjust exponent
+		__m128i ne = _mm_add_epi32(e, _mm_srli_epi32(m, 23));
+		m = _mm_and_si128(m, _mm_set1_epi32(0x007FFFFF));
+		ne = Select(is_inf_nan, _mm_set1_epi32(31), ne);
+		__m128i const ret_norm = _mm_or_si128(_mm_or_si128(s, _mm_slli_epi32(ne, 10)), _mm_srli_epi32(m, 13));
+
+		return Select(_mm_cmpgt_epi32(e, _mm_setzero_si128()), ret_norm, ret_denorm);
+	}
+
+	// Same as half::operator float() on 4 lanes
+	__m128 HalfToFloat4(__m128i h)
+	{
+		__m128i const exp_mask = _mm_set1_epi32(0x7C00 << 13);
+		__m128i o = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7FFF)), 13);
+		__m128i const exp = _mm_and_si128(o, exp_mask);
+		o = _mm_add_epi32(o, _mm_set1_epi32((127 - 15) << 23));
+
+		// Infinity and NaN
+		o = _mm_add_epi32(o, _mm_and_si128(_mm_cmpeq_epi32(exp, exp_mask), _mm_set1_epi32((128 - 16) << 23)));
+
+		// Zero and denormalized, renormalized by an exact float subtraction
+		__m128 const renorm = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(o, _mm_set1_epi32(1 << 23))),
+			_mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+		o = Select(_mm_cmpeq_epi32(exp, _mm_setzero_si128()), _mm_castps_si128(renorm), o);
+
+		o = _mm_or_si128(o, _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16));
+		return _mm_castsi128_ps(o);
+	}
+
+	// Keeps the low 16 bits of each lane, so the saturating pack truncates
+	__m128i Low16(__m128i v)
+	{
+		return _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+	}
+#endif
+}
+
 namespace Dilithium
 {
 	half::half(float f) noexcept
@@ -55,7 +128,8 @@ namespace Dilithium
 		{
 			if (e < -10)
 			{
-				value_ = 0;
+				// Too small for a denormalized half, a zero with the sign of f
+				value_ = static_cast<uint16_t>(s);
 			}
 			else
 			{
@@ -103,7 +177,12 @@ namespace Dilithium
 
 		if (0 == e)
 		{
-			if (m != 0)
+			if (0 == m)
+			{
+				// Zero
+				e = -(127 - 15);
+			}
+			else
 			{
 				// Denormalized number -- renormalize it
 
@@ -121,11 +200,8 @@ namespace Dilithium
 		{
 			if (31 == e)
 			{
-				if (m != 0)
-				{
-					// Nan -- preserve sign and significand bits
-					e = 0xFF - (127 - 15);
-				}
+				// Infinity, or Nan -- preserve sign and significand bits
+				e = 0xFF - (127 - 15);
 			}
 		}
 
@@ -222,4 +298,39 @@ namespace Dilithium
 	{
 		return value_ == rhs.value_;
 	}
+
+
+	void ConvertFloatToHalf(ArrayRef<float> src, half* dst) noexcept
+	{
+		size_t i = 0;
+#ifdef DILITHIUM_HALF_SSE2
+		for (; i + 8 <= src.size(); i += 8)
+		{
+			__m128i const lo = FloatToHalf4(_mm_castps_si128(_mm_loadu_ps(&src[i])));
+			__m128i const hi = FloatToHalf4(_mm_castps_si128(_mm_loadu_ps(&src[i + 4])));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(Low16(lo), Low16(hi)));
+		}
+#endif
+		for (; i < src.size(); ++ i)
+		{
+			dst[i] = half(src[i]);
+		}
+	}
+
+	void ConvertHalfToFloat(ArrayRef<half> src, float* dst) noexcept
+	{
+		size_t i = 0;
+#ifdef DILITHIUM_HALF_SSE2
+		for (; i + 8 <= src.size(); i += 8)
+		{
+			__m128i const h = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&src[i]));
+			_mm_storeu_ps(dst + i, HalfToFloat4(_mm_unpacklo_epi16(h, _mm_setzero_si128())));
+			_mm_storeu_ps(dst + i + 4, HalfToFloat4(_mm_unpackhi_epi16(h, _mm_setzero_si128())));
+		}
+#endif
+		for (; i < src.size(); ++ i)
+		{
+			dst[i] = src[i];
+		}
+	}
 }
@@ -34,6 +34,7 @@
 
 #include <Dilithium/Dilithium.hpp>
 #include <Dilithium/Instruction.hpp>
+#include <Dilithium/Instructions.hpp>
 #include <Dilithium/LLVMContext.hpp>
 #include <Dilithium/Type.hpp>
 #include <Dilithium/SymbolTableList.hpp>
@@ -98,6 +99,35 @@ namespace Dilithium
 		}
 	}
 
+	Instruction* Instruction::Clone() const
+	{
+		Instruction* new_inst;
+		switch (this->Opcode())
+		{
+		case Ret:
+			new_inst = cast<ReturnInst>(this)->CloneImpl();
+			break;
+		case Call:
+			new_inst = cast<CallInst>(this)->CloneImpl();
+			break;
+
+		default:
+			DILITHIUM_UNREACHABLE("Invalid instruction type!");
+		}
+
+		if (this->HasMetadata())
+		{
+			boost::container::small_vector<std::pair<uint32_t, MDNode*>, 4> mds;
+			this->GetAllMetadata(mds);
+			for (auto const & md : mds)
+			{
+				new_inst->SetMetadata(md.first, md.second);
+			}
+		}
+
+		return new_inst;
+	}
+
 	char const  *Instruction::OpcodeName() const
 	{
 		switch (this->Opcode())
@@ -303,22 +333,55 @@ namespace Dilithium
 		parent_ = parent;
 	}
 
-	MDNode* Instruction::GetMetadataImpl(uint32_t kind_id) const
+	void Instruction::SetMetadata(uint32_t kind_id, MDNode* node)
 	{
-		// Handle 'dbg' as a special case since it is not stored in the hash table.
-		if (kind_id == LLVMContext::MD_Dbg)
+		if (!node && !this->HasMetadata())
+		{
+			return;
+		}
+
+		if (node)
 		{
-			DILITHIUM_NOT_IMPLEMENTED;
+			if (!this->HasMetadataHashEntry())
+			{
+				BOOST_ASSERT_MSG(!metadata_ || metadata_->empty(), "HasMetadata bit is wonked");
+				if (!metadata_)
+				{
+					metadata_ = std::make_unique<MDAttachmentMap>();
+				}
+				this->HasMetadataHashEntry(true);
+			}
+			metadata_->Set(kind_id, *node);
+			return;
 		}
 
+		// Otherwise, we're removing metadata
+		BOOST_ASSERT_MSG(metadata_, "HasMetadata bit out of date!");
+		metadata_->Erase(kind_id);
+		if (metadata_->empty())
+		{
+			this->HasMetadataHashEntry(false);
+		}
+	}
+
+	void Instruction::SetMetadata(std::string_view kind, MDNode* node)
+	{
+		if (!node && !this->HasMetadata())
+		{
+			return;
+		}
+		this->SetMetadata(this->Context().MdKindId(kind), node);
+	}
+
+	MDNode* Instruction::GetMetadataImpl(uint32_t kind_id) const
+	{
 		if (!this->HasMetadataHashEntry())
 		{
 			return nullptr;
 		}
-		auto& info = this->Context().Impl().instruction_metadata[this];
-		BOOST_ASSERT_MSG(!info.empty(), "bit out of sync with hash table");
+		BOOST_ASSERT_MSG(metadata_ && !metadata_->empty(), "bit out of sync with attachments");
 
-		return info.Lookup(kind_id);
+		return metadata_->Lookup(kind_id);
 	}
 
 	MDNode* Instruction::GetMetadataImpl(std::string_view kind) const
@@ -329,17 +392,15 @@ namespace Dilithium
 	void Instruction::GetAllMetadataImpl(boost::container::small_vector_base<std::pair<uint32_t, MDNode*>>& result) const
 	{
 		result.clear();
-		BOOST_ASSERT_MSG(this->HasMetadataHashEntry() && this->Context().Impl().instruction_metadata.count(this),
-			"Shouldn't have called this");
-		const auto &Info = this->Context().Impl().instruction_metadata.find(this)->second;
-		BOOST_ASSERT_MSG(!Info.empty(), "Shouldn't have called this");
-		Info.GetAll(result);
+		BOOST_ASSERT_MSG(this->HasMetadataHashEntry() && metadata_, "Shouldn't have called this");
+		BOOST_ASSERT_MSG(!metadata_->empty(), "Shouldn't have called this");
+		metadata_->GetAll(result);
 	}
 
 	void Instruction::ClearMetadataHashEntries()
 	{
 		BOOST_ASSERT_MSG(this->HasMetadataHashEntry(), "Caller should check");
-		this->Context().Impl().instruction_metadata.erase(this);
+		metadata_.reset();
 		this->HasMetadataHashEntry(false);
 	}
 }
@@ -77,6 +77,11 @@ namespace Dilithium
 	{
 	}
 
+	ReturnInst* ReturnInst::CloneImpl() const
+	{
+		return new ReturnInst(*this);
+	}
+
 	ReturnInst* ReturnInst::Create(LLVMContext& context, Value* ret_val, Instruction* insert_before)
 	{
 		return new ReturnInst(context, ret_val, insert_before);
@@ -141,6 +146,11 @@ namespace Dilithium
 	{
 	}
 
+	CallInst* CallInst::CloneImpl() const
+	{
+		return new CallInst(*this);
+	}
+
 	void CallInst::Init(Value* func, ArrayRef<Value*> args, std::string_view name)
 	{
 		this->Init(cast<FunctionType>(cast<PointerType>(func->GetType())->ElementType()), func, args, name);
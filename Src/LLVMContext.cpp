@@ -33,11 +33,41 @@
  */
 
 #include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
 #include <Dilithium/Util.hpp>
+#include <Dilithium/dxc/HLSL/DxilOperations.hpp>
 #include "LLVMContextImpl.hpp"
 
 #include <boost/assert.hpp>
 
+namespace
+{
+	using namespace Dilithium;
+
+	// Nodes carry a next link and the cached hash, the bucket array one pointer per bucket
+	template <typename Map>
+	size_t HashMapBytes(Map const & map)
+	{
+		return map.size() * (sizeof(typename Map::value_type) + sizeof(void*) * 2) + map.bucket_count() * sizeof(void*);
+	}
+
+	template <typename T, typename Func>
+	MemoryUsage UniquingSetUsage(char const * name, ShardedUniquingSet<T> const & set, Func&& elem_bytes)
+	{
+		MemoryUsage ret = { name, set.size(), set.AllocatedBytes() };
+		set.ForEach([&ret, &elem_bytes](T const * elem)
+			{
+				ret.bytes += elem_bytes(elem);
+			});
+		return ret;
+	}
+
+	size_t TypeBytes(Type const * ty, size_t size)
+	{
+		return size + ty->NumContainedTypes() * sizeof(Type*);
+	}
+}
+
 namespace Dilithium
 {
 	LLVMContext::LLVMContext()
@@ -107,13 +137,335 @@ namespace Dilithium
 	{
 	}
 
+	bool LLVMContext::ConcurrentUniquing() const
+	{
+		return impl_->concurrent_uniquing;
+	}
+
+	void LLVMContext::ConcurrentUniquing(bool enable)
+	{
+		impl_->concurrent_uniquing = enable;
+	}
+
+	DxilPrelude const & LLVMContext::GetDxilPrelude()
+	{
+		std::call_once(impl_->dxil_prelude_once, [this]
+			{
+				impl_->dxil_prelude.reset(new DxilPrelude(*this));
+			});
+		return *impl_->dxil_prelude;
+	}
+
+	bool LLVMContext::HasDxilPrelude() const
+	{
+		return impl_->dxil_prelude != nullptr;
+	}
+
+	void LLVMContext::Compact()
+	{
+		auto& impl = *impl_;
+
+		MetadataAsValue::DeleteUnused(*this);
+
+		// Mark the metadata reachable from the live modules and the remaining metadata operands
+		std::unordered_set<Metadata const *> reachable;
+		std::vector<Metadata const *> worklist;
+		auto mark = [&reachable, &worklist](Metadata const * md)
+		{
+			if (md && reachable.insert(md).second)
+			{
+				worklist.push_back(md);
+			}
+		};
+
+		boost::container::small_vector<std::pair<uint32_t, MDNode*>, 4> mds;
+		for (auto mod : impl.modules)
+		{
+			for (auto const & nmd : mod->NamedMetadata())
+			{
+				for (uint32_t i = 0; i < nmd->NumOperands(); ++ i)
+				{
+					mark(nmd->Operand(i));
+				}
+			}
+			for (auto const & func : *mod)
+			{
+				for (auto const & bb : *func)
+				{
+					for (auto const & inst : *bb)
+					{
+						if (inst->HasMetadata())
+						{
+							mds.clear();
+							inst->GetAllMetadata(mds);
+							for (auto const & md : mds)
+							{
+								mark(md.second);
+							}
+						}
+					}
+				}
+			}
+		}
+		for (auto const & attachments : impl.function_metadata)
+		{
+			mds.clear();
+			attachments.second.GetAll(mds);
+			for (auto const & md : mds)
+			{
+				mark(md.second);
+			}
+		}
+		for (auto const & mav : impl.metadata_as_values)
+		{
+			mark(mav.first);
+		}
+		// Unresolved nodes are still waiting for their forward references, they and their operands are kept
+#define HANDLE_MDNODE_LEAF(CLASS)						\
+		impl.CLASS##s.ForEach([&mark](CLASS* node)		\
+			{											\
+				if (!node->IsResolved())				\
+				{										\
+					mark(node);							\
+				}										\
+			});
+#include "Dilithium/Metadata.inc"
+		for (auto node : impl.distinct_md_nodes)
+		{
+			if (!node->IsResolved())
+			{
+				mark(node);
+			}
+		}
+		while (!worklist.empty())
+		{
+			auto node = dyn_cast<MDNode>(worklist.back());
+			worklist.pop_back();
+			if (node)
+			{
+				for (auto const & op : node->Operands())
+				{
+					mark(op.Get());
+				}
+			}
+		}
+
+		MDNode::DeleteUnreachable(*this, reachable);
+
+		std::vector<MDString*> dead_strings;
+		impl.md_string_cache.ForEach([&reachable, &dead_strings](MDString* mds)
+			{
+				if (reachable.find(mds) == reachable.end())
+				{
+					dead_strings.push_back(mds);
+				}
+			});
+		for (auto mds : dead_strings)
+		{
+			impl.md_string_cache.Erase(false, mds->Hash(), mds);
+			delete mds;
+		}
+
+		// Dropping the nodes released their references to the constant wrappers
+		ValueAsMetadata::DeleteUnusedConstants(*this);
+
+		// The prelude hands out its opcode constants without a use
+		std::unordered_set<ConstantInt const *> pinned;
+		if (impl.dxil_prelude)
+		{
+			for (uint32_t i = 0; i < static_cast<uint32_t>(OpCode::NumOpCodes); ++ i)
+			{
+				pinned.insert(impl.dxil_prelude->OpCodeConstant(static_cast<OpCode>(i)));
+			}
+		}
+		pinned.insert(impl.the_true_val);
+		pinned.insert(impl.the_false_val);
+
+		std::vector<ConstantInt*> dead_ints;
+		impl.int_constants.ForEach([&pinned, &dead_ints](ConstantInt* ci)
+			{
+				if (ci->UseEmpty() && !ci->IsUsedByMetadata() && (pinned.find(ci) == pinned.end()))
+				{
+					dead_ints.push_back(ci);
+				}
+			});
+		for (auto ci : dead_ints)
+		{
+			auto slot = impl.SmallIntConstantSlot(ci->GetValue());
+			if (slot)
+			{
+				slot->store(nullptr, std::memory_order_relaxed);
+			}
+			impl.int_constants.Erase(false, std::hash<MPInt>()(ci->GetValue()), ci);
+			delete ci;
+		}
+
+		std::vector<ConstantFP*> dead_fps;
+		impl.fp_constants.ForEach([&dead_fps](ConstantFP* cfp)
+			{
+				if (cfp->UseEmpty() && !cfp->IsUsedByMetadata())
+				{
+					dead_fps.push_back(cfp);
+				}
+			});
+		for (auto cfp : dead_fps)
+		{
+			impl.fp_constants.Erase(false, std::hash<MPInt>()(cfp->GetValueMPF().BitcastToMPInt()), cfp);
+			delete cfp;
+		}
+
+		for (auto iter = impl.uv_constants.begin(); iter != impl.uv_constants.end();)
+		{
+			auto uv = iter->second;
+			if (uv->UseEmpty() && !uv->IsUsedByMetadata())
+			{
+				iter = impl.uv_constants.erase(iter);
+				delete uv;
+			}
+			else
+			{
+				++ iter;
+			}
+		}
+
+		impl.int_constants.ShrinkToFit();
+		impl.fp_constants.ShrinkToFit();
+		impl.md_string_cache.ShrinkToFit();
+#define HANDLE_MDNODE_LEAF(CLASS) impl.CLASS##s.ShrinkToFit();
+#include "Dilithium/Metadata.inc"
+		impl.distinct_md_nodes.rehash(0);
+		impl.uv_constants.rehash(0);
+		impl.values_as_metadata.rehash(0);
+		impl.metadata_as_values.rehash(0);
+	}
+
+	void LLVMContext::MemoryStats(std::vector<MemoryUsage>& stats) const
+	{
+		auto const & impl = *impl_;
+
+		{
+			MemoryUsage usage = { "IntegerTypes", impl.integer_types.size(), HashMapBytes(impl.integer_types) };
+			usage.bytes += usage.count * sizeof(IntegerType);
+			stats.push_back(usage);
+		}
+		stats.push_back(UniquingSetUsage("FunctionTypes", impl.function_types, [](FunctionType const * ty)
+			{
+				return TypeBytes(ty, sizeof(FunctionType));
+			}));
+		{
+			MemoryUsage usage = UniquingSetUsage("StructTypes", impl.anon_struct_types, [](StructType const * ty)
+				{
+					return TypeBytes(ty, sizeof(StructType));
+				});
+			usage.count += impl.identified_struct_types.size();
+			usage.bytes += impl.identified_struct_types.capacity() * sizeof(impl.identified_struct_types[0]);
+			for (auto const & ty : impl.identified_struct_types)
+			{
+				usage.bytes += TypeBytes(ty.get(), sizeof(StructType));
+			}
+			usage.bytes += HashMapBytes(impl.named_struct_types);
+			for (auto const & name : impl.named_struct_types)
+			{
+				usage.bytes += name.first.capacity();
+			}
+			stats.push_back(usage);
+		}
+		{
+			MemoryUsage usage = { "ArrayTypes", impl.array_types.size(), HashMapBytes(impl.array_types) };
+			usage.bytes += usage.count * (sizeof(ArrayType) + sizeof(Type*));
+			stats.push_back(usage);
+		}
+		{
+			MemoryUsage usage = { "VectorTypes", impl.vector_types.size(), HashMapBytes(impl.vector_types) };
+			usage.bytes += usage.count * (sizeof(VectorType) + sizeof(Type*));
+			stats.push_back(usage);
+		}
+		{
+			MemoryUsage usage = { "PointerTypes", impl.pointer_types.size() + impl.as_pointer_types.size(),
+				HashMapBytes(impl.pointer_types) + HashMapBytes(impl.as_pointer_types) };
+			usage.bytes += usage.count * (sizeof(PointerType) + sizeof(Type*));
+			stats.push_back(usage);
+		}
+
+		{
+			MemoryUsage usage = UniquingSetUsage("ConstantInts", impl.int_constants, [](ConstantInt const *)
+				{
+					return sizeof(ConstantInt);
+				});
+			usage.bytes += sizeof(impl.small_int_constants);
+			stats.push_back(usage);
+		}
+		stats.push_back(UniquingSetUsage("ConstantFPs", impl.fp_constants, [](ConstantFP const *)
+			{
+				return sizeof(ConstantFP);
+			}));
+		{
+			MemoryUsage usage = { "UndefValues", impl.uv_constants.size(), HashMapBytes(impl.uv_constants) };
+			usage.bytes += usage.count * sizeof(UndefValue);
+			stats.push_back(usage);
+		}
+
+		stats.push_back(UniquingSetUsage("Attributes", impl.attrs_set, [](AttributeImpl const *)
+			{
+				return sizeof(AttributeImpl);
+			}));
+		stats.push_back(UniquingSetUsage("AttributeSetNodes", impl.attrs_set_nodes, [](AttributeSetNode const * node)
+			{
+				return sizeof(AttributeSetNode) + (node->end() - node->begin()) * sizeof(Attribute);
+			}));
+		stats.push_back(UniquingSetUsage("AttributeSets", impl.attrs_lists, [](AttributeSetImpl const * attrs)
+			{
+				return sizeof(AttributeSetImpl) + attrs->NumAttributes() * sizeof(AttributeSetImpl::IndexAttrPair);
+			}));
+
+		stats.push_back(UniquingSetUsage("MDStrings", impl.md_string_cache, [](MDString const * mds)
+			{
+				return sizeof(MDString) + mds->String().size();
+			}));
+#define HANDLE_MDNODE_LEAF(CLASS)																\
+		stats.push_back(UniquingSetUsage(#CLASS "s", impl.CLASS##s, [](CLASS const * node)	\
+			{																					\
+				return sizeof(CLASS) + node->NumOperands() * sizeof(MDOperand);					\
+			}));
+#include "Dilithium/Metadata.inc"
+		{
+			MemoryUsage usage = { "DistinctMDNodes", impl.distinct_md_nodes.size(), HashMapBytes(impl.distinct_md_nodes) };
+			for (auto node : impl.distinct_md_nodes)
+			{
+				usage.bytes += sizeof(MDTuple) + node->NumOperands() * sizeof(MDOperand);
+			}
+			stats.push_back(usage);
+		}
+		{
+			MemoryUsage usage = { "ValuesAsMetadata", impl.values_as_metadata.size(), HashMapBytes(impl.values_as_metadata) };
+			usage.bytes += usage.count * sizeof(LocalAsMetadata);
+			stats.push_back(usage);
+		}
+		{
+			MemoryUsage usage = { "MetadataAsValues", impl.metadata_as_values.size(), HashMapBytes(impl.metadata_as_values) };
+			usage.bytes += usage.count * sizeof(MetadataAsValue);
+			stats.push_back(usage);
+		}
+		{
+			MemoryUsage usage = { "FunctionMetadata", 0, HashMapBytes(impl.function_metadata) };
+			for (auto const & attachments : impl.function_metadata)
+			{
+				usage.count += attachments.second.size();
+				usage.bytes += attachments.second.size() * sizeof(std::pair<uint32_t, TrackingMDNodeRef>);
+			}
+			stats.push_back(usage);
+		}
+	}
+
 	uint32_t LLVMContext::MdKindId(std::string_view name) const
 	{
+		auto lock = impl_->ConcurrentLock(impl_->custom_md_kind_names_mutex);
 		return impl_->custom_md_kind_names.emplace(name, static_cast<uint32_t>(impl_->custom_md_kind_names.size())).first->second;
 	}
 
 	void LLVMContext::MdKindNames(boost::container::small_vector_base<std::string_view>& names) const
 	{
+		auto lock = impl_->ConcurrentLock(impl_->custom_md_kind_names_mutex);
 		names.resize(impl_->custom_md_kind_names.size());
 		for (auto iter = impl_->custom_md_kind_names.begin(), end_iter = impl_->custom_md_kind_names.end(); iter != end_iter; ++ iter)
 		{
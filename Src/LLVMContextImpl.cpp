@@ -35,6 +35,9 @@
 #include "LLVMContextImpl.hpp"
 #include <Dilithium/LLVMContext.hpp>
 #include <Dilithium/Util.hpp>
+#include <Dilithium/dxc/HLSL/DxilOperations.hpp>
+
+#include <tuple>
 
 namespace Dilithium
 {
@@ -50,6 +53,33 @@ namespace Dilithium
 		return nullptr;
 	}
 
+	void MDAttachmentMap::Set(uint32_t id, MDNode& md)
+	{
+		for (auto& att : attachments_)
+		{
+			if (att.first == id)
+			{
+				att.second.Reset(&md);
+				return;
+			}
+		}
+
+		attachments_.emplace_back(std::piecewise_construct, std::make_tuple(id), std::make_tuple(&md));
+	}
+
+	void MDAttachmentMap::Erase(uint32_t id)
+	{
+		for (auto iter = attachments_.begin(); iter != attachments_.end(); ++ iter)
+		{
+			if (iter->first == id)
+			{
+				*iter = std::move(attachments_.back());
+				attachments_.pop_back();
+				return;
+			}
+		}
+	}
+
 	void MDAttachmentMap::GetAll(boost::container::small_vector_base<std::pair<uint32_t, MDNode*>>& result) const
 	{
 		result.insert(result.end(), attachments_.begin(), attachments_.end());
@@ -63,7 +93,8 @@ namespace Dilithium
 
 
 	LLVMContextImpl::LLVMContextImpl(LLVMContext& context)
-		: the_true_val(nullptr), the_false_val(nullptr),
+		: concurrent_uniquing(false),
+			the_true_val(nullptr), the_false_val(nullptr),
 			void_ty(context, Type::TID_Void),
 			label_ty(context, Type::TID_Label),
 			half_ty(context, Type::TID_Half),
@@ -76,19 +107,97 @@ namespace Dilithium
 			int32_ty(context, 32),
 			int64_ty(context, 64)
 	{
+		for (auto& per_width : small_int_constants)
+		{
+			for (auto& ci : per_width)
+			{
+				ci.store(nullptr, std::memory_order_relaxed);
+			}
+		}
+
 		named_struct_types_unique_id = 0;
 	}
 
 	LLVMContextImpl::~LLVMContextImpl()
 	{
-		for (auto& v : int_constants)
-		{
-			delete v.second;
-		}
+		dxil_prelude.reset();
+
+		int_constants.ForEach([](ConstantInt* c)
+			{
+				delete c;
+			});
 		int_constants.clear();
 
-		attrs_set.clear();
+		fp_constants.ForEach([](ConstantFP* c)
+			{
+				delete c;
+			});
+		fp_constants.clear();
+
+		attrs_lists.ForEach([](AttributeSetImpl* attrs)
+			{
+				delete attrs;
+			});
 		attrs_lists.clear();
+		attrs_set_nodes.ForEach([](AttributeSetNode* node)
+			{
+				delete node;
+			});
 		attrs_set_nodes.clear();
+		attrs_set.ForEach([](AttributeImpl* attr)
+			{
+				delete attr;
+			});
+		attrs_set.clear();
+
+		md_string_cache.ForEach([](MDString* mds)
+			{
+				delete mds;
+			});
+		md_string_cache.clear();
+
+		function_types.ForEach([](FunctionType* ft)
+			{
+				delete ft;
+			});
+		function_types.clear();
+		anon_struct_types.ForEach([](StructType* st)
+			{
+				delete st;
+			});
+		anon_struct_types.clear();
+	}
+
+	std::atomic<ConstantInt*>* LLVMContextImpl::SmallIntConstantSlot(MPInt const & v)
+	{
+		uint32_t width_index;
+		switch (v.BitWidth())
+		{
+		case 1:
+			width_index = 0;
+			break;
+		case 8:
+			width_index = 1;
+			break;
+		case 16:
+			width_index = 2;
+			break;
+		case 32:
+			width_index = 3;
+			break;
+		case 64:
+			width_index = 4;
+			break;
+
+		default:
+			return nullptr;
+		}
+
+		int64_t const sv = v.SExtValue();
+		if ((sv < SmallIntMin) || (sv > SmallIntMax))
+		{
+			return nullptr;
+		}
+		return &small_int_constants[width_index][sv - SmallIntMin];
 	}
 }
@@ -42,8 +42,11 @@
 #include <Dilithium/MPInt.hpp>
 #include <Dilithium/TrackingMDRef.hpp>
 #include "AttributeImpl.hpp"
+#include "UniquingSet.hpp"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -53,10 +56,11 @@ namespace Dilithium
 {
 	class ConstantInt;
 	class ConstantFP;
+	class DxilPrelude;
 	class LLVMContext;
+	class LLVMModule;
 	class Type;
 	class Value;
-	class ValueHandleBase;
 
 	class MDAttachmentMap
 	{
@@ -94,21 +98,56 @@ namespace Dilithium
 		explicit LLVMContextImpl(LLVMContext& context);
 		~LLVMContextImpl();
 
-		std::unordered_map<MPInt, ConstantInt*> int_constants;
+		// Guards the tables below when the context is shared between threads
+		bool concurrent_uniquing;
 
-		std::unordered_map<uint64_t, std::unique_ptr<AttributeImpl>> attrs_set;
-		std::unordered_map<uint64_t, std::unique_ptr<AttributeSetImpl>> attrs_lists;
-		std::unordered_map<uint64_t, std::unique_ptr<AttributeSetNode>> attrs_set_nodes;
+		// Locks mutex only in concurrent mode
+		std::unique_lock<std::mutex> ConcurrentLock(std::mutex& mutex)
+		{
+			std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+			if (concurrent_uniquing)
+			{
+				lock.lock();
+			}
+			return lock;
+		}
 
-		std::unordered_map<uint64_t, std::unique_ptr<MDString>> md_string_cache;
+		// Owned, freed in the destructor
+		ShardedUniquingSet<ConstantInt> int_constants;
+		// Direct-indexed front of int_constants for small i1/i8/i16/i32/i64 values, by width then value - SmallIntMin.
+		// Racing writers store the same uniqued constant into an entry. LLVMContext::Compact resets the entries of the
+		// constants it frees, but it runs while no other thread uses the context.
+		static int64_t constexpr SmallIntMin = -128;
+		static int64_t constexpr SmallIntMax = 1023;
+		static uint32_t constexpr NumSmallIntWidths = 5;
+		std::atomic<ConstantInt*> small_int_constants[NumSmallIntWidths][SmallIntMax - SmallIntMin + 1];
+		// nullptr if v is out of the cached range
+		std::atomic<ConstantInt*>* SmallIntConstantSlot(MPInt const & v);
+		// Owned, freed in the destructor
+		ShardedUniquingSet<ConstantFP> fp_constants;
+
+		// Owned, freed in the destructor
+		ShardedUniquingSet<AttributeImpl> attrs_set;
+		ShardedUniquingSet<AttributeSetImpl> attrs_lists;
+		ShardedUniquingSet<AttributeSetNode> attrs_set_nodes;
+
+		// Owned, freed in the destructor
+		ShardedUniquingSet<MDString> md_string_cache;
+		// Guards values_as_metadata and metadata_as_values
+		std::mutex md_wrappers_mutex;
 		std::unordered_map<Value*, ValueAsMetadata*> values_as_metadata;
 		std::unordered_map<Metadata*, MetadataAsValue*> metadata_as_values;
 
-#define HANDLE_MDNODE_LEAF(CLASS) std::unordered_map<uint64_t, CLASS*> CLASS##s;
+#define HANDLE_MDNODE_LEAF(CLASS) ShardedUniquingSet<CLASS> CLASS##s;
 #include "Dilithium/Metadata.inc"
 
+		std::mutex distinct_md_nodes_mutex;
 		std::unordered_set<MDNode*> distinct_md_nodes;
 
+		// The use lists of ValueAsMetadata and unresolved nodes
+		std::mutex md_tracking_mutex;
+
+		std::mutex uv_constants_mutex;
 		std::unordered_map<Type*, UndefValue*> uv_constants;
 
 		ConstantInt* the_true_val;
@@ -117,26 +156,35 @@ namespace Dilithium
 		Type void_ty, label_ty, half_ty, float_ty, double_ty, metadata_ty;
 		IntegerType int1_ty, int8_ty, int16_ty, int32_ty, int64_ty;
 
+		std::mutex integer_types_mutex;
 		std::unordered_map<uint32_t, std::unique_ptr<IntegerType>> integer_types;
-		std::unordered_map<uint64_t, std::unique_ptr<FunctionType>> function_types;
-		std::unordered_map<uint64_t, std::unique_ptr<StructType>> anon_struct_types;
-		std::unordered_map<std::string, std::unique_ptr<StructType>> named_struct_types;
+		// Owned, freed in the destructor
+		ShardedUniquingSet<FunctionType> function_types;
+		ShardedUniquingSet<StructType> anon_struct_types;
+		// Guards identified_struct_types and named_struct_types
+		std::mutex struct_types_mutex;
+		std::vector<std::unique_ptr<StructType>> identified_struct_types;
+		std::unordered_map<std::string, StructType*> named_struct_types;
 		uint32_t named_struct_types_unique_id;
 
+		// Live modules on this context, the roots of LLVMContext::Compact
+		std::mutex modules_mutex;
+		std::unordered_set<LLVMModule*> modules;
+
+		std::once_flag dxil_prelude_once;
+		std::unique_ptr<DxilPrelude> dxil_prelude;
+
+		// Guards the array, vector and pointer types
+		std::mutex sequential_types_mutex;
 		std::unordered_map<std::pair<Type*, uint64_t>, std::unique_ptr<ArrayType>> array_types;
 		std::unordered_map<std::pair<Type*, uint32_t>, std::unique_ptr<VectorType>> vector_types;
 		std::unordered_map<Type*, std::unique_ptr<PointerType>> pointer_types;  // Pointers in addrress space = 0
 		std::unordered_map<std::pair<Type*, uint32_t>, std::unique_ptr<PointerType>> as_pointer_types;
 
-		// This map keeps track of all of the value handles that are watching a Value*
-		std::unordered_map<Value*, ValueHandleBase*> value_handles;
-
 		// Metadata string to ID mapping
+		std::mutex custom_md_kind_names_mutex;
 		std::unordered_map<std::string, uint32_t> custom_md_kind_names;
 
-		// Collection of per-instruction metadata used in this context.
-		std::unordered_map<Instruction const *, MDAttachmentMap> instruction_metadata;
-
 		// Collection of per-function metadata used in this context.
 		std::unordered_map<Function const *, MDAttachmentMap> function_metadata;
 
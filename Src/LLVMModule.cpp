@@ -35,20 +35,302 @@
 #include <Dilithium/Dilithium.hpp>
 #include <Dilithium/LLVMModule.hpp>
 
+#include <Dilithium/DerivedType.hpp>
 #include <Dilithium/GVMaterializer.hpp>
+#include <Dilithium/Instructions.hpp>
 #include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/SymbolTableList.hpp>
+#include <Dilithium/TrackingMDRef.hpp>
+#include <Dilithium/ValueHandle.hpp>
 
 #include <Dilithium/dxc/HLSL/DxilModule.hpp>
+#include "LLVMContextImpl.hpp"
+
+#include <unordered_map>
+
+#include <boost/container/small_vector.hpp>
+
+namespace
+{
+	using namespace Dilithium;
+
+	// Types, constants and metadata strings are uniqued in the LLVMContext, so they are shared between the source module and
+	// the clone. Only global values, function bodies and the metadata nodes referencing them need to be copied.
+	class ModuleCloner
+	{
+	public:
+		ModuleCloner(LLVMModule const & src, LLVMModule& dst)
+			: src_(src), dst_(dst)
+		{
+			size_t num_values = 0;
+			for (auto const & func : src_)
+			{
+				++ num_values;
+				num_values += func->GetFunctionType()->NumParams();
+				for (auto const & bb : *func)
+				{
+					num_values += 1 + bb->size();
+				}
+			}
+			value_map_.reserve(num_values);
+		}
+
+		void Run()
+		{
+			for (auto const & func : src_)
+			{
+				this->CloneFunctionDecl(*func);
+			}
+			for (auto const & func : src_)
+			{
+				this->CloneFunctionBody(*func);
+			}
+
+			for (auto const & nmd : src_.NamedMetadata())
+			{
+				auto new_nmd = dst_.GetOrInsertNamedMetadata(nmd->GetName());
+				for (uint32_t i = 0; i < nmd->NumOperands(); ++ i)
+				{
+					new_nmd->AddOperand(cast<MDNode>(this->MapMetadata(nmd->Operand(i))));
+				}
+			}
+		}
+
+	private:
+		void CloneFunctionDecl(Function const & func)
+		{
+			auto new_func = Function::Create(func.GetFunctionType(), func.Linkage(), func.Name(), &dst_);
+			new_func->Visibility(func.Visibility());
+			new_func->DLLStorageClass(func.DLLStorageClass());
+			new_func->UnnamedAddr(func.HasUnnamedAddr());
+			new_func->SetCallingConv(func.GetCallingConv());
+			new_func->SetAttributes(func.GetAttributes());
+			new_func->SetAlignment(func.GetAlignment());
+			if (func.HasSection())
+			{
+				new_func->SetSection(func.GetSection());
+			}
+
+			value_map_.emplace(&func, new_func);
+
+			auto new_arg_iter = new_func->ArgBegin();
+			for (auto arg_iter = func.ArgBegin(); arg_iter != func.ArgEnd(); ++ arg_iter, ++ new_arg_iter)
+			{
+				(*new_arg_iter)->Name((*arg_iter)->Name());
+				value_map_.emplace(arg_iter->get(), new_arg_iter->get());
+			}
+		}
+
+		void CloneFunctionBody(Function const & func)
+		{
+			auto new_func = cast<Function>(value_map_[&func]);
+
+			if (func.HasPersonalityFn())
+			{
+				new_func->SetPersonalityFn(cast<Constant>(this->MapValue(func.GetPersonalityFn())));
+			}
+			if (func.HasPrefixData())
+			{
+				new_func->SetPrefixData(cast<Constant>(this->MapValue(func.GetPrefixData())));
+			}
+			if (func.HasPrologueData())
+			{
+				new_func->SetPrologueData(cast<Constant>(this->MapValue(func.GetPrologueData())));
+			}
+
+			auto& context = dst_.Context();
+			boost::container::small_vector<Instruction*, 64> new_insts;
+			for (auto const & bb : func)
+			{
+				auto new_bb = BasicBlock::Create(context, bb->Name(), new_func);
+				value_map_.emplace(bb.get(), new_bb);
+
+				for (auto const & inst : *bb)
+				{
+					auto new_inst = inst->Clone();
+					new_bb->InstList().push_back(std::unique_ptr<Instruction>(new_inst));
+					AddToSymbolTableList(new_inst, new_bb);
+					new_inst->Name(inst->Name());
+
+					value_map_.emplace(inst.get(), new_inst);
+					new_insts.push_back(new_inst);
+				}
+			}
+
+			// Operands can refer to instructions that come later in the function, so they are remapped in a second pass.
+			boost::container::small_vector<std::pair<uint32_t, MDNode*>, 4> mds;
+			for (auto new_inst : new_insts)
+			{
+				for (auto& op : new_inst->Operands())
+				{
+					auto new_val = this->MapValue(op.Get());
+					if (new_val != op.Get())
+					{
+						op.Set(new_val);
+					}
+				}
+
+				if (new_inst->HasMetadata())
+				{
+					new_inst->GetAllMetadata(mds);
+					for (auto const & md : mds)
+					{
+						new_inst->SetMetadata(md.first, cast<MDNode>(this->MapMetadata(md.second)));
+					}
+				}
+			}
+
+			if (func.HasMetadata())
+			{
+				func.GetAllMetadata(mds);
+				for (auto const & md : mds)
+				{
+					new_func->SetMetadata(md.first, cast<MDNode>(this->MapMetadata(md.second)));
+				}
+			}
+		}
+
+		Value* MapValue(Value* val)
+		{
+			if (!val)
+			{
+				return nullptr;
+			}
+
+			auto iter = value_map_.find(val);
+			if (iter != value_map_.end())
+			{
+				return iter->second;
+			}
+
+			auto mav = dyn_cast<MetadataAsValue>(val);
+			if (mav)
+			{
+				auto new_md = this->MapMetadata(mav->GetMetadata());
+				if (new_md != mav->GetMetadata())
+				{
+					return MetadataAsValue::Get(dst_.Context(), new_md);
+				}
+			}
+
+			// The global values are all in value_map_. Constant expressions and aggregates of global values can't be
+			// created in Dilithium yet, so the remaining constants are shared with the source module as they are.
+			BOOST_ASSERT_MSG(!isa<Constant>(val) || !RefersToGlobalValue(cast<Constant>(val)),
+				"Cloning constants that refer to global values is not supported");
+			return val;
+		}
+
+		static bool RefersToGlobalValue(Constant const * c)
+		{
+			if (isa<GlobalValue>(c))
+			{
+				return true;
+			}
+			for (auto const & op : c->Operands())
+			{
+				if (RefersToGlobalValue(cast<Constant>(op.Get())))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		Metadata* MapMetadata(Metadata* md)
+		{
+			if (!md)
+			{
+				return nullptr;
+			}
+
+			auto iter = md_map_.find(md);
+			if (iter != md_map_.end())
+			{
+				return iter->second;
+			}
+
+			Metadata* new_md = md;
+			auto vam = dyn_cast<ValueAsMetadata>(md);
+			if (vam)
+			{
+				auto new_val = this->MapValue(vam->GetValue());
+				if (new_val != vam->GetValue())
+				{
+					new_md = ValueAsMetadata::Get(new_val);
+				}
+			}
+			else
+			{
+				auto node = dyn_cast<MDNode>(md);
+				if (node)
+				{
+					if (node->IsDistinct())
+					{
+						// Cycles can only go through distinct nodes. The clone is created with the old operands and
+						// mapped before visiting them, so a cycle ends at it. The operands are replaced afterwards.
+						auto& context = dst_.Context();
+						boost::container::small_vector<Metadata*, 8> ops(node->OpBegin(), node->OpEnd());
+						auto new_node = MDNode::GetDistinct(context, ops);
+						md_map_[md] = new_node;
+
+						for (uint32_t i = 0; i < node->NumOperands(); ++ i)
+						{
+							auto new_op = this->MapMetadata(node->Operand(i).Get());
+							if (new_op != ops[i])
+							{
+								new_node->ReplaceOperandWith(i, new_op);
+							}
+						}
+						return new_node;
+					}
+
+					boost::container::small_vector<Metadata*, 8> ops;
+					bool changed = false;
+					for (auto const & op : node->Operands())
+					{
+						auto new_op = this->MapMetadata(op.Get());
+						changed |= (new_op != op.Get());
+						ops.push_back(new_op);
+					}
+					if (changed)
+					{
+						new_md = MDNode::Get(dst_.Context(), ops);
+					}
+				}
+			}
+
+			md_map_[md] = new_md;
+			return new_md;
+		}
+
+	private:
+		LLVMModule const & src_;
+		LLVMModule& dst_;
+
+		std::unordered_map<Value const *, Value*> value_map_;
+		std::unordered_map<Metadata const *, Metadata*> md_map_;
+	};
+}
 
 namespace Dilithium
 {
 	LLVMModule::LLVMModule(std::string const & name, std::shared_ptr<LLVMContext> const & context)
 		: context_(context), name_(name), data_layout_("")
 	{
+		auto& impl = context_->Impl();
+		std::lock_guard<std::mutex> lock(impl.modules_mutex);
+		impl.modules.insert(this);
 	}
 
 	LLVMModule::~LLVMModule()
 	{
+		{
+			auto& impl = context_->Impl();
+			std::lock_guard<std::mutex> lock(impl.modules_mutex);
+			impl.modules.erase(this);
+		}
+
+
 		//this->ResetDxilModule();
 		this->DropAllReferences();
 		function_list_.clear();
@@ -57,6 +339,25 @@ namespace Dilithium
 		//DILITHIUM_NOT_IMPLEMENTED;
 	}
 
+	std::unique_ptr<LLVMModule> LLVMModule::Clone() const
+	{
+		BOOST_ASSERT_MSG(!materializer_, "Materialize the module before cloning it");
+
+		auto mod = std::make_unique<LLVMModule>(name_, context_);
+		mod->SetDataLayout(data_layout_);
+		mod->SetTargetTriple(target_triple_);
+
+		ModuleCloner cloner(*this, *mod);
+		cloner.Run();
+
+		if (this->HasDxilModule())
+		{
+			mod->GetOrCreateDxilModule();
+		}
+
+		return mod;
+	}
+
 	void LLVMModule::SetDataLayout(std::string_view desc)
 	{
 		data_layout_.Reset(std::string(desc));
@@ -103,6 +404,87 @@ namespace Dilithium
 		return nmd_ptr;
 	}
 
+	void LLVMModule::MemoryStats(std::vector<MemoryUsage>& stats) const
+	{
+		// Each std::list node holds a unique_ptr and two links
+		size_t constexpr list_node_bytes = sizeof(void*) * 3;
+
+		MemoryUsage funcs = { "Functions", 0, 0 };
+		MemoryUsage args = { "Arguments", 0, 0 };
+		MemoryUsage bbs = { "BasicBlocks", 0, 0 };
+		MemoryUsage insts = { "Instructions", 0, 0 };
+		MemoryUsage uses = { "Uses", 0, 0 };
+		MemoryUsage handles = { "ValueHandles", 0, 0 };
+		MemoryUsage inst_mds = { "InstructionMetadata", 0, 0 };
+		MemoryUsage named_mds = { "NamedMetadata", 0, 0 };
+
+		auto count_handles = [&handles](Value const & v)
+		{
+			handles.count += v.NumValueHandles();
+		};
+
+		boost::container::small_vector<std::pair<uint32_t, MDNode*>, 4> mds;
+		for (auto const & func : function_list_)
+		{
+			++ funcs.count;
+			funcs.bytes += sizeof(Function) + list_node_bytes + func->Name().size();
+			count_handles(*func);
+
+			for (auto const & arg : func->ArgumentList())
+			{
+				++ args.count;
+				args.bytes += sizeof(Argument) + list_node_bytes + arg->Name().size();
+				count_handles(*arg);
+			}
+
+			for (auto const & bb : *func)
+			{
+				++ bbs.count;
+				bbs.bytes += sizeof(BasicBlock) + list_node_bytes + bb->Name().size();
+				count_handles(*bb);
+
+				for (auto const & inst : *bb)
+				{
+					++ insts.count;
+					insts.bytes += sizeof(Instruction) + list_node_bytes + inst->Name().size();
+					count_handles(*inst);
+
+					// Plus the sentinel
+					uses.count += inst->NumOperands();
+					uses.bytes += (inst->NumOperands() + 1) * sizeof(Use);
+
+					if (inst->HasMetadata())
+					{
+						mds.clear();
+						inst->GetAllMetadata(mds);
+						inst_mds.count += mds.size();
+						inst_mds.bytes += mds.size() * sizeof(std::pair<uint32_t, TrackingMDNodeRef>);
+					}
+				}
+			}
+		}
+		handles.bytes = handles.count * sizeof(WeakVH);
+
+		for (auto const & nmd : named_md_list_)
+		{
+			++ named_mds.count;
+			named_mds.bytes += sizeof(NamedMDNode) + list_node_bytes + nmd->GetName().size();
+			if (nmd->NumOperands() > 4)
+			{
+				named_mds.bytes += nmd->NumOperands() * sizeof(TrackingMDRef);
+			}
+		}
+
+		stats.push_back(funcs);
+		stats.push_back(args);
+		stats.push_back(bbs);
+		stats.push_back(insts);
+		stats.push_back(uses);
+		stats.push_back(handles);
+		stats.push_back(inst_mds);
+		stats.push_back(named_mds);
+	}
+
 	void LLVMModule::Materializer(std::shared_ptr<GVMaterializer> const & gvm)
 	{
 		materializer_ = gvm;
@@ -0,0 +1,229 @@
+/**
+ * @file LoopInfo.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/LoopInfo.hpp>
+#include <Dilithium/CFG.hpp>
+#include <Dilithium/Dominators.hpp>
+
+namespace Dilithium
+{
+	Loop::Loop(BasicBlock const * header)
+		: parent_(nullptr), info_(nullptr)
+	{
+		blocks_.push_back(header);
+	}
+
+	uint32_t Loop::LoopDepth() const
+	{
+		uint32_t depth = 1;
+		for (auto l = parent_; l; l = l->parent_)
+		{
+			++ depth;
+		}
+		return depth;
+	}
+
+	bool Loop::Contains(Loop const * l) const
+	{
+		for (; l; l = l->parent_)
+		{
+			if (l == this)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool Loop::Contains(BasicBlock const * bb) const
+	{
+		return this->Contains(info_->LoopFor(bb));
+	}
+
+
+	LoopInfo::LoopInfo()
+		: func_(nullptr)
+	{
+	}
+
+	LoopInfo::LoopInfo(Function const & func, DominatorTreeBase const & dom_tree)
+		: LoopInfo()
+	{
+		this->Analyze(func, dom_tree);
+	}
+
+	void LoopInfo::Analyze(Function const & func, DominatorTreeBase const & dom_tree)
+	{
+		BOOST_ASSERT_MSG(!dom_tree.IsPostDominator() && (dom_tree.Parent() == &func), "Needs the dominator tree of func");
+
+		this->Clear();
+		func_ = &func;
+		bb_map_.assign(func.MaxBlockNumber(), nullptr);
+		if (func.empty())
+		{
+			return;
+		}
+
+		// Post-order walk of the dominator tree, so inner loops are discovered before the ones enclosing them
+		std::vector<BasicBlock const *> post_order;
+		{
+			std::vector<std::pair<BasicBlock const *, uint32_t>> stack;
+			stack.emplace_back(dom_tree.Roots().front(), 0);
+			while (!stack.empty())
+			{
+				auto const bb = stack.back().first;
+				auto const children = dom_tree.Children(bb);
+				uint32_t& next = stack.back().second;
+				if (next == children.size())
+				{
+					post_order.push_back(bb);
+					stack.pop_back();
+				}
+				else
+				{
+					auto const child = children[next];
+					++ next;
+					stack.emplace_back(child, 0);
+				}
+			}
+		}
+
+		std::vector<BasicBlock const *> worklist;
+		for (auto header : post_order)
+		{
+			worklist.clear();
+			for (auto pred : predecessors(header))
+			{
+				if (dom_tree.IsReachable(pred) && dom_tree.Dominates(header, pred))
+				{
+					worklist.push_back(pred);
+				}
+			}
+			if (worklist.empty())
+			{
+				continue;
+			}
+
+			loops_.emplace_back(new Loop(header));
+			Loop* loop = loops_.back().get();
+			loop->info_ = this;
+			bb_map_[header->Number()] = loop;
+
+			// Walk backward from the latches until the header. Blocks already claimed by an inner loop pull in that whole
+			// loop, and the walk continues from the inner header.
+			while (!worklist.empty())
+			{
+				auto const bb = worklist.back();
+				worklist.pop_back();
+
+				Loop* sub_loop = bb_map_[bb->Number()];
+				BasicBlock const * next_bb;
+				if (sub_loop)
+				{
+					while (sub_loop->parent_)
+					{
+						sub_loop = sub_loop->parent_;
+					}
+					if (sub_loop == loop)
+					{
+						continue;
+					}
+
+					sub_loop->parent_ = loop;
+					loop->sub_loops_.push_back(sub_loop);
+					next_bb = sub_loop->Header();
+				}
+				else
+				{
+					bb_map_[bb->Number()] = loop;
+					next_bb = bb;
+				}
+
+				for (auto pred : predecessors(next_bb))
+				{
+					if (dom_tree.IsReachable(pred))
+					{
+						worklist.push_back(pred);
+					}
+				}
+			}
+		}
+
+		for (auto const & loop : loops_)
+		{
+			if (!loop->parent_)
+			{
+				top_level_loops_.push_back(loop.get());
+			}
+		}
+
+		for (auto const & bb : func)
+		{
+			for (auto loop = bb_map_[bb->Number()]; loop; loop = loop->parent_)
+			{
+				if (loop->Header() != bb.get())
+				{
+					loop->blocks_.push_back(bb.get());
+				}
+			}
+		}
+	}
+
+	Loop* LoopInfo::LoopFor(BasicBlock const * bb) const
+	{
+		BOOST_ASSERT_MSG((bb->Parent() == func_) && (bb->Number() < bb_map_.size()), "Block is not analyzed");
+		return bb_map_[bb->Number()];
+	}
+
+	uint32_t LoopInfo::LoopDepth(BasicBlock const * bb) const
+	{
+		Loop const * loop = this->LoopFor(bb);
+		return loop ? loop->LoopDepth() : 0;
+	}
+
+	bool LoopInfo::IsLoopHeader(BasicBlock const * bb) const
+	{
+		Loop const * loop = this->LoopFor(bb);
+		return loop && (loop->Header() == bb);
+	}
+
+	void LoopInfo::Clear()
+	{
+		func_ = nullptr;
+		top_level_loops_.clear();
+		bb_map_.clear();
+		loops_.clear();
+	}
+}
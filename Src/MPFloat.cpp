@@ -36,6 +36,9 @@
 #include <Dilithium/MPFloat.hpp>
 #include <Dilithium/Hashing.hpp>
 
+#include <cmath>
+#include <limits>
+
 namespace Dilithium
 {
 	// Represents floating point arithmetic semantics.
@@ -76,7 +79,7 @@ namespace Dilithium
 			t.i |= negative ? 0x8000U : 0;
 			if (fill != nullptr)
 			{
-				t.i |= fill->RawData();
+				t.i |= fill->RawData()[0];
 			}
 			storage_.float_half = t.f;
 		}
@@ -91,7 +94,7 @@ namespace Dilithium
 			t.i |= negative ? 0x80000000U : 0;
 			if (fill != nullptr)
 			{
-				t.i |= fill->RawData();
+				t.i |= fill->RawData()[0];
 			}
 			storage_.float_single = t.f;
 		}
@@ -106,7 +109,7 @@ namespace Dilithium
 			t.i |= negative ? 0x8000000000000000ULL : 0;
 			if (fill != nullptr)
 			{
-				t.i |= fill->RawData();
+				t.i |= fill->RawData()[0];
 			}
 			storage_.float_double = t.f;
 		}
@@ -553,6 +556,7 @@ namespace Dilithium
 			*loses_info = li;
 		}
 
+		semantics_ = &to_semantics;
 		this->UpdateCategory();
 
 		return OS_OK;
@@ -590,19 +594,43 @@ namespace Dilithium
 
 	MPFloat::OpStatus MPFloat::ConvertFromMPInt(MPInt const & val, bool is_signed)
 	{
-		DILITHIUM_UNUSED(is_signed);
+		bool const negative = is_signed && val.IsNegative();
+		MPInt const magnitude = negative ? -val : val;
+
+		// The top 64 bits of the magnitude, with the bits shifted out folded into the lowest one. That bit is far below
+		// the rounding position of any of the formats, so rounding top gives the same result as rounding the magnitude.
+		uint32_t const active_bits = magnitude.ActiveBits();
+		uint32_t shift = 0;
+		uint64_t top;
+		if (active_bits <= 64)
+		{
+			top = magnitude.RawData()[0];
+		}
+		else
+		{
+			shift = active_bits - 64;
+			top = magnitude.LShr(shift).RawData()[0];
+			if (magnitude.LShr(shift).Shl(shift) != magnitude)
+			{
+				top |= 1;
+			}
+		}
 
 		if (semantics_ == &MPFloat::IEEEHalf)
 		{
-			storage_.float_half = half(static_cast<float>(val.RawData()));
+			// Beyond 16 bits the value rounds to infinity, below that the float is exact
+			float const f = (active_bits > 16) ? std::numeric_limits<float>::infinity() : static_cast<float>(top);
+			storage_.float_half = half(negative ? -f : f);
 		}
 		else if (semantics_ == &MPFloat::IEEESingle)
 		{
-			storage_.float_single = static_cast<float>(val.RawData());
+			float const f = std::ldexp(static_cast<float>(top), static_cast<int>(shift));
+			storage_.float_single = negative ? -f : f;
 		}
 		else if (semantics_ == &MPFloat::IEEEDouble)
 		{
-			storage_.float_double = static_cast<double>(val.RawData());
+			double const d = std::ldexp(static_cast<double>(top), static_cast<int>(shift));
+			storage_.float_double = negative ? -d : d;
 		}
 		else
 		{
@@ -794,7 +822,7 @@ namespace Dilithium
 				uint16_t i;
 				half f;
 			} t;
-			t.i = static_cast<uint16_t>(val.RawData());
+			t.i = static_cast<uint16_t>(val.RawData()[0]);
 			storage_.float_half = t.f;
 		}
 		else if (semantics_ == &MPFloat::IEEESingle)
@@ -804,7 +832,7 @@ namespace Dilithium
 				uint32_t i;
 				float f;
 			} t;
-			t.i = static_cast<uint32_t>(val.RawData());
+			t.i = static_cast<uint32_t>(val.RawData()[0]);
 			storage_.float_single = t.f;
 		}
 		else if (semantics_ == &MPFloat::IEEEDouble)
@@ -814,7 +842,7 @@ namespace Dilithium
 				uint64_t i;
 				double f;
 			} t;
-			t.i = val.RawData();
+			t.i = val.RawData()[0];
 			storage_.float_double = t.f;
 		}
 		else
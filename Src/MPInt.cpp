@@ -37,6 +37,9 @@
 #include <Dilithium/MathExtras.hpp>
 #include <Dilithium/SmallString.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace
 {
 	uint32_t Digit(char c_digit, uint8_t radix)
@@ -73,28 +76,134 @@ namespace
 
 		return 0xFFFFFFFFU;
 	}
+
+	// Divides the little endian words in place, returns the remainder
+	uint32_t DivideWordsBySmall(std::vector<uint64_t>& words, uint32_t divisor)
+	{
+		uint64_t rem = 0;
+		for (auto iter = words.rbegin(); iter != words.rend(); ++ iter)
+		{
+			uint64_t const hi = (rem << 32) | (*iter >> 32);
+			uint64_t const q_hi = hi / divisor;
+			rem = hi % divisor;
+			uint64_t const lo = (rem << 32) | (*iter & 0xFFFFFFFFU);
+			uint64_t const q_lo = lo / divisor;
+			rem = lo % divisor;
+			*iter = (q_hi << 32) | q_lo;
+		}
+		return static_cast<uint32_t>(rem);
+	}
 }
 
 namespace Dilithium 
 {
-	MPInt::MPInt(uint32_t num_bits, uint64_t val, bool is_signed)
-		: bit_width_(num_bits), val_(val)
+	MPInt::MPInt(uint32_t num_bits, ArrayRef<uint64_t> big_val)
+		: bit_width_(num_bits)
 	{
-		DILITHIUM_UNUSED(is_signed);
 		BOOST_ASSERT_MSG(bit_width_, "bitwidth too small");
+		uint32_t const num_words = this->NumWords();
+		uint32_t const num_copy = std::min(num_words, static_cast<uint32_t>(big_val.size()));
+		if (this->IsSingleWord())
+		{
+			val_ = (num_copy > 0) ? big_val[0] : 0;
+		}
+		else
+		{
+			p_val_ = new uint64_t[num_words];
+			std::copy(big_val.begin(), big_val.begin() + num_copy, p_val_);
+			std::fill(p_val_ + num_copy, p_val_ + num_words, 0);
+		}
 		this->ClearUnusedBits();
 	}
 
 	MPInt::MPInt(uint32_t num_bits, std::string_view str, uint8_t radix)
-		: val_(0), bit_width_(num_bits)
+		: bit_width_(num_bits)
 	{
 		BOOST_ASSERT_MSG(bit_width_, "Bitwidth too small");
+		if (this->IsSingleWord())
+		{
+			val_ = 0;
+		}
+		else
+		{
+			this->InitSlowCase(0, false);
+		}
 		this->FromString(num_bits, str, radix);
 	}
 
+	void MPInt::InitSlowCase(uint64_t val, bool is_signed)
+	{
+		uint32_t const num_words = this->NumWords();
+		p_val_ = new uint64_t[num_words];
+		p_val_[0] = val;
+		std::fill(p_val_ + 1, p_val_ + num_words, (is_signed && (static_cast<int64_t>(val) < 0)) ? UINT64_MAX : 0);
+		this->ClearUnusedBits();
+	}
+
+	void MPInt::InitSlowCase(MPInt const & rhs)
+	{
+		uint32_t const num_words = this->NumWords();
+		p_val_ = new uint64_t[num_words];
+		std::copy(rhs.p_val_, rhs.p_val_ + num_words, p_val_);
+	}
+
+	MPInt& MPInt::AssignSlowCase(MPInt const & rhs)
+	{
+		if (this == &rhs)
+		{
+			return *this;
+		}
+
+		if (this->NumWords() != rhs.NumWords())
+		{
+			if (!this->IsSingleWord())
+			{
+				delete[] p_val_;
+			}
+			bit_width_ = rhs.bit_width_;
+			if (this->IsSingleWord())
+			{
+				val_ = rhs.val_;
+			}
+			else
+			{
+				this->InitSlowCase(rhs);
+			}
+		}
+		else
+		{
+			bit_width_ = rhs.bit_width_;
+			if (this->IsSingleWord())
+			{
+				val_ = rhs.val_;
+			}
+			else
+			{
+				std::copy(rhs.p_val_, rhs.p_val_ + rhs.NumWords(), p_val_);
+			}
+		}
+		return *this;
+	}
+
+	MPInt& MPInt::AddAssignSlowCase(MPInt const & rhs)
+	{
+		uint64_t carry = 0;
+		for (uint32_t i = 0, e = this->NumWords(); i < e; ++ i)
+		{
+			uint64_t const sum = p_val_[i] + rhs.p_val_[i] + carry;
+			carry = (sum < p_val_[i]) || (carry && (sum == p_val_[i]));
+			p_val_[i] = sum;
+		}
+		return this->ClearUnusedBits();
+	}
+
 	bool MPInt::IsPowerOf2() const
 	{
-		return IsPowerOfTwo64(val_);
+		if (this->IsSingleWord())
+		{
+			return IsPowerOfTwo64(val_);
+		}
+		return this->CountPopulation() == 1;
 	}
 
 	MPInt MPInt::LowBitsSet(uint32_t num_bits, uint32_t lo_bits_set)
@@ -130,7 +239,15 @@ namespace Dilithium
 
 	void MPInt::Assign(uint64_t rhs)
 	{
-		val_ = rhs;
+		if (this->IsSingleWord())
+		{
+			val_ = rhs;
+		}
+		else
+		{
+			p_val_[0] = rhs;
+			std::fill(p_val_ + 1, p_val_ + this->NumWords(), 0);
+		}
 		this->ClearUnusedBits();
 	}
 
@@ -143,9 +260,22 @@ namespace Dilithium
 
 	MPInt& MPInt::operator++()
 	{
-		++ val_;
-		this->ClearUnusedBits();
-		return *this;
+		if (this->IsSingleWord())
+		{
+			++ val_;
+		}
+		else
+		{
+			for (uint32_t i = 0, e = this->NumWords(); i < e; ++ i)
+			{
+				++ p_val_[i];
+				if (p_val_[i] != 0)
+				{
+					break;
+				}
+			}
+		}
+		return this->ClearUnusedBits();
 	}
 
 	MPInt MPInt::operator--(int)
@@ -157,9 +287,22 @@ namespace Dilithium
 
 	MPInt& MPInt::operator--()
 	{
-		-- val_;
-		this->ClearUnusedBits();
-		return *this;
+		if (this->IsSingleWord())
+		{
+			-- val_;
+		}
+		else
+		{
+			for (uint32_t i = 0, e = this->NumWords(); i < e; ++ i)
+			{
+				-- p_val_[i];
+				if (p_val_[i] != UINT64_MAX)
+				{
+					break;
+				}
+			}
+		}
+		return this->ClearUnusedBits();
 	}
 
 	MPInt MPInt::operator~() const
@@ -169,141 +312,215 @@ namespace Dilithium
 		return ret;
 	}
 
-	MPInt& MPInt::operator=(MPInt const & rhs)
-	{
-		if (this != &rhs)
-		{
-			val_ = rhs.val_;
-			bit_width_ = rhs.bit_width_;
-			this->ClearUnusedBits();
-		}
-		return *this;
-	}
-
-	MPInt& MPInt::operator=(MPInt&& rhs)
+	MPInt& MPInt::MoveAssignSlowCase(MPInt& rhs)
 	{
 		if (this != &rhs)
 		{
-			val_ = rhs.val_;
+			if (!this->IsSingleWord())
+			{
+				delete[] p_val_;
+			}
 			bit_width_ = rhs.bit_width_;
+			if (this->IsSingleWord())
+			{
+				val_ = rhs.val_;
+			}
+			else
+			{
+				p_val_ = rhs.p_val_;
+			}
 			rhs.bit_width_ = 0;
 		}
 		return *this;
 	}
 
-	MPInt& MPInt::operator+=(MPInt const & rhs)
-	{
-		BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
-		val_ += rhs.val_;
-		this->ClearUnusedBits();
-		return *this;
-	}
-
 	MPInt& MPInt::operator-=(MPInt const & rhs)
 	{
 		BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
-		val_ -= rhs.val_;
-		this->ClearUnusedBits();
-		return *this;
+		if (this->IsSingleWord())
+		{
+			val_ -= rhs.val_;
+		}
+		else
+		{
+			uint64_t borrow = 0;
+			for (uint32_t i = 0, e = this->NumWords(); i < e; ++ i)
+			{
+				uint64_t const diff = p_val_[i] - rhs.p_val_[i] - borrow;
+				borrow = (p_val_[i] < rhs.p_val_[i]) || (borrow && (p_val_[i] == rhs.p_val_[i]));
+				p_val_[i] = diff;
+			}
+		}
+		return this->ClearUnusedBits();
 	}
 
 	MPInt& MPInt::operator*=(MPInt const & rhs)
 	{
 		BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
-		val_ *= rhs.val_;
-		this->ClearUnusedBits();
-		return *this;
+		if (this->IsSingleWord())
+		{
+			val_ *= rhs.val_;
+		}
+		else
+		{
+			// Schoolbook multiplication on 32-bit halves, truncated to the width
+			uint32_t const num_halves = this->NumWords() * 2;
+			std::vector<uint32_t> lhs_halves(num_halves);
+			std::vector<uint32_t> rhs_halves(num_halves);
+			for (uint32_t i = 0; i < num_halves; ++ i)
+			{
+				lhs_halves[i] = static_cast<uint32_t>(p_val_[i / 2] >> ((i & 1) * 32));
+				rhs_halves[i] = static_cast<uint32_t>(rhs.p_val_[i / 2] >> ((i & 1) * 32));
+			}
+
+			std::vector<uint32_t> product(num_halves, 0);
+			for (uint32_t i = 0; i < num_halves; ++ i)
+			{
+				uint64_t carry = 0;
+				for (uint32_t j = 0; i + j < num_halves; ++ j)
+				{
+					uint64_t const t = static_cast<uint64_t>(lhs_halves[i]) * rhs_halves[j] + product[i + j] + carry;
+					product[i + j] = static_cast<uint32_t>(t);
+					carry = t >> 32;
+				}
+			}
+
+			for (uint32_t i = 0, e = this->NumWords(); i < e; ++ i)
+			{
+				p_val_[i] = (static_cast<uint64_t>(product[i * 2 + 1]) << 32) | product[i * 2];
+			}
+		}
+		return this->ClearUnusedBits();
 	}
 
 	MPInt& MPInt::operator&=(MPInt const & rhs)
 	{
 		BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
-		val_ &= rhs.val_;
+		if (this->IsSingleWord())
+		{
+			val_ &= rhs.val_;
+		}
+		else
+		{
+			for (uint32_t i = 0, e = this->NumWords(); i < e; ++ i)
+			{
+				p_val_[i] &= rhs.p_val_[i];
+			}
+		}
 		return *this;
 	}
 
 	MPInt& MPInt::operator|=(MPInt const & rhs)
 	{
 		BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
-		val_ |= rhs.val_;
+		if (this->IsSingleWord())
+		{
+			val_ |= rhs.val_;
+		}
+		else
+		{
+			for (uint32_t i = 0, e = this->NumWords(); i < e; ++ i)
+			{
+				p_val_[i] |= rhs.p_val_[i];
+			}
+		}
 		return *this;
 	}
 
 	MPInt& MPInt::operator|=(uint64_t rhs)
 	{
-		val_ |= rhs;
-		this->ClearUnusedBits();
-		return *this;
+		if (this->IsSingleWord())
+		{
+			val_ |= rhs;
+		}
+		else
+		{
+			p_val_[0] |= rhs;
+		}
+		return this->ClearUnusedBits();
 	}
 
 	MPInt& MPInt::operator^=(MPInt const & rhs)
 	{
 		BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
-		val_ ^= rhs.val_;
-		this->ClearUnusedBits();
-		return *this;
+		if (this->IsSingleWord())
+		{
+			val_ ^= rhs.val_;
+		}
+		else
+		{
+			for (uint32_t i = 0, e = this->NumWords(); i < e; ++ i)
+			{
+				p_val_[i] ^= rhs.p_val_[i];
+			}
+		}
+		return this->ClearUnusedBits();
 	}
 
 	MPInt& MPInt::operator<<=(uint32_t shift)
 	{
 		BOOST_ASSERT_MSG(shift <= bit_width_, "Invalid shift amount");
-		if (shift >= bit_width_)
+		if (this->IsSingleWord())
 		{
-			val_ = 0;
+			if (shift >= bit_width_)
+			{
+				val_ = 0;
+			}
+			else
+			{
+				val_ <<= shift;
+			}
+			return this->ClearUnusedBits();
 		}
 		else
 		{
-			val_ <<= shift;
+			return *this = this->ShlSlowCase(shift);
 		}
-		return *this;
-	}
-
-	MPInt MPInt::operator+(MPInt const & rhs) const
-	{
-		BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
-		return MPInt(bit_width_, val_ + rhs.val_);
 	}
 
 	MPInt MPInt::operator-(MPInt const & rhs) const
 	{
-		BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
-		return MPInt(bit_width_, val_ - rhs.val_);
+		MPInt ret(*this);
+		ret -= rhs;
+		return ret;
 	}
 
 	MPInt MPInt::operator*(MPInt const & rhs) const
 	{
-		BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
-		return MPInt(bit_width_, val_ * rhs.val_);
+		MPInt ret(*this);
+		ret *= rhs;
+		return ret;
 	}
 
 	MPInt MPInt::operator&(MPInt const & rhs) const
 	{
-		BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
-		return MPInt(bit_width_, val_ & rhs.val_);
+		MPInt ret(*this);
+		ret &= rhs;
+		return ret;
 	}
 
 	MPInt MPInt::operator|(MPInt const & rhs) const
 	{
-		BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
-		return MPInt(bit_width_, val_ | rhs.val_);
+		MPInt ret(*this);
+		ret |= rhs;
+		return ret;
 	}
 
 	MPInt MPInt::operator^(MPInt const & rhs) const
 	{
-		BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Bit widths must be the same");
-		return MPInt(bit_width_, val_ ^ rhs.val_);
-	}
-
-	bool MPInt::operator[](uint32_t bit_pos) const
-	{
-		BOOST_ASSERT_MSG(bit_pos < bit_width_, "Bit position out of bounds!");
-		return (this->MaskBit(bit_pos) & val_) != 0;
+		MPInt ret(*this);
+		ret ^= rhs;
+		return ret;
 	}
 
 	bool MPInt::operator==(MPInt const & rhs) const
 	{
 		BOOST_ASSERT_MSG(bit_width_ == rhs.bit_width_, "Comparison requires equal bit widths");
-		return val_ == rhs.val_;
+		if (this->IsSingleWord())
+		{
+			return val_ == rhs.val_;
+		}
+		return std::equal(p_val_, p_val_ + this->NumWords(), rhs.p_val_);
 	}
 
 	MPInt MPInt::AShr(MPInt const & shift) const
@@ -322,11 +539,23 @@ namespace Dilithium
 		{
 			return MPInt(bit_width_, 0);
 		}
-		else
+		else if (this->IsSingleWord())
 		{
 			uint32_t sign_bit = MPINT_BITS_PER_WORD - bit_width_;
 			return MPInt(bit_width_, (((static_cast<int64_t>(val_) << sign_bit) >> sign_bit) >> shift));
 		}
+		else
+		{
+			MPInt ret = this->LShr(shift);
+			if (this->IsNegative())
+			{
+				for (uint32_t i = bit_width_ - shift; i < bit_width_; ++ i)
+				{
+					ret.SetBit(i);
+				}
+			}
+			return ret;
+		}
 	}
 
 	MPInt MPInt::LShr(MPInt const & shift) const
@@ -334,17 +563,26 @@ namespace Dilithium
 		return this->LShr(static_cast<uint32_t>(shift.LimitedValue(bit_width_)));
 	}
 
-	MPInt MPInt::Shl(uint32_t shift) const
+	MPInt MPInt::ShlSlowCase(uint32_t shift) const
 	{
-		BOOST_ASSERT_MSG(shift <= bit_width_, "Invalid shift amount");
-		if (shift >= bit_width_)
+		MPInt ret(bit_width_, 0);
+		if (shift < bit_width_)
 		{
-			return MPInt(bit_width_, 0);
-		}
-		else
-		{
-			return MPInt(bit_width_, val_ << shift);
+			uint32_t const num_words = this->NumWords();
+			uint32_t const word_shift = shift / MPINT_BITS_PER_WORD;
+			uint32_t const bit_shift = shift % MPINT_BITS_PER_WORD;
+			for (uint32_t i = num_words; i-- > word_shift;)
+			{
+				uint64_t w = p_val_[i - word_shift] << bit_shift;
+				if ((bit_shift != 0) && (i > word_shift))
+				{
+					w |= p_val_[i - word_shift - 1] >> (MPINT_BITS_PER_WORD - bit_shift);
+				}
+				ret.p_val_[i] = w;
+			}
+			ret.ClearUnusedBits();
 		}
+		return ret;
 	}
 
 	MPInt MPInt::LShr(uint32_t shift) const
@@ -353,10 +591,27 @@ namespace Dilithium
 		{
 			return MPInt(bit_width_, 0);
 		}
-		else
+		else if (this->IsSingleWord())
 		{
 			return MPInt(bit_width_, this->val_ >> shift);
 		}
+		else
+		{
+			MPInt ret(bit_width_, 0);
+			uint32_t const num_words = this->NumWords();
+			uint32_t const word_shift = shift / MPINT_BITS_PER_WORD;
+			uint32_t const bit_shift = shift % MPINT_BITS_PER_WORD;
+			for (uint32_t i = 0; i + word_shift < num_words; ++ i)
+			{
+				uint64_t w = p_val_[i + word_shift] >> bit_shift;
+				if ((bit_shift != 0) && (i + word_shift + 1 < num_words))
+				{
+					w |= p_val_[i + word_shift + 1] << (MPINT_BITS_PER_WORD - bit_shift);
+				}
+				ret.p_val_[i] = w;
+			}
+			return ret;
+		}
 	}
 
 	MPInt MPInt::Shl(MPInt const & shift) const
@@ -369,22 +624,39 @@ namespace Dilithium
 		BOOST_ASSERT_MSG(width < bit_width_, "Invalid MPInt Truncate request");
 		BOOST_ASSERT_MSG(width, "Can't truncate to 0 bits");
 
-		return MPInt(width, val_);
+		if (this->IsSingleWord())
+		{
+			return MPInt(width, val_);
+		}
+		return MPInt(width, ArrayRef<uint64_t>(p_val_, NumWords(width)));
 	}
 
 	MPInt MPInt::SExt(uint32_t width) const
 	{
 		BOOST_ASSERT_MSG(width > bit_width_, "Invalid MPInt SignExtend request");
 
-		uint64_t val = val_ << (MPINT_BITS_PER_WORD - bit_width_);
-		val = static_cast<int64_t>(val >> (width - bit_width_));
-		return MPInt(width, val >> (MPINT_BITS_PER_WORD - width));
+		if (width <= MPINT_BITS_PER_WORD)
+		{
+			uint64_t val = val_ << (MPINT_BITS_PER_WORD - bit_width_);
+			val = static_cast<int64_t>(val) >> (width - bit_width_);
+			return MPInt(width, val >> (MPINT_BITS_PER_WORD - width));
+		}
+
+		MPInt ret = this->ZExt(width);
+		if (this->IsNegative())
+		{
+			for (uint32_t i = bit_width_; i < width; ++ i)
+			{
+				ret.SetBit(i);
+			}
+		}
+		return ret;
 	}
 
 	MPInt MPInt::ZExt(uint32_t width) const
 	{
 		BOOST_ASSERT_MSG(width > bit_width_, "Invalid MPInt ZeroExtend request");
-		return MPInt(width, val_);
+		return MPInt(width, ArrayRef<uint64_t>(this->RawData(), this->NumWords()));
 	}
 
 	MPInt MPInt::SExtOrTrunc(uint32_t width) const
@@ -417,29 +689,79 @@ namespace Dilithium
 
 	void MPInt::SetBit(uint32_t bit_pos)
 	{
-		val_ |= this->MaskBit(bit_pos);
+		this->Word(bit_pos) |= this->MaskBit(bit_pos);
 	}
 
 	void MPInt::ClearBit(uint32_t bit_pos)
 	{
-		val_ &= ~this->MaskBit(bit_pos);
+		this->Word(bit_pos) &= ~this->MaskBit(bit_pos);
+	}
+
+	void MPInt::ClearAllBits()
+	{
+		if (this->IsSingleWord())
+		{
+			val_ = 0;
+		}
+		else
+		{
+			std::fill(p_val_, p_val_ + this->NumWords(), 0);
+		}
 	}
 
 	void MPInt::FlipAllBits()
 	{
-		val_ ^= UINT64_MAX;
+		if (this->IsSingleWord())
+		{
+			val_ ^= UINT64_MAX;
+		}
+		else
+		{
+			for (uint32_t i = 0, e = this->NumWords(); i < e; ++ i)
+			{
+				p_val_[i] ^= UINT64_MAX;
+			}
+		}
 		this->ClearUnusedBits();
 	}
 
 	uint32_t MPInt::CountLeadingZeros() const
 	{
-		uint32_t unused_bits = MPINT_BITS_PER_WORD - bit_width_;
-		return static_cast<uint32_t>(Dilithium::CountLeadingZeros(val_) - unused_bits);
+		uint32_t const unused_bits = this->NumWords() * MPINT_BITS_PER_WORD - bit_width_;
+		if (this->IsSingleWord())
+		{
+			return static_cast<uint32_t>(Dilithium::CountLeadingZeros(val_) - unused_bits);
+		}
+
+		uint32_t count = 0;
+		for (uint32_t i = this->NumWords(); i-- > 0;)
+		{
+			if (p_val_[i] == 0)
+			{
+				count += MPINT_BITS_PER_WORD;
+			}
+			else
+			{
+				count += static_cast<uint32_t>(Dilithium::CountLeadingZeros(p_val_[i]));
+				break;
+			}
+		}
+		return count - unused_bits;
 	}
 
 	uint32_t MPInt::CountPopulation() const
 	{
-		return Dilithium::CountPopulation(val_);
+		if (this->IsSingleWord())
+		{
+			return Dilithium::CountPopulation(val_);
+		}
+
+		uint32_t count = 0;
+		for (uint32_t i = 0, e = this->NumWords(); i < e; ++ i)
+		{
+			count += Dilithium::CountPopulation(p_val_[i]);
+		}
+		return count;
 	}
 
 	void MPInt::FromString(uint32_t num_bits, std::string_view str, uint8_t radix)
@@ -484,7 +806,7 @@ namespace Dilithium
 				}
 			}
 
-			mp_digit.val_ = digit;
+			mp_digit.Assign(digit);
 			*this += mp_digit;
 		}
 		if (is_neg)
@@ -535,6 +857,31 @@ namespace Dilithium
 
 		static char const digits[] = "0123456789ABCDEF";
 
+		if (!this->IsSingleWord())
+		{
+			MPInt mag(*this);
+			if (is_signed && this->IsNegative())
+			{
+				str.push_back('-');
+				mag = -mag;
+			}
+
+			while (*prefix)
+			{
+				str.push_back(*prefix);
+				++ prefix;
+			};
+
+			std::vector<uint64_t> words(mag.RawData(), mag.RawData() + mag.NumWords());
+			std::vector<char> rev_digits;
+			while (std::any_of(words.begin(), words.end(), [](uint64_t w) { return w != 0; }))
+			{
+				rev_digits.push_back(digits[DivideWordsBySmall(words, radix)]);
+			}
+			str.insert(str.end(), rev_digits.rbegin(), rev_digits.rend());
+			return;
+		}
+
 		char buff[65];
 		char* buff_ptr = buff + 65;
 
@@ -585,6 +932,7 @@ namespace Dilithium
 			uint64_t i;
 			double d;
 		} t;
+		BOOST_ASSERT(this->IsSingleWord());
 		t.i = val_;
 		return t.d;
 	}
@@ -596,16 +944,8 @@ namespace Dilithium
 			uint32_t i;
 			float f;
 		} t;
+		BOOST_ASSERT(this->IsSingleWord());
 		t.i = static_cast<uint32_t>(val_);
 		return t.f;
 	}
-
-	void MPInt::ClearUnusedBits()
-	{
-		if (bit_width_ > 0)
-		{
-			uint64_t mask = ~uint64_t(0ULL) >> (MPINT_BITS_PER_WORD - bit_width_);
-			val_ &= mask;
-		}
-	}
 }
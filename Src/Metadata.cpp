@@ -38,6 +38,8 @@
 #include <Dilithium/Metadata.hpp>
 #include "LLVMContextImpl.hpp"
 
+#include <cstring>
+
 namespace
 {
 	using namespace Dilithium;
@@ -121,27 +123,45 @@ namespace
 		return false;
 	}
 
-	template <typename T>
-	static T* GetUniqued(std::unordered_map<uint64_t, T*>& Store, uint64_t key)
+	static Metadata* OperandMetadata(Metadata* md)
 	{
-		auto iter = Store.find(key);
-		return iter == Store.end() ? nullptr : iter->second;
+		return md;
 	}
 
-	template <typename T>
-	static T* UniquifyImpl(T* n, std::unordered_map<uint64_t, T*>& store)
+	static Metadata* OperandMetadata(MDOperand const & op)
+	{
+		return op.Get();
+	}
+
+	template <typename Iter>
+	static bool HasOperands(MDNode const * node, Iter begin, Iter end)
 	{
-		uint64_t hash_val = std::hash<T>()(*n);
-		T* u = GetUniqued(store, hash_val);
-		if (u)
+		if (node->NumOperands() != static_cast<uint32_t>(std::distance(begin, end)))
 		{
-			return u;
+			return false;
 		}
-		else
+		for (auto op = node->OpBegin(); begin != end; ++ begin, ++ op)
 		{
-			store.emplace(hash_val, n);
-			return n;
+			if (op->Get() != OperandMetadata(*begin))
+			{
+				return false;
+			}
 		}
+		return true;
+	}
+
+	template <typename T>
+	static T* UniquifyImpl(T* n, ShardedUniquingSet<T>& store, bool concurrent)
+	{
+		return store.FindOrInsert(concurrent, std::hash<T>()(*n),
+			[n](T const * other)
+			{
+				return HasOperands(other, n->OpBegin(), n->OpEnd());
+			},
+			[n]()
+			{
+				return n;
+			});
 	}
 }
 
@@ -172,14 +192,20 @@ namespace Dilithium
 
 	MetadataAsValue::~MetadataAsValue()
 	{
-		this->GetType()->Context().Impl().metadata_as_values.erase(md_);
+		{
+			auto& impl = this->GetType()->Context().Impl();
+			auto lock = impl.ConcurrentLock(impl.md_wrappers_mutex);
+			impl.metadata_as_values.erase(md_);
+		}
 		this->Untrack();
 	}
 	
 	MetadataAsValue* MetadataAsValue::Get(LLVMContext& context, Metadata* md)
 	{
 		md = CanonicalizeMetadataForValue(context, md);
-		auto& entry = context.Impl().metadata_as_values[md];
+		auto& impl = context.Impl();
+		auto lock = impl.ConcurrentLock(impl.md_wrappers_mutex);
+		auto& entry = impl.metadata_as_values[md];
 		if (!entry)
 		{
 			entry = new MetadataAsValue(Type::MetadataType(context), md);
@@ -187,6 +213,23 @@ namespace Dilithium
 		return entry;
 	}
 
+	void MetadataAsValue::DeleteUnused(LLVMContext& context)
+	{
+		std::vector<MetadataAsValue*> unused;
+		for (auto const & entry : context.Impl().metadata_as_values)
+		{
+			if (entry.second->UseEmpty())
+			{
+				unused.push_back(entry.second);
+			}
+		}
+		for (auto mav : unused)
+		{
+			// Erases itself from the store
+			delete mav;
+		}
+	}
+
 	void MetadataAsValue::HandleChangedMetadata(Metadata* md)
 	{
 		auto& context = this->Context();
@@ -337,6 +380,8 @@ namespace Dilithium
 
 	void ReplaceableMetadataImpl::AddRef(void* ref, OwnerTy owner)
 	{
+		auto& impl = context_.Impl();
+		auto lock = impl.ConcurrentLock(impl.md_tracking_mutex);
 		bool was_inserted = use_map_.insert(std::make_pair(ref, std::make_pair(owner, next_index_))).second;
 		DILITHIUM_UNUSED(was_inserted);
 		BOOST_ASSERT_MSG(was_inserted, "Expected to add a reference");
@@ -347,6 +392,8 @@ namespace Dilithium
 
 	void ReplaceableMetadataImpl::DropRef(void* ref)
 	{
+		auto& impl = context_.Impl();
+		auto lock = impl.ConcurrentLock(impl.md_tracking_mutex);
 		bool was_erased = use_map_.erase(ref);
 		DILITHIUM_UNUSED(was_erased);
 		BOOST_ASSERT_MSG(was_erased, "Expected to drop a reference");
@@ -354,6 +401,8 @@ namespace Dilithium
 
 	void ReplaceableMetadataImpl::MoveRef(void* old_ref, void* new_ref, Metadata const & md)
 	{
+		auto& impl = context_.Impl();
+		auto lock = impl.ConcurrentLock(impl.md_tracking_mutex);
 		auto iter = use_map_.find(old_ref);
 		BOOST_ASSERT_MSG(iter != use_map_.end(), "Expected to move a reference");
 		auto owner_and_index = iter->second;
@@ -393,8 +442,9 @@ namespace Dilithium
 	{
 		BOOST_ASSERT_MSG(val, "Unexpected null Value");
 
-		auto& context = val->Context();
-		auto& entry = context.Impl().values_as_metadata[val];
+		auto& impl = val->Context().Impl();
+		auto lock = impl.ConcurrentLock(impl.md_wrappers_mutex);
+		auto& entry = impl.values_as_metadata[val];
 		if (!entry)
 		{
 			BOOST_ASSERT_MSG(isa<Constant>(val) || isa<Argument>(val) || isa<Instruction>(val),
@@ -497,40 +547,47 @@ namespace Dilithium
 	}
 
 
-	MDString::MDString()
-		: Metadata(MDStringKind, Uniqued), string_hash_(0)
+	void ValueAsMetadata::DeleteUnusedConstants(LLVMContext& context)
 	{
+		auto& store = context.Impl().values_as_metadata;
+		for (auto iter = store.begin(); iter != store.end();)
+		{
+			auto md = iter->second;
+			if (isa<ConstantAsMetadata>(md) && !md->HasUses())
+			{
+				BOOST_ASSERT_MSG(md->GetValue() == iter->first, "Expected valid mapping");
+				iter->first->is_used_by_md_ = false;
+				iter = store.erase(iter);
+				delete md;
+			}
+			else
+			{
+				++ iter;
+			}
+		}
 	}
 
-	MDString::MDString(MDString&& rhs)
-		: Metadata(MDStringKind, Uniqued)
+
+	MDString::MDString(std::string_view str, uint64_t hash)
+		: Metadata(MDStringKind, Uniqued), string_hash_(hash), size_(static_cast<uint32_t>(str.size()))
 	{
-		DILITHIUM_UNUSED(rhs);
+		std::memcpy(this + 1, str.data(), str.size());
 	}
 
 	MDString* MDString::Get(LLVMContext& context, std::string_view str)
 	{
-		auto& store = context.Impl().md_string_cache;
+		auto& impl = context.Impl();
 		uint64_t hash_val = boost::hash_value(str);
-		auto iter = store.find(hash_val);
-		if (iter == store.end())
-		{
-			auto mds = std::make_unique<MDString>();
-			mds->string_ = std::string(str);
-			mds->string_hash_ = hash_val;
-
-			bool was_inserted;
-			std::tie(iter, was_inserted) = store.emplace(hash_val, std::move(mds));
-			DILITHIUM_UNUSED(was_inserted);
-			BOOST_ASSERT_MSG(was_inserted, "Expected entry to be inserted");
-		}
-		return iter->second.get();
-	}
-
-	std::string_view MDString::String() const
-	{
-		BOOST_ASSERT_MSG(!string_.empty(), "Expected to find string map entry");
-		return string_;
+		return impl.md_string_cache.FindOrInsert(impl.concurrent_uniquing, hash_val,
+			[str](MDString const * s)
+			{
+				return s->String() == str;
+			},
+			[str, hash_val]()
+			{
+				void* mem = ::operator new(sizeof(MDString) + str.size());
+				return new (mem) MDString(str, hash_val);
+			});
 	}
 
 
@@ -708,6 +765,57 @@ namespace Dilithium
 		context_.ReplaceableUses()->ReplaceAllUsesWith(md);
 	}
 
+	void MDNode::ReplaceOperandWith(uint32_t idx, Metadata* new_md)
+	{
+		if (this->Operand(idx).Get() == new_md)
+		{
+			return;
+		}
+
+		if (this->IsUniqued())
+		{
+			this->HandleChangedOperand(this->MutableBegin() + idx, new_md);
+		}
+		else
+		{
+			this->Operand(idx, new_md);
+		}
+	}
+
+	void MDNode::UniquifyDistinct()
+	{
+		BOOST_ASSERT_MSG(this->IsDistinct(), "Expected a distinct node");
+
+		if (HasSelfReference(this))
+		{
+			return;
+		}
+
+		auto& impl = context_.Context().Impl();
+		{
+			auto lock = impl.ConcurrentLock(impl.distinct_md_nodes_mutex);
+			impl.distinct_md_nodes.erase(this);
+		}
+		// Operands of a uniqued node are tracked with the node as owner, those of a distinct node without
+		auto retrack = [this]()
+		{
+			for (uint32_t i = 0, e = static_cast<uint32_t>(operands_.size()); i != e; ++ i)
+			{
+				this->Operand(i, operands_[i].Get());
+			}
+		};
+
+		storage_ = Uniqued;
+		retrack();
+
+		if (this->Uniquify() != this)
+		{
+			storage_ = Distinct;
+			retrack();
+			this->StoreDistinctInContext();
+		}
+	}
+
 	void MDNode::DropAllReferences()
 	{
 		for (uint32_t i = 0, e = static_cast<uint32_t>(operands_.size()); i != e; ++ i)
@@ -727,6 +835,58 @@ namespace Dilithium
 		operands_[idx].Reset(md, this->IsUniqued() ? this : nullptr);
 	}
 
+	void MDNode::DeleteUnreachable(LLVMContext& context, std::unordered_set<Metadata const *> const & reachable)
+	{
+		auto& impl = context.Impl();
+
+		std::vector<MDNode*> dead;
+		auto is_dead = [&reachable](MDNode const * node)
+		{
+			BOOST_ASSERT_MSG(node->IsResolved() || (reachable.find(node) != reachable.end()),
+				"Unresolved nodes have to be marked as reachable");
+			return reachable.find(node) == reachable.end();
+		};
+#define HANDLE_MDNODE_LEAF(CLASS)						\
+		impl.CLASS##s.ForEach([&dead, &is_dead](CLASS* node)	\
+			{											\
+				if (is_dead(node))						\
+				{										\
+					dead.push_back(node);				\
+				}										\
+			});
+#include "Dilithium/Metadata.inc"
+		for (auto iter = impl.distinct_md_nodes.begin(); iter != impl.distinct_md_nodes.end();)
+		{
+			if (is_dead(*iter))
+			{
+				dead.push_back(*iter);
+				iter = impl.distinct_md_nodes.erase(iter);
+			}
+			else
+			{
+				++ iter;
+			}
+		}
+
+		// The store hash depends on the operands, erase before dropping them. Dead nodes can point to each other,
+		// so every reference is dropped before the first one is deleted.
+		for (auto node : dead)
+		{
+			if (node->IsUniqued())
+			{
+				node->EraseFromStore();
+			}
+		}
+		for (auto node : dead)
+		{
+			node->DropAllReferences();
+		}
+		for (auto node : dead)
+		{
+			node->DeleteAsSubclass();
+		}
+	}
+
 	void MDNode::StoreDistinctInContext()
 	{
 		BOOST_ASSERT_MSG(this->IsResolved(), "Expected resolved nodes");
@@ -747,7 +907,9 @@ namespace Dilithium
 #include "Dilithium/Metadata.inc"
 		}
 
-		context_.Context().Impl().distinct_md_nodes.insert(this);
+		auto& impl = context_.Context().Impl();
+		auto lock = impl.ConcurrentLock(impl.distinct_md_nodes_mutex);
+		impl.distinct_md_nodes.insert(this);
 	}
 
 	template <typename T, typename StoreT>
@@ -756,7 +918,7 @@ namespace Dilithium
 		switch (storage)
 		{
 		case Uniqued:
-			store.emplace(std::hash<T>()(*n), n);
+			store.Insert(n->context_.Context().Impl().concurrent_uniquing, std::hash<T>()(*n), n);
 			break;
 		case Distinct:
 			n->StoreDistinctInContext();
@@ -896,7 +1058,8 @@ namespace Dilithium
 				CLASS* subclass_this = cast<CLASS>(this);											\
 				std::integral_constant<bool, HasCachedHash<CLASS>::value> should_recalculate_hash;	\
 				this->DispatchRecalculateHash(subclass_this, should_recalculate_hash);				\
-				return UniquifyImpl(subclass_this, context_.Context().Impl().CLASS##s);				\
+				auto& impl = context_.Context().Impl();												\
+				return UniquifyImpl(subclass_this, impl.CLASS##s, impl.concurrent_uniquing);		\
 			}
 #include "Dilithium/Metadata.inc"
 		}
@@ -904,6 +1067,21 @@ namespace Dilithium
 
 	void MDNode::EraseFromStore()
 	{
+		switch (this->MetadataId())
+		{
+		default:
+			DILITHIUM_UNREACHABLE("Invalid subclass of MDNode");
+
+#define HANDLE_MDNODE_LEAF(CLASS)																	\
+		case CLASS##Kind:																			\
+			{																						\
+				CLASS* subclass_this = cast<CLASS>(this);											\
+				auto& impl = context_.Context().Impl();												\
+				impl.CLASS##s.Erase(impl.concurrent_uniquing, std::hash<CLASS>()(*subclass_this), subclass_this);	\
+				break;																				\
+			}
+#include "Dilithium/Metadata.inc"
+		}
 	}
 
 
@@ -925,27 +1103,31 @@ namespace Dilithium
 
 	MDTuple* MDTuple::GetImpl(LLVMContext& context, ArrayRef<Metadata*> mds, StorageType storage, bool should_create)
 	{
-		uint32_t hash = 0;
 		if (storage == Uniqued)
 		{
+			auto& impl = context.Impl();
 			uint64_t hash_val = boost::hash_range(mds.begin(), mds.end());
-			auto mdt = GetUniqued(context.Impl().MDTuples, hash_val);
-			if (mdt)
+			auto is_equal = [mds](MDTuple const * node)
 			{
-				return mdt;
-			}
+				return HasOperands(node, mds.begin(), mds.end());
+			};
 			if (!should_create)
 			{
-				return nullptr;
+				return impl.MDTuples.Find(impl.concurrent_uniquing, hash_val, is_equal);
 			}
-			hash = static_cast<uint32_t>(hash_val);
+
+			// Creation happens under the shard lock, so concurrent callers with the same operands get the same node
+			return impl.MDTuples.FindOrInsert(impl.concurrent_uniquing, hash_val, is_equal,
+				[&context, mds, hash_val]()
+				{
+					return new MDTuple(context, Uniqued, static_cast<uint32_t>(hash_val), mds);
+				});
 		}
 		else
 		{
 			BOOST_ASSERT_MSG(should_create, "Expected non-uniqued nodes to always be created");
+			return StoreImpl(new MDTuple(context, storage, 0, mds), storage, context.Impl().MDTuples);
 		}
-
-		return StoreImpl(new MDTuple(context, storage, hash, mds), storage, context.Impl().MDTuples);
 	}
 
 
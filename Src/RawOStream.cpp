@@ -0,0 +1,182 @@
+/**
+ * @file RawOStream.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/RawOStream.hpp>
+
+#include <algorithm>
+#include <ostream>
+
+#include <boost/assert.hpp>
+
+namespace
+{
+	// Text written to a target stream is handed over in chunks of this size
+	size_t const FLUSH_BUFFER_SIZE = 64 * 1024;
+	size_t const INITIAL_BUFFER_SIZE = 4 * 1024;
+}
+
+namespace Dilithium
+{
+	RawOStream::RawOStream()
+		: size_(0), capacity_(0), target_(nullptr)
+	{
+		this->Reserve(INITIAL_BUFFER_SIZE);
+	}
+
+	RawOStream::RawOStream(std::ostream& target)
+		: size_(0), capacity_(0), target_(&target)
+	{
+		this->Reserve(FLUSH_BUFFER_SIZE);
+	}
+
+	RawOStream::~RawOStream()
+	{
+		this->Flush();
+	}
+
+	RawOStream& RawOStream::operator<<(void const * ptr)
+	{
+		*this << "0x";
+		return this->WriteHex(reinterpret_cast<uintptr_t>(ptr), 1, false);
+	}
+
+	RawOStream& RawOStream::WriteDecimal(uint64_t val)
+	{
+		char buff[20];
+		char* ptr = buff + sizeof(buff);
+		do
+		{
+			-- ptr;
+			*ptr = static_cast<char>('0' + val % 10);
+			val /= 10;
+		} while (val != 0);
+		return this->Write(ptr, buff + sizeof(buff) - ptr);
+	}
+
+	RawOStream& RawOStream::WriteDecimal(int64_t val)
+	{
+		if (val < 0)
+		{
+			*this << '-';
+			// Negate in unsigned to keep INT64_MIN well defined
+			return this->WriteDecimal(0 - static_cast<uint64_t>(val));
+		}
+		return this->WriteDecimal(static_cast<uint64_t>(val));
+	}
+
+	RawOStream& RawOStream::WriteHex(uint64_t val, uint32_t min_digits, bool upper)
+	{
+		BOOST_ASSERT(min_digits <= 16);
+
+		char const * digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+		char buff[16];
+		char* ptr = buff + sizeof(buff);
+		do
+		{
+			-- ptr;
+			*ptr = digits[val & 0xF];
+			val >>= 4;
+		} while ((val != 0) || (buff + sizeof(buff) - ptr < static_cast<ptrdiff_t>(min_digits)));
+		return this->Write(ptr, buff + sizeof(buff) - ptr);
+	}
+
+	RawOStream& RawOStream::Indent(uint32_t num_spaces)
+	{
+		if (num_spaces > capacity_ - size_)
+		{
+			this->Grow(num_spaces);
+		}
+		memset(buff_.get() + size_, ' ', num_spaces);
+		size_ += num_spaces;
+		return *this;
+	}
+
+	void RawOStream::Reserve(size_t size)
+	{
+		if (size > capacity_)
+		{
+			std::unique_ptr<char[]> new_buff(new char[size]);
+			if (size_ > 0)
+			{
+				memcpy(new_buff.get(), buff_.get(), size_);
+			}
+			buff_ = std::move(new_buff);
+			capacity_ = size;
+		}
+	}
+
+	void RawOStream::Flush()
+	{
+		if (target_ && (size_ > 0))
+		{
+			target_->write(buff_.get(), size_);
+			size_ = 0;
+		}
+	}
+
+	void RawOStream::Grow(size_t extra)
+	{
+		if (target_)
+		{
+			this->Flush();
+			if (extra <= capacity_)
+			{
+				return;
+			}
+		}
+
+		this->Reserve(std::max(capacity_ * 2, size_ + extra));
+	}
+
+
+	RawOStreamBuf::RawOStreamBuf(RawOStream& os)
+		: os_(os)
+	{
+	}
+
+	RawOStreamBuf::int_type RawOStreamBuf::overflow(int_type ch)
+	{
+		if (!traits_type::eq_int_type(ch, traits_type::eof()))
+		{
+			os_ << traits_type::to_char_type(ch);
+		}
+		return traits_type::not_eof(ch);
+	}
+
+	std::streamsize RawOStreamBuf::xsputn(char_type const * s, std::streamsize count)
+	{
+		os_.Write(s, static_cast<size_t>(count));
+		return count;
+	}
+}
@@ -180,25 +180,19 @@ namespace Dilithium
 	/// their size is relatively uncommon, move this operation out of line.
 	bool Type::IsSizedDerivedType() const
 	{
-		Type const * final_type;
 		ArrayType const * arr_type = dyn_cast<ArrayType>(this);
 		if (arr_type)
 		{
-			final_type = arr_type->ElementType();
+			return arr_type->ElementType()->IsSized();
 		}
-		else
+
+		VectorType const * vec_type = dyn_cast<VectorType>(this);
+		if (vec_type)
 		{
-			VectorType const * vec_type = dyn_cast<VectorType>(this);
-			if (vec_type)
-			{
-				final_type = vec_type->ElementType();
-			}
-			else
-			{
-				final_type = cast<StructType>(this);
-			}
+			return vec_type->ElementType()->IsSized();
 		}
-		return final_type->IsSized();
+
+		return cast<StructType>(this)->IsSized();
 	}
 
 	uint32_t Type::IntegerBitWidth() const
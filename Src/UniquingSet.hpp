@@ -0,0 +1,462 @@
+/**
+ * @file UniquingSet.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DILITHIUM_UNIQUING_SET_HPP
+#define _DILITHIUM_UNIQUING_SET_HPP
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+#include <boost/assert.hpp>
+
+namespace Dilithium
+{
+	// Open-addressing hash set used for hash-consing the uniqued objects in LLVMContextImpl. It keeps the element
+	// pointer along with its full 64-bit hash, and a lookup compares the full key (via the caller's predicate) only
+	// on a hash match. So hash collisions cost a compare, but never return a wrong object.
+	// The set doesn't own the elements.
+	template <typename T>
+	class UniquingSet
+	{
+		struct Bucket
+		{
+			uint64_t hash;
+			T* elem;
+		};
+
+	public:
+		class const_iterator
+		{
+		public:
+			typedef T* value_type;
+			typedef ptrdiff_t difference_type;
+			typedef T* const * pointer;
+			typedef T* const & reference;
+			typedef std::forward_iterator_tag iterator_category;
+
+		public:
+			const_iterator(Bucket const * bucket, Bucket const * end)
+				: bucket_(bucket), end_(end)
+			{
+				this->AdvancePastEmpty();
+			}
+
+			bool operator==(const_iterator const & rhs) const
+			{
+				return bucket_ == rhs.bucket_;
+			}
+			bool operator!=(const_iterator const & rhs) const
+			{
+				return !operator==(rhs);
+			}
+
+			reference operator*() const
+			{
+				return bucket_->elem;
+			}
+
+			const_iterator& operator++()
+			{
+				++ bucket_;
+				this->AdvancePastEmpty();
+				return *this;
+			}
+			const_iterator operator++(int)
+			{
+				auto tmp = *this;
+				++ *this;
+				return tmp;
+			}
+
+		private:
+			void AdvancePastEmpty()
+			{
+				while ((bucket_ != end_) && !IsLive(bucket_->elem))
+				{
+					++ bucket_;
+				}
+			}
+
+		private:
+			Bucket const * bucket_;
+			Bucket const * end_;
+		};
+
+	public:
+		UniquingSet()
+			: size_(0), num_tombstones_(0), shift_(64)
+		{
+		}
+
+		size_t size() const
+		{
+			return size_;
+		}
+		bool empty() const
+		{
+			return size_ == 0;
+		}
+		size_t AllocatedBytes() const
+		{
+			return buckets_.capacity() * sizeof(Bucket);
+		}
+
+		const_iterator begin() const
+		{
+			return const_iterator(buckets_.data(), buckets_.data() + buckets_.size());
+		}
+		const_iterator end() const
+		{
+			return const_iterator(buckets_.data() + buckets_.size(), buckets_.data() + buckets_.size());
+		}
+
+		// is_equal(T const * elem) tells if elem has the key that produced hash
+		template <typename Pred>
+		T* Find(uint64_t hash, Pred&& is_equal) const
+		{
+			if (buckets_.empty())
+			{
+				return nullptr;
+			}
+
+			size_t const mask = buckets_.size() - 1;
+			for (size_t i = this->HomeIndex(hash), probe = 1; ; i = (i + probe) & mask, ++ probe)
+			{
+				Bucket const & bucket = buckets_[i];
+				if (bucket.elem == nullptr)
+				{
+					return nullptr;
+				}
+				if ((bucket.hash == hash) && IsLive(bucket.elem) && is_equal(static_cast<T const *>(bucket.elem)))
+				{
+					return bucket.elem;
+				}
+			}
+		}
+
+		// The caller guarantees no equal element is in the set
+		void Insert(uint64_t hash, T* elem)
+		{
+			BOOST_ASSERT(elem != nullptr);
+
+			if ((size_ + num_tombstones_ + 1) * 4 > buckets_.size() * 3)
+			{
+				this->Grow();
+			}
+
+			size_t const mask = buckets_.size() - 1;
+			size_t i = this->HomeIndex(hash);
+			for (size_t probe = 1; IsLive(buckets_[i].elem); ++ probe)
+			{
+				i = (i + probe) & mask;
+			}
+
+			if (buckets_[i].elem != nullptr)
+			{
+				-- num_tombstones_;
+			}
+			buckets_[i].hash = hash;
+			buckets_[i].elem = elem;
+			++ size_;
+		}
+
+		bool Erase(uint64_t hash, T const * elem)
+		{
+			if (buckets_.empty())
+			{
+				return false;
+			}
+
+			size_t const mask = buckets_.size() - 1;
+			for (size_t i = this->HomeIndex(hash), probe = 1; buckets_[i].elem != nullptr; i = (i + probe) & mask, ++ probe)
+			{
+				if (buckets_[i].elem == elem)
+				{
+					buckets_[i].elem = Tombstone();
+					-- size_;
+					++ num_tombstones_;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Presizes the buckets for n more elements, so a batch of inserts doesn't rehash on the way
+		void Reserve(size_t n)
+		{
+			size_t new_size = buckets_.empty() ? 16 : buckets_.size();
+			while ((size_ + num_tombstones_ + n) * 4 > new_size * 3)
+			{
+				new_size *= 2;
+			}
+			if (new_size != buckets_.size())
+			{
+				this->Rehash(new_size);
+			}
+		}
+
+		// Drops the tombstones and shrinks the buckets to the size a fresh set would have grown to
+		void ShrinkToFit()
+		{
+			if (size_ == 0)
+			{
+				this->clear();
+				buckets_.shrink_to_fit();
+				return;
+			}
+
+			size_t new_size = 16;
+			while (size_ * 2 >= new_size)
+			{
+				new_size *= 2;
+			}
+			if ((new_size < buckets_.size()) || (num_tombstones_ != 0))
+			{
+				this->Rehash(new_size);
+			}
+		}
+
+		void clear()
+		{
+			buckets_.clear();
+			size_ = 0;
+			num_tombstones_ = 0;
+		}
+
+	private:
+		static T* Tombstone()
+		{
+			return reinterpret_cast<T*>(~static_cast<uintptr_t>(0));
+		}
+		static bool IsLive(T const * elem)
+		{
+			return (elem != nullptr) && (elem != Tombstone());
+		}
+
+		// Fibonacci hashing, spreads the weak low bits of pointer-based hashes over the whole table
+		size_t HomeIndex(uint64_t hash) const
+		{
+			return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ULL) >> shift_);
+		}
+
+		void Grow()
+		{
+			// Rehash in place when most of the occupied buckets are tombstones
+			size_t new_size = buckets_.empty() ? 16 : buckets_.size();
+			while (size_ * 2 >= new_size)
+			{
+				new_size *= 2;
+			}
+			this->Rehash(new_size);
+		}
+
+		void Rehash(size_t new_size)
+		{
+			std::vector<Bucket> old_buckets(new_size, Bucket{ 0, nullptr });
+			old_buckets.swap(buckets_);
+			shift_ = 64;
+			for (size_t s = new_size; s > 1; s >>= 1)
+			{
+				-- shift_;
+			}
+			size_ = 0;
+			num_tombstones_ = 0;
+
+			for (auto const & bucket : old_buckets)
+			{
+				if (IsLive(bucket.elem))
+				{
+					this->Insert(bucket.hash, bucket.elem);
+				}
+			}
+		}
+
+	private:
+		std::vector<Bucket> buckets_;
+		size_t size_;
+		size_t num_tombstones_;
+		uint32_t shift_;
+	};
+
+	// UniquingSet split by hash into independently locked shards, so threads only contend when they hit the same shard.
+	// The locks are taken only in concurrent mode; single-threaded callers pay for the shard selection only.
+	template <typename T>
+	class ShardedUniquingSet
+	{
+	public:
+		static uint32_t const NUM_SHARDS = 16;
+
+	public:
+		size_t size() const
+		{
+			size_t ret = 0;
+			for (auto const & shard : shards_)
+			{
+				ret += shard.set.size();
+			}
+			return ret;
+		}
+		// Not synchronized
+		size_t AllocatedBytes() const
+		{
+			size_t ret = sizeof(shards_);
+			for (auto const & shard : shards_)
+			{
+				ret += shard.set.AllocatedBytes();
+			}
+			return ret;
+		}
+
+		template <typename Pred>
+		T* Find(bool concurrent, uint64_t hash, Pred&& is_equal) const
+		{
+			auto const & shard = shards_[ShardIndex(hash)];
+			std::unique_lock<std::mutex> lock(shard.mutex, std::defer_lock);
+			if (concurrent)
+			{
+				lock.lock();
+			}
+			return shard.set.Find(hash, std::forward<Pred>(is_equal));
+		}
+
+		// Atomic insert-if-absent. create() runs under the shard lock and only if no equal element is found.
+		template <typename Pred, typename Create>
+		T* FindOrInsert(bool concurrent, uint64_t hash, Pred&& is_equal, Create&& create)
+		{
+			auto& shard = shards_[ShardIndex(hash)];
+			std::unique_lock<std::mutex> lock(shard.mutex, std::defer_lock);
+			if (concurrent)
+			{
+				lock.lock();
+			}
+			T* elem = shard.set.Find(hash, std::forward<Pred>(is_equal));
+			if (!elem)
+			{
+				elem = create();
+				shard.set.Insert(hash, elem);
+			}
+			return elem;
+		}
+
+		void Insert(bool concurrent, uint64_t hash, T* elem)
+		{
+			auto& shard = shards_[ShardIndex(hash)];
+			std::unique_lock<std::mutex> lock(shard.mutex, std::defer_lock);
+			if (concurrent)
+			{
+				lock.lock();
+			}
+			shard.set.Insert(hash, elem);
+		}
+
+		bool Erase(bool concurrent, uint64_t hash, T const * elem)
+		{
+			auto& shard = shards_[ShardIndex(hash)];
+			std::unique_lock<std::mutex> lock(shard.mutex, std::defer_lock);
+			if (concurrent)
+			{
+				lock.lock();
+			}
+			return shard.set.Erase(hash, elem);
+		}
+
+		// Not synchronized, for teardown
+		template <typename Func>
+		void ForEach(Func&& func) const
+		{
+			for (auto const & shard : shards_)
+			{
+				for (auto elem : shard.set)
+				{
+					func(elem);
+				}
+			}
+		}
+
+		// Hashes are assumed to spread evenly over the shards
+		void Reserve(bool concurrent, size_t n)
+		{
+			size_t const per_shard = (n + NUM_SHARDS - 1) / NUM_SHARDS;
+			for (auto& shard : shards_)
+			{
+				std::unique_lock<std::mutex> lock(shard.mutex, std::defer_lock);
+				if (concurrent)
+				{
+					lock.lock();
+				}
+				shard.set.Reserve(per_shard);
+			}
+		}
+
+		// Not synchronized
+		void ShrinkToFit()
+		{
+			for (auto& shard : shards_)
+			{
+				shard.set.ShrinkToFit();
+			}
+		}
+
+		void clear()
+		{
+			for (auto& shard : shards_)
+			{
+				shard.set.clear();
+			}
+		}
+
+	private:
+		// A different multiplier from UniquingSet::HomeIndex, so the shard doesn't fix the top bits of the home index
+		static uint32_t ShardIndex(uint64_t hash)
+		{
+			return static_cast<uint32_t>((hash * 0xC2B2AE3D27D4EB4FULL) >> 60);
+		}
+
+	private:
+		struct Shard
+		{
+			mutable std::mutex mutex;
+			UniquingSet<T> set;
+		};
+
+		std::array<Shard, NUM_SHARDS> shards_;
+	};
+}
+
+#endif		// _DILITHIUM_UNIQUING_SET_HPP
@@ -37,6 +37,8 @@
 
 namespace Dilithium 
 {
+	static_assert(sizeof(Use) == 3 * sizeof(void*), "Use is expected to be 3 pointers big");
+
 	Use::~Use()
 	{
 		if (val_)
@@ -78,13 +80,7 @@ namespace Dilithium
 
 	User* Use::GetUser() const
 	{
-		// TODO: Could be wrong, very careful of this.
-
-		// The is_ref is encoded to the last bit of this pointer
-		Use const * end = this->GetImpliedUser();
-		bool is_ref = (reinterpret_cast<size_t>(end) & 1) ? true : false;
-		return is_ref ? reinterpret_cast<User *>((reinterpret_cast<size_t>(end) & ~static_cast<size_t>(1)))
-			: reinterpret_cast<User *>(const_cast<Use *>(end));
+		return reinterpret_cast<User*>(this->GetImpliedUser()->prev_ptr_tag_);
 	}
 
 	void Use::Swap(Use& rhs)
@@ -141,7 +137,7 @@ namespace Dilithium
 				ZeroDigitTag, OneDigitTag,  ZeroDigitTag, OneDigitTag, StopTag,
 				OneDigitTag,  OneDigitTag,  OneDigitTag,  OneDigitTag, StopTag
 			};
-			end->tag_ = tags[done];
+			end->Tag(tags[done]);
 			++ done;
 		}
 
@@ -151,13 +147,13 @@ namespace Dilithium
 			-- end;
 			if (!count)
 			{
-				end->tag_ = StopTag;
+				end->Tag(StopTag);
 				++ done;
 				count = done;
 			}
 			else
 			{
-				end->tag_ = PrevPtrTag(count & 1);
+				end->Tag(PrevPtrTag(count & 1));
 				count >>= 1;
 				++ done;
 			}
@@ -174,7 +170,7 @@ namespace Dilithium
 
 		for (;;)
 		{
-			uint32_t tag = curr->tag_;
+			uint32_t tag = curr->Tag();
 			++ curr;
 			switch (tag)
 			{
@@ -188,7 +184,7 @@ namespace Dilithium
 					ptrdiff_t offset = 1;
 					for (;;)
 					{
-						tag = curr->tag_;
+						tag = curr->Tag();
 						switch (tag)
 						{
 						case ZeroDigitTag:
@@ -214,19 +210,19 @@ namespace Dilithium
 		next_ = *node;
 		if (next_)
 		{
-			next_->prev_ptr_ = &next_;
+			next_->PrevPtr(&next_);
 		}
-		prev_ptr_ = node;
+		this->PrevPtr(node);
 		*node = this;
 	}
 
 	void Use::RemoveFromList()
 	{
-		Use** stripped_prev = prev_ptr_;
+		Use** stripped_prev = this->PrevPtr();
 		*stripped_prev = next_;
 		if (next_)
 		{
-			next_->prev_ptr_ = stripped_prev;
+			next_->PrevPtr(stripped_prev);
 		}
 	}
 }
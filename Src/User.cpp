@@ -46,10 +46,12 @@ namespace Dilithium
 		// null.
 		BOOST_ASSERT_MSG(!this->OperandList(), "Error in initializing hung off uses for User");
 
-		operands_.resize(num_uses);
 		if (num_uses > 0)
 		{
+			// The extra Use after the operands is where the waymarking walk in Use::GetUser ends up.
+			operands_.resize(num_uses + 1);
 			Use::InitTags(operands_.data(), operands_.data() + num_uses);
+			operands_[num_uses].ImpliedUser(this);
 		}
 	}
 
@@ -120,7 +120,7 @@ namespace
 				if (gv)
 				{
 					auto parent = gv->Parent();
-					if (gv)
+					if (parent)
 					{
 						sym_tab = parent->GetValueSymbolTable();
 					}
@@ -204,7 +204,7 @@ namespace
 namespace Dilithium
 {
 	Value::Value(Type* ty, uint32_t subclass_id)
-		: type_(ty), use_list_(nullptr), subclass_id_(static_cast<uint8_t>(subclass_id)),
+		: type_(ty), use_list_(nullptr), handle_list_(nullptr), subclass_id_(static_cast<uint8_t>(subclass_id)),
 			has_value_handle_(0), subclass_optional_data_(0), subclass_data_(0),
 			num_user_operands_(0), is_used_by_md_(false), name_hash_(0)
 	{
@@ -384,6 +384,19 @@ namespace Dilithium
 		return type_->Context();
 	}
 
+	uint32_t Value::NumValueHandles() const
+	{
+		uint32_t ret = 0;
+		if (has_value_handle_)
+		{
+			for (auto handle = handle_list_; handle; handle = handle->next_)
+			{
+				++ ret;
+			}
+		}
+		return ret;
+	}
+
 	void Value::SortUseList(std::function<bool(Use const & lhs, Use const & rhs)> cmp)
 	{
 		if (!use_list_ || !use_list_->next_)
@@ -460,7 +473,7 @@ namespace Dilithium
 		auto prev = &use_list_;
 		for (auto node = use_list_; node; node = node->next_)
 		{
-			node->prev_ptr_ = prev;
+			node->PrevPtr(prev);
 			prev = &node->next_;
 		}
 	}
@@ -493,33 +506,4 @@ namespace Dilithium
 		*next = l;
 		Value::MergeUseListsImpl(l->next_, r, &l->next_, cmp);
 	}
-
-	void Value::Print(std::ostream& os) const
-	{
-		DILITHIUM_UNUSED(os);
-		DILITHIUM_NOT_IMPLEMENTED;
-	}
-
-	void Value::Print(std::ostream& os, ModuleSlotTracker& mst) const
-	{
-		DILITHIUM_UNUSED(os);
-		DILITHIUM_UNUSED(mst);
-		DILITHIUM_NOT_IMPLEMENTED;
-	}
-
-	void Value::PrintAsOperand(std::ostream& os, bool print_type, LLVMModule const * mod) const
-	{
-		DILITHIUM_UNUSED(os);
-		DILITHIUM_UNUSED(print_type);
-		DILITHIUM_UNUSED(mod);
-		DILITHIUM_NOT_IMPLEMENTED;
-	}
-
-	void Value::PrintAsOperand(std::ostream& os, bool print_type, ModuleSlotTracker& mst) const
-	{
-		DILITHIUM_UNUSED(os);
-		DILITHIUM_UNUSED(print_type);
-		DILITHIUM_UNUSED(mst);
-		DILITHIUM_NOT_IMPLEMENTED;
-	}
 }
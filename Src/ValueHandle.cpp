@@ -33,9 +33,7 @@
  */
 
 #include <Dilithium/Dilithium.hpp>
-#include <Dilithium/LLVMContext.hpp>
 #include <Dilithium/ValueHandle.hpp>
-#include "LLVMContextImpl.hpp"
 
 #include <iostream>
 
@@ -112,8 +110,7 @@ namespace Dilithium
 	{
 		BOOST_ASSERT_MSG(val->has_value_handle_, "Should only be called if ValueHandles present");
 
-		auto& impl = val->Context().Impl();
-		auto entry = impl.value_handles[val];
+		auto entry = val->handle_list_;
 		BOOST_ASSERT_MSG(entry, "Value bit set but no entries exist");
 
 		for (ValueHandleBase iter(Assert, *entry); entry; entry = iter.next_)
@@ -143,7 +140,7 @@ namespace Dilithium
 #ifdef DILITHIUM_DEBUG
 			std::clog << "While deleting: " << *val->GetType() << " %" << val->Name()
 				<< std::endl;
-			if (impl.value_handles[val]->kind_ == Assert)
+			if (val->handle_list_->kind_ == Assert)
 			{
 				DILITHIUM_UNREACHABLE("An asserting value handle still pointed to this value!");
 			}
@@ -159,8 +156,7 @@ namespace Dilithium
 		BOOST_ASSERT_MSG(old_val != new_val, "Changing value into itself!");
 		BOOST_ASSERT_MSG(old_val->GetType() == new_val->GetType(), "replaceAllUses of value with new value of different type!");
 
-		auto& impl = old_val->Context().Impl();
-		auto entry = impl.value_handles[old_val];
+		auto entry = old_val->handle_list_;
 
 		BOOST_ASSERT_MSG(entry, "Value bit set but no entries exist");
 
@@ -187,7 +183,7 @@ namespace Dilithium
 #ifdef DILITHIUM_DEBUG
 		if (old_val->has_value_handle_)
 		{
-			for (entry = impl.value_handles[old_val]; entry; entry = entry->next_)
+			for (entry = old_val->handle_list_; entry; entry = entry->next_)
 			{
 				switch (entry->kind_)
 				{
@@ -236,27 +232,16 @@ namespace Dilithium
 	{
 		BOOST_ASSERT_MSG(val_, "Null pointer doesn't have a use list!");
 
-		auto& impl = val_->Context().Impl();
-
-		if (val_->has_value_handle_) {
-			auto& entry = impl.value_handles[val_];
-			BOOST_ASSERT_MSG(entry, "Value doesn't have any handles?");
-			this->AddToExistingUseList(&entry);
+		if (val_->has_value_handle_)
+		{
+			BOOST_ASSERT_MSG(val_->handle_list_, "Value doesn't have any handles?");
+			this->AddToExistingUseList(&val_->handle_list_);
 		}
 		else
 		{
-			auto& handles = impl.value_handles;
-
-			auto& entry = handles[val_];
-			BOOST_ASSERT_MSG(!entry, "Value really did already have handles?");
-			this->AddToExistingUseList(&entry);
+			BOOST_ASSERT_MSG(!val_->handle_list_, "Value really did already have handles?");
+			this->AddToExistingUseList(&val_->handle_list_);
 			val_->has_value_handle_ = true;
-
-			for (auto iter = handles.begin(), end_iter = handles.end(); iter != end_iter; ++ iter)
-			{
-				BOOST_ASSERT_MSG(iter->second && iter->first == iter->second->val_, "List invariant broken!");
-				iter->second->prev_ = &iter->second;
-			}
 		}
 	}
 
@@ -273,18 +258,10 @@ namespace Dilithium
 			BOOST_ASSERT_MSG(next_->prev_ == &next_, "List invariant broken");
 			next_->prev_ = prev_ptr;
 		}
-		else
+		else if (prev_ptr == &val_->handle_list_)
 		{
-			auto& handles = val_->Context().Impl().value_handles;
-			for (auto iter = handles.begin(), end_iter = handles.end(); iter != end_iter; ++ iter)
-			{
-				if (iter->second == *prev_ptr)
-				{
-					handles.erase(iter);
-					val_->has_value_handle_ = false;
-					break;
-				}
-			}
+			// This was the last handle watching the value.
+			val_->has_value_handle_ = false;
 		}
 	}
 }
@@ -0,0 +1,107 @@
+/**
+ * @file Benchmark.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+
+#include "Benchmark.hpp"
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	using namespace Dilithium::Benchmark;
+
+	std::vector<std::pair<char const *, BenchmarkFunc>>& Registry()
+	{
+		static std::vector<std::pair<char const *, BenchmarkFunc>> registry;
+		return registry;
+	}
+
+	uint64_t volatile consumed = 0;
+}
+
+namespace Dilithium
+{
+	namespace Benchmark
+	{
+		Registrar::Registrar(char const * name, BenchmarkFunc func)
+		{
+			Registry().emplace_back(name, func);
+		}
+
+		int RunBenchmarks(int num_names, char const * const * names)
+		{
+			int num_run = 0;
+			for (auto const & benchmark : Registry())
+			{
+				bool selected = (num_names == 0);
+				for (int i = 0; (i < num_names) && !selected; ++ i)
+				{
+					selected = (strcmp(names[i], benchmark.first) == 0);
+				}
+				if (selected)
+				{
+					benchmark.second();
+					++ num_run;
+				}
+			}
+
+			if (num_run == 0)
+			{
+				std::cerr << "No benchmark matches. Available benchmarks:" << std::endl;
+				for (auto const & benchmark : Registry())
+				{
+					std::cerr << "  " << benchmark.first << std::endl;
+				}
+				return 1;
+			}
+			return 0;
+		}
+
+		void Report(std::string_view benchmark, std::string_view measurement, double value, std::string_view unit)
+		{
+			std::cout << std::left << std::setw(24) << benchmark << ' ' << std::setw(48) << measurement << ' '
+				<< std::right << std::fixed << std::setprecision(2) << std::setw(14) << value << ' ' << unit << std::endl;
+		}
+
+		void Consume(uint64_t val)
+		{
+			consumed = consumed + val;
+		}
+	}
+}
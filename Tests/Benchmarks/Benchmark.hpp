@@ -0,0 +1,86 @@
+/**
+ * @file Benchmark.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DILITHIUM_BENCHMARK_HPP
+#define _DILITHIUM_BENCHMARK_HPP
+
+#pragma once
+
+#include <Dilithium/CXX17/string_view.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+namespace Dilithium
+{
+	namespace Benchmark
+	{
+		typedef void (*BenchmarkFunc)();
+
+		class Registrar
+		{
+		public:
+			Registrar(char const * name, BenchmarkFunc func);
+		};
+
+		// Runs every registered benchmark whose name is in names, or all of them if names is empty
+		int RunBenchmarks(int num_names, char const * const * names);
+
+		// Prints one result line: benchmark, what was measured, and the value
+		void Report(std::string_view benchmark, std::string_view measurement, double value, std::string_view unit);
+
+		// Folds a result into a volatile sink, so that the measured work can't be optimized away
+		void Consume(uint64_t val);
+
+		// Runs func the given number of times and returns the average time of one run in nanoseconds
+		template <typename Func>
+		double NanosecondsPerRun(uint32_t num_runs, Func&& func)
+		{
+			auto const start = std::chrono::high_resolution_clock::now();
+			for (uint32_t i = 0; i < num_runs; ++ i)
+			{
+				func();
+			}
+			auto const elapsed = std::chrono::high_resolution_clock::now() - start;
+			return std::chrono::duration<double, std::nano>(elapsed).count() / num_runs;
+		}
+	}
+}
+
+#define DILITHIUM_BENCHMARK(name) \
+	static void name(); \
+	static ::Dilithium::Benchmark::Registrar name##Registrar(#name, name); \
+	static void name()
+
+#endif		// _DILITHIUM_BENCHMARK_HPP
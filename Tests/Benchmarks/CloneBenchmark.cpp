@@ -0,0 +1,71 @@
+/**
+ * @file CloneBenchmark.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+
+#include "Benchmark.hpp"
+#include "TestUtil.hpp"
+
+using namespace Dilithium;
+using namespace Dilithium::Benchmark;
+using namespace Dilithium::Test;
+
+// Making a private copy of a loaded shader, by parsing the bitcode again or by LLVMModule::Clone
+DILITHIUM_BENCHMARK(CloneModule)
+{
+	uint32_t constexpr NUM_RUNS = 200;
+
+	auto context = std::make_shared<LLVMContext>();
+	for (auto const & name : TestShaderNames())
+	{
+		auto const container = LoadTestFile(name);
+		auto module = LoadTestModule(container, context);
+
+		double const load_ns = NanosecondsPerRun(NUM_RUNS, [&container, &context]
+			{
+				auto copy = LoadTestModule(container, context);
+				Consume(copy->size());
+			});
+		double const clone_ns = NanosecondsPerRun(NUM_RUNS, [&module]
+			{
+				auto copy = module->Clone();
+				Consume(copy->size());
+			});
+
+		Report(name, "LoadLLVMModule", load_ns / 1000, "us");
+		Report(name, "Clone", clone_ns / 1000, "us");
+	}
+}
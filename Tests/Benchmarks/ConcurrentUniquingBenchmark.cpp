@@ -0,0 +1,115 @@
+/**
+ * @file ConcurrentUniquingBenchmark.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/Constants.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/Metadata.hpp>
+
+#include "Benchmark.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Dilithium;
+using namespace Dilithium::Benchmark;
+
+namespace
+{
+	uint32_t constexpr NUM_KEYS = 4096;
+	uint32_t constexpr NUM_OPS_PER_THREAD = 400000;
+
+	// A mix of hits and misses on the sharded tables, like a loader asking for the types and constants of a shader
+	void UniquingWork(LLVMContext& context, uint32_t thread_index, std::vector<std::string> const & strs)
+	{
+		auto i32_ty = Type::Int32Type(context);
+		auto float_ty = Type::FloatType(context);
+
+		uint64_t sum = 0;
+		for (uint32_t n = 0; n < NUM_OPS_PER_THREAD; n += 4)
+		{
+			uint32_t const i = (n / 4 * 7 + thread_index * 997) % NUM_KEYS;
+
+			Type* params[] = { (i & 1) ? float_ty : i32_ty, (i & 2) ? float_ty : i32_ty, i32_ty };
+			sum += reinterpret_cast<uintptr_t>(FunctionType::Get(i32_ty, params, false));
+			sum += reinterpret_cast<uintptr_t>(ConstantInt::Get(IntegerType::Get(context, 64), i * 1000003ULL));
+			auto str = MDString::Get(context, strs[i]);
+			sum += reinterpret_cast<uintptr_t>(str);
+			Metadata* ops[] = { str };
+			sum += reinterpret_cast<uintptr_t>(MDNode::Get(context, ops));
+		}
+		Consume(sum);
+	}
+
+	double OpsPerMicrosecond(uint32_t num_threads, bool concurrent)
+	{
+		std::vector<std::string> strs(NUM_KEYS);
+		for (uint32_t i = 0; i < NUM_KEYS; ++ i)
+		{
+			strs[i] = "dx.benchmark.str" + std::to_string(i);
+		}
+
+		LLVMContext context;
+		context.ConcurrentUniquing(concurrent);
+
+		auto const start = std::chrono::high_resolution_clock::now();
+		std::vector<std::thread> threads;
+		for (uint32_t i = 0; i < num_threads; ++ i)
+		{
+			threads.emplace_back(UniquingWork, std::ref(context), i, std::cref(strs));
+		}
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+		auto const elapsed = std::chrono::high_resolution_clock::now() - start;
+
+		return static_cast<double>(num_threads) * NUM_OPS_PER_THREAD / std::chrono::duration<double, std::micro>(elapsed).count();
+	}
+}
+
+// Throughput of the Get functions on one shared context, as the number of threads grows
+DILITHIUM_BENCHMARK(ConcurrentUniquing)
+{
+	Report("ConcurrentUniquing", "1 thread, concurrent mode off", OpsPerMicrosecond(1, false), "ops/us");
+	for (uint32_t num_threads = 1; num_threads <= 8; num_threads *= 2)
+	{
+		Report("ConcurrentUniquing", std::to_string(num_threads) + ((num_threads == 1) ? " thread" : " threads"),
+			OpsPerMicrosecond(num_threads, true), "ops/us");
+	}
+	Report("ConcurrentUniquing", "Hardware threads", std::thread::hardware_concurrency(), "");
+}
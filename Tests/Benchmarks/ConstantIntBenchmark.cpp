@@ -0,0 +1,124 @@
+/**
+ * @file ConstantIntBenchmark.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/Constants.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+
+#include "Benchmark.hpp"
+#include "TestUtil.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace Dilithium;
+using namespace Dilithium::Benchmark;
+using namespace Dilithium::Test;
+
+// ConstantInt::Get on values in the direct-indexed small range, against values that go through the hash set
+DILITHIUM_BENCHMARK(ConstantIntGet)
+{
+	uint32_t constexpr NUM_VALUES = 1024;
+	uint32_t constexpr NUM_RUNS = 1000;
+
+	LLVMContext context;
+	auto i32_ty = Type::Int32Type(context);
+	auto i8_ty = Type::Int8Type(context);
+
+	// The operands of a dx.op call: opcode, then small indices and masks
+	std::vector<uint64_t> small_values(NUM_VALUES);
+	std::vector<uint64_t> large_values(NUM_VALUES);
+	for (uint32_t i = 0; i < NUM_VALUES; ++ i)
+	{
+		small_values[i] = (i * 7) % 200;
+		large_values[i] = 0x10000 + i * 4093;
+		ConstantInt::Get(i32_ty, small_values[i]);
+		ConstantInt::Get(i32_ty, large_values[i]);
+	}
+
+	double const small_i32_ns = NanosecondsPerRun(NUM_RUNS, [&]
+		{
+			uint64_t sum = 0;
+			for (auto v : small_values)
+			{
+				sum += reinterpret_cast<uintptr_t>(ConstantInt::Get(i32_ty, v));
+			}
+			Consume(sum);
+		});
+	double const small_i8_ns = NanosecondsPerRun(NUM_RUNS, [&]
+		{
+			uint64_t sum = 0;
+			for (auto v : small_values)
+			{
+				sum += reinterpret_cast<uintptr_t>(ConstantInt::Get(i8_ty, v & 0xF));
+			}
+			Consume(sum);
+		});
+	double const large_i32_ns = NanosecondsPerRun(NUM_RUNS, [&]
+		{
+			uint64_t sum = 0;
+			for (auto v : large_values)
+			{
+				sum += reinterpret_cast<uintptr_t>(ConstantInt::Get(i32_ty, v));
+			}
+			Consume(sum);
+		});
+
+	Report("ConstantIntGet", "Small i32", small_i32_ns / NUM_VALUES, "ns");
+	Report("ConstantIntGet", "Small i8", small_i8_ns / NUM_VALUES, "ns");
+	Report("ConstantIntGet", "Large i32", large_i32_ns / NUM_VALUES, "ns");
+}
+
+// Module loading into a warm context, per test shader. Their constant tables are mostly dx.op opcodes and indices.
+DILITHIUM_BENCHMARK(ConstantIntLoad)
+{
+	uint32_t constexpr NUM_RUNS = 200;
+
+	for (auto const & name : TestShaderNames())
+	{
+		auto const container = LoadTestFile(name);
+
+		auto context = std::make_shared<LLVMContext>();
+		LoadTestModule(container, context);
+		double const load_ns = NanosecondsPerRun(NUM_RUNS, [&container, &context]
+			{
+				auto module = LoadTestModule(container, context);
+				Consume(module->size());
+			});
+
+		Report("ConstantIntLoad", name, load_ns / 1000, "us");
+	}
+}
@@ -0,0 +1,96 @@
+/**
+ * @file DxilPreludeBenchmark.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+
+#include "Benchmark.hpp"
+#include "TestUtil.hpp"
+
+using namespace Dilithium;
+using namespace Dilithium::Benchmark;
+using namespace Dilithium::Test;
+
+// Loading into a fresh context, and then into a warm one, with and without building the DXIL prelude first
+DILITHIUM_BENCHMARK(DxilPreludeLoad)
+{
+	uint32_t constexpr NUM_RUNS = 200;
+
+	auto const container = LoadTestFile("Pixel/Constant.cso");
+
+	for (bool with_prelude : { false, true })
+	{
+		std::string const suffix = with_prelude ? ", with prelude" : ", without prelude";
+
+		double const first_ns = NanosecondsPerRun(NUM_RUNS, [&container, with_prelude]
+			{
+				auto context = std::make_shared<LLVMContext>();
+				if (with_prelude)
+				{
+					context->GetDxilPrelude();
+				}
+				auto module = LoadTestModule(container, context);
+				Consume(module->size());
+			});
+
+		auto context = std::make_shared<LLVMContext>();
+		if (with_prelude)
+		{
+			context->GetDxilPrelude();
+		}
+		LoadTestModule(container, context);
+		double const next_ns = NanosecondsPerRun(NUM_RUNS, [&container, &context]
+			{
+				auto module = LoadTestModule(container, context);
+				Consume(module->size());
+			});
+
+		Report("DxilPreludeLoad", "Time to first module" + suffix, first_ns / 1000, "us");
+		Report("DxilPreludeLoad", "Per module load" + suffix, next_ns / 1000, "us");
+	}
+
+	double const context_ns = NanosecondsPerRun(NUM_RUNS, []
+		{
+			auto context = std::make_shared<LLVMContext>();
+			Consume(reinterpret_cast<uintptr_t>(context.get()));
+		});
+	double const prelude_ns = NanosecondsPerRun(NUM_RUNS, []
+		{
+			auto context = std::make_shared<LLVMContext>();
+			Consume(reinterpret_cast<uintptr_t>(&context->GetDxilPrelude()));
+		});
+	Report("DxilPreludeLoad", "Creating a context", context_ns / 1000, "us");
+	Report("DxilPreludeLoad", "Creating a context and its prelude", prelude_ns / 1000, "us");
+}
@@ -0,0 +1,95 @@
+/**
+ * @file HalfBenchmark.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/Half.hpp>
+
+#include "Benchmark.hpp"
+
+#include <cstring>
+#include <vector>
+
+using namespace Dilithium;
+using namespace Dilithium::Benchmark;
+
+// The bulk conversions against converting the values one by one, over all 65536 halves
+DILITHIUM_BENCHMARK(HalfConversion)
+{
+	uint32_t constexpr NUM_VALUES = 65536;
+	uint32_t constexpr NUM_RUNS = 200;
+
+	std::vector<half> halves(NUM_VALUES);
+	for (uint32_t i = 0; i < NUM_VALUES; ++ i)
+	{
+		uint16_t const bits = static_cast<uint16_t>(i);
+		memcpy(&halves[i], &bits, sizeof(bits));
+	}
+	std::vector<float> floats(NUM_VALUES);
+	ConvertHalfToFloat(halves, floats.data());
+
+	std::vector<float> float_out(NUM_VALUES);
+	std::vector<half> half_out(NUM_VALUES);
+
+	double const scalar_to_float_ns = NanosecondsPerRun(NUM_RUNS, [&]
+		{
+			for (uint32_t i = 0; i < NUM_VALUES; ++ i)
+			{
+				float_out[i] = halves[i];
+			}
+			Consume(static_cast<uint64_t>(float_out[NUM_VALUES / 3]));
+		});
+	double const bulk_to_float_ns = NanosecondsPerRun(NUM_RUNS, [&]
+		{
+			ConvertHalfToFloat(halves, float_out.data());
+			Consume(static_cast<uint64_t>(float_out[NUM_VALUES / 3]));
+		});
+	double const scalar_to_half_ns = NanosecondsPerRun(NUM_RUNS, [&]
+		{
+			for (uint32_t i = 0; i < NUM_VALUES; ++ i)
+			{
+				half_out[i] = half(floats[i]);
+			}
+			Consume(static_cast<uint64_t>(static_cast<float>(half_out[NUM_VALUES / 3])));
+		});
+	double const bulk_to_half_ns = NanosecondsPerRun(NUM_RUNS, [&]
+		{
+			ConvertFloatToHalf(floats, half_out.data());
+			Consume(static_cast<uint64_t>(static_cast<float>(half_out[NUM_VALUES / 3])));
+		});
+
+	Report("HalfConversion", "half to float, one by one", scalar_to_float_ns / NUM_VALUES, "ns");
+	Report("HalfConversion", "half to float, ConvertHalfToFloat", bulk_to_float_ns / NUM_VALUES, "ns");
+	Report("HalfConversion", "float to half, one by one", scalar_to_half_ns / NUM_VALUES, "ns");
+	Report("HalfConversion", "float to half, ConvertFloatToHalf", bulk_to_half_ns / NUM_VALUES, "ns");
+}
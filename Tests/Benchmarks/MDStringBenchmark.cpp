@@ -0,0 +1,99 @@
+/**
+ * @file MDStringBenchmark.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/MemoryUsage.hpp>
+#include <Dilithium/Metadata.hpp>
+
+#include "Benchmark.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Dilithium;
+using namespace Dilithium::Benchmark;
+
+// Building string-heavy metadata like dx.resources and dx.entryPoints: many distinct names, each in a small node
+DILITHIUM_BENCHMARK(MDStringMetadata)
+{
+	uint32_t constexpr NUM_STRINGS = 20000;
+	uint32_t constexpr NUM_RUNS = 20;
+
+	std::vector<std::string> strs(NUM_STRINGS);
+	for (uint32_t i = 0; i < NUM_STRINGS; ++ i)
+	{
+		strs[i] = "g_resource_with_a_fairly_long_name_" + std::to_string(i);
+	}
+
+	double const create_ns = NanosecondsPerRun(NUM_RUNS, [&strs]
+		{
+			LLVMContext context;
+			for (auto const & str : strs)
+			{
+				Metadata* ops[] = { MDString::Get(context, str) };
+				MDNode::Get(context, ops);
+			}
+			Consume(strs.size());
+		});
+
+	LLVMContext context;
+	for (auto const & str : strs)
+	{
+		MDString::Get(context, str);
+	}
+	double const hit_ns = NanosecondsPerRun(NUM_RUNS, [&strs, &context]
+		{
+			uint64_t sum = 0;
+			for (auto const & str : strs)
+			{
+				sum += MDString::Get(context, str)->Size();
+			}
+			Consume(sum);
+		});
+
+	std::vector<MemoryUsage> stats;
+	context.MemoryStats(stats);
+	for (auto const & stat : stats)
+	{
+		if (strcmp(stat.name, "MDStrings") == 0)
+		{
+			Report("MDStringMetadata", "Bytes per MDString", static_cast<double>(stat.bytes) / stat.count, "B");
+		}
+	}
+
+	Report("MDStringMetadata", "Create string and node", create_ns / NUM_STRINGS, "ns");
+	Report("MDStringMetadata", "MDString::Get hit", hit_ns / NUM_STRINGS, "ns");
+}
@@ -0,0 +1,108 @@
+/**
+ * @file MPIntBenchmark.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/MPFloat.hpp>
+#include <Dilithium/MPInt.hpp>
+
+#include "Benchmark.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace Dilithium;
+using namespace Dilithium::Benchmark;
+
+namespace
+{
+	std::vector<MPInt> RandomMPInts(uint32_t num_bits, uint32_t num_values)
+	{
+		std::mt19937_64 gen(42);
+		std::vector<MPInt> values;
+		values.reserve(num_values);
+		for (uint32_t i = 0; i < num_values; ++ i)
+		{
+			uint64_t const words[] = { gen(), gen() };
+			values.emplace_back(num_bits, ArrayRef<uint64_t>(words, (num_bits + 63) / 64));
+		}
+		return values;
+	}
+}
+
+// The single-word fast paths against the same operations on two words
+DILITHIUM_BENCHMARK(MPIntArithmetic)
+{
+	uint32_t constexpr NUM_VALUES = 4096;
+	uint32_t constexpr NUM_RUNS = 200;
+
+	for (uint32_t num_bits : { 64U, 128U })
+	{
+		std::vector<MPInt> const values = RandomMPInts(num_bits, NUM_VALUES);
+		std::string const width = "i" + std::to_string(num_bits);
+
+		double const add_ns = NanosecondsPerRun(NUM_RUNS, [&]
+			{
+				MPInt sum(num_bits, 0);
+				for (auto const & val : values)
+				{
+					sum = sum + val;
+				}
+				Consume(sum.RawData()[0]);
+			});
+		double const shl_ns = NanosecondsPerRun(NUM_RUNS, [&]
+			{
+				uint64_t sum = 0;
+				for (uint32_t i = 0; i < NUM_VALUES; ++ i)
+				{
+					sum += values[i].Shl(i % num_bits).RawData()[0];
+				}
+				Consume(sum);
+			});
+		double const convert_ns = NanosecondsPerRun(NUM_RUNS, [&]
+			{
+				double sum = 0;
+				for (auto const & val : values)
+				{
+					MPFloat f(MPFloat::IEEEDouble);
+					f.ConvertFromMPInt(val, true);
+					sum += f.ConvertToDouble();
+				}
+				Consume(static_cast<uint64_t>(sum != 0));
+			});
+
+		Report("MPIntArithmetic", width + " operator+", add_ns / NUM_VALUES, "ns");
+		Report("MPIntArithmetic", width + " Shl", shl_ns / NUM_VALUES, "ns");
+		Report("MPIntArithmetic", width + " ConvertFromMPInt to double", convert_ns / NUM_VALUES, "ns");
+	}
+}
@@ -0,0 +1,96 @@
+/**
+ * @file MetadataLoadBenchmark.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/Constants.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/Metadata.hpp>
+
+#include "LLVMContextImpl.hpp"
+
+#include "Benchmark.hpp"
+
+#include <vector>
+
+using namespace Dilithium;
+using namespace Dilithium::Benchmark;
+
+// Uniquing a block of nodes operands first, as the bitcode reader does, with and without presizing the MDTuple store.
+// Only the node building is timed. The two variants alternate, so they see the same allocator state.
+DILITHIUM_BENCHMARK(MetadataBulkBuild)
+{
+	uint32_t constexpr NUM_NODES = 20000;
+	uint32_t constexpr NUM_RUNS = 20;
+
+	double build_ns[2] = { 0, 0 };
+	std::vector<MDNode*> nodes(NUM_NODES);
+	for (uint32_t run = 0; run < NUM_RUNS; ++ run)
+	{
+		for (bool presize : { false, true })
+		{
+			LLVMContext context;
+			auto i32_ty = Type::Int32Type(context);
+			std::vector<Metadata*> values(NUM_NODES);
+			for (uint32_t i = 0; i < NUM_NODES; ++ i)
+			{
+				values[i] = ValueAsMetadata::Get(ConstantInt::Get(i32_ty, i));
+			}
+
+			build_ns[presize] += NanosecondsPerRun(1, [&]
+				{
+					if (presize)
+					{
+						context.Impl().MDTuples.Reserve(false, NUM_NODES);
+					}
+
+					// Every node refers to a value and to two earlier nodes, like the nested resource and signature tuples
+					for (uint32_t i = 0; i < NUM_NODES; ++ i)
+					{
+						Metadata* ops[] =
+						{
+							values[i],
+							(i > 0) ? nodes[i - 1] : nullptr,
+							(i > 1) ? nodes[i / 2] : nullptr
+						};
+						nodes[i] = MDNode::Get(context, ops);
+					}
+					Consume(reinterpret_cast<uintptr_t>(nodes.back()));
+				});
+		}
+	}
+
+	Report("MetadataBulkBuild", "Per node, growing", build_ns[false] / NUM_RUNS / NUM_NODES, "ns");
+	Report("MetadataBulkBuild", "Per node, presized", build_ns[true] / NUM_RUNS / NUM_NODES, "ns");
+}
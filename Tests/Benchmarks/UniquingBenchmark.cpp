@@ -0,0 +1,171 @@
+/**
+ * @file UniquingBenchmark.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/Metadata.hpp>
+
+#include "UniquingSet.hpp"
+
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
+using namespace Dilithium;
+using namespace Dilithium::Benchmark;
+
+namespace
+{
+	struct Key
+	{
+		uint64_t value;
+	};
+}
+
+// Hits in a UniquingSet against the std::unordered_map keyed by hash it replaced
+DILITHIUM_BENCHMARK(UniquingSetLookup)
+{
+	uint32_t constexpr NUM_KEYS = 100000;
+	uint32_t constexpr NUM_RUNS = 20;
+
+	std::vector<Key> keys(NUM_KEYS);
+	std::vector<uint64_t> hashes(NUM_KEYS);
+	UniquingSet<Key> set;
+	std::unordered_map<uint64_t, Key*> map;
+	for (uint32_t i = 0; i < NUM_KEYS; ++ i)
+	{
+		keys[i].value = i;
+		hashes[i] = boost::hash_value(i);
+		set.Insert(hashes[i], &keys[i]);
+		map.emplace(hashes[i], &keys[i]);
+	}
+
+	std::vector<uint32_t> order(NUM_KEYS);
+	for (uint32_t i = 0; i < NUM_KEYS; ++ i)
+	{
+		order[i] = i;
+	}
+	std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+	double const set_ns = NanosecondsPerRun(NUM_RUNS, [&]
+		{
+			uint64_t sum = 0;
+			for (auto i : order)
+			{
+				sum += set.Find(hashes[i], [i](Key const * key)
+					{
+						return key->value == i;
+					})->value;
+			}
+			Consume(sum);
+		});
+	double const map_ns = NanosecondsPerRun(NUM_RUNS, [&]
+		{
+			uint64_t sum = 0;
+			for (auto i : order)
+			{
+				sum += map.find(hashes[i])->second->value;
+			}
+			Consume(sum);
+		});
+
+	Report("UniquingSetLookup", "UniquingSet::Find", set_ns / NUM_KEYS, "ns");
+	Report("UniquingSetLookup", "std::unordered_map::find", map_ns / NUM_KEYS, "ns");
+}
+
+// The Get functions on the context, all hitting an existing object
+DILITHIUM_BENCHMARK(ContextUniquingLookup)
+{
+	uint32_t constexpr NUM_OBJECTS = 4096;
+	uint32_t constexpr NUM_RUNS = 50;
+
+	LLVMContext context;
+	auto i32_ty = Type::Int32Type(context);
+	auto float_ty = Type::FloatType(context);
+
+	std::vector<std::vector<Type*>> params(NUM_OBJECTS);
+	std::vector<std::string> strs(NUM_OBJECTS);
+	std::vector<Metadata*> md_strs(NUM_OBJECTS);
+	for (uint32_t i = 0; i < NUM_OBJECTS; ++ i)
+	{
+		for (uint32_t j = 0; j < 12; ++ j)
+		{
+			params[i].push_back((i & (1U << j)) ? float_ty : i32_ty);
+		}
+		FunctionType::Get(i32_ty, params[i], false);
+
+		strs[i] = "dx.benchmark.str" + std::to_string(i);
+		md_strs[i] = MDString::Get(context, strs[i]);
+		MDNode::Get(context, ArrayRef<Metadata*>(&md_strs[i], 1));
+	}
+
+	double const func_ty_ns = NanosecondsPerRun(NUM_RUNS, [&]
+		{
+			uint64_t sum = 0;
+			for (uint32_t i = 0; i < NUM_OBJECTS; ++ i)
+			{
+				sum += reinterpret_cast<uintptr_t>(FunctionType::Get(i32_ty, params[i], false));
+			}
+			Consume(sum);
+		});
+	double const str_ns = NanosecondsPerRun(NUM_RUNS, [&]
+		{
+			uint64_t sum = 0;
+			for (uint32_t i = 0; i < NUM_OBJECTS; ++ i)
+			{
+				sum += reinterpret_cast<uintptr_t>(MDString::Get(context, strs[i]));
+			}
+			Consume(sum);
+		});
+	double const tuple_ns = NanosecondsPerRun(NUM_RUNS, [&]
+		{
+			uint64_t sum = 0;
+			for (uint32_t i = 0; i < NUM_OBJECTS; ++ i)
+			{
+				sum += reinterpret_cast<uintptr_t>(MDNode::Get(context, ArrayRef<Metadata*>(&md_strs[i], 1)));
+			}
+			Consume(sum);
+		});
+
+	Report("ContextUniquingLookup", "FunctionType::Get", func_ty_ns / NUM_OBJECTS, "ns");
+	Report("ContextUniquingLookup", "MDString::Get", str_ns / NUM_OBJECTS, "ns");
+	Report("ContextUniquingLookup", "MDNode::Get", tuple_ns / NUM_OBJECTS, "ns");
+}
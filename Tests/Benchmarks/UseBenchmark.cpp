@@ -0,0 +1,145 @@
+/**
+ * @file UseBenchmark.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/BasicBlock.hpp>
+#include <Dilithium/Constants.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/Function.hpp>
+#include <Dilithium/Instructions.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+#include <Dilithium/MemoryUsage.hpp>
+#include <Dilithium/Use.hpp>
+
+#include "Benchmark.hpp"
+
+#include <cstring>
+#include <vector>
+
+using namespace Dilithium;
+using namespace Dilithium::Benchmark;
+
+namespace
+{
+	uint32_t constexpr NUM_CALLS = 100000;
+	uint32_t constexpr NUM_ARGS = 8;
+
+	// A dx.op-like module: one function with many calls that take a handful of small constants each
+	std::unique_ptr<LLVMModule> CreateCallHeavyModule(std::shared_ptr<LLVMContext> const & context, Constant*& shared_arg)
+	{
+		auto module = std::make_unique<LLVMModule>("UseBenchmark", context);
+		auto i32_ty = Type::Int32Type(*context);
+
+		std::vector<Type*> param_tys(NUM_ARGS, i32_ty);
+		auto callee = Function::Create(FunctionType::Get(Type::VoidType(*context), param_tys, false),
+			GlobalValue::ExternalLinkage, "dx.op.bench", module.get());
+		auto main = Function::Create(FunctionType::Get(Type::VoidType(*context), false),
+			GlobalValue::ExternalLinkage, "main", module.get());
+		auto bb = BasicBlock::Create(*context, "entry", main);
+
+		shared_arg = ConstantInt::Get(i32_ty, 0);
+		std::vector<Value*> args(NUM_ARGS);
+		for (uint32_t i = 0; i < NUM_CALLS; ++ i)
+		{
+			args[0] = shared_arg;
+			for (uint32_t j = 1; j < NUM_ARGS; ++ j)
+			{
+				args[j] = ConstantInt::Get(i32_ty, (i + j) & 15);
+			}
+			CallInst::Create(callee, args, "", bb);
+		}
+		ReturnInst::Create(*context, bb);
+
+		return module;
+	}
+}
+
+DILITHIUM_BENCHMARK(UseMemory)
+{
+	auto context = std::make_shared<LLVMContext>();
+	Constant* shared_arg;
+	auto module = CreateCallHeavyModule(context, shared_arg);
+
+	std::vector<MemoryUsage> stats;
+	module->MemoryStats(stats);
+	for (auto const & stat : stats)
+	{
+		if ((strcmp(stat.name, "Uses") == 0) || (strcmp(stat.name, "Instructions") == 0))
+		{
+			Report("UseMemory", std::string(stat.name) + " count", static_cast<double>(stat.count), "");
+			Report("UseMemory", std::string(stat.name) + " size", stat.bytes / 1048576.0, "MB");
+		}
+	}
+	// Before the tag was packed into the prev pointer, a Use was val, next and prev pointers plus a tag field,
+	// padded to 4 pointers
+	Report("UseMemory", "sizeof(Use)", static_cast<double>(sizeof(Use)), "bytes");
+	Report("UseMemory", "sizeof(Use) with a separate tag", static_cast<double>(4 * sizeof(void*)), "bytes");
+	// Every call has its arguments, the callee and the sentinel
+	Report("UseMemory", "Saved by packing the tag, per call",
+		static_cast<double>((NUM_ARGS + 2) * (4 * sizeof(void*) - sizeof(Use))), "bytes");
+}
+
+DILITHIUM_BENCHMARK(UseListWalk)
+{
+	auto context = std::make_shared<LLVMContext>();
+	Constant* shared_arg;
+	auto module = CreateCallHeavyModule(context, shared_arg);
+
+	// Every call uses shared_arg once, so its use list has NUM_CALLS entries. GetUser does the waymarking walk.
+	uint32_t constexpr NUM_RUNS = 20;
+	auto walk = [shared_arg]
+		{
+			uint64_t sum = 0;
+			for (auto const & use : shared_arg->Uses())
+			{
+				sum += reinterpret_cast<uintptr_t>(use.Get());
+			}
+			Consume(sum);
+		};
+	walk();
+	double const walk_ns = NanosecondsPerRun(NUM_RUNS, walk);
+	double const user_ns = NanosecondsPerRun(NUM_RUNS, [shared_arg]
+		{
+			uint64_t sum = 0;
+			for (auto const & use : shared_arg->Uses())
+			{
+				sum += reinterpret_cast<uintptr_t>(use.GetUser());
+			}
+			Consume(sum);
+		});
+
+	Report("UseListWalk", "Walk the use list, per use", walk_ns / NUM_CALLS, "ns");
+	Report("UseListWalk", "Walk the use list and GetUser, per use", user_ns / NUM_CALLS, "ns");
+}
@@ -0,0 +1,104 @@
+/**
+ * @file TestUtil.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/BitcodeReader.hpp>
+#include <Dilithium/LLVMModule.hpp>
+#include <Dilithium/RawOStream.hpp>
+#include <Dilithium/dxc/HLSL/DxilContainer.hpp>
+
+#include "TestUtil.hpp"
+
+#include <fstream>
+#include <iterator>
+
+namespace Dilithium
+{
+	namespace Test
+	{
+		std::vector<uint8_t> LoadTestFile(std::string const & name)
+		{
+			std::ifstream file(std::string(DILITHIUM_TEST_DATA_DIR) + "/" + name, std::ios_base::binary);
+			if (!file)
+			{
+				TERROR(("Could not open test file " + name).c_str());
+			}
+			return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+
+		std::unique_ptr<LLVMModule> LoadTestModule(std::string const & name, std::shared_ptr<LLVMContext> const & context)
+		{
+			return LoadTestModule(LoadTestFile(name), context);
+		}
+
+		std::unique_ptr<LLVMModule> LoadTestModule(std::vector<uint8_t> const & container,
+			std::shared_ptr<LLVMContext> const & context)
+		{
+			DxilContainerReader reader;
+			if (!reader.Load(container.data(), container.size()))
+			{
+				TERROR("Invalid DXIL container");
+			}
+			auto program_header = reader.GetProgramHeader();
+			if (!program_header)
+			{
+				TERROR("The container has no DXIL program");
+			}
+
+			uint8_t const * bitcode;
+			uint32_t bitcode_length;
+			GetDxilProgramBitcode(program_header, &bitcode, &bitcode_length);
+			return LoadLLVMModule(bitcode, bitcode_length, "", context);
+		}
+
+		std::string PrintModule(LLVMModule const & module)
+		{
+			RawOStream os;
+			module.Print(os, nullptr);
+			return std::string(os.Str());
+		}
+
+		std::vector<std::string> const & TestShaderNames()
+		{
+			static std::vector<std::string> const names =
+			{
+				"Pixel/Constant.cso",
+				"Pixel/PassThrough.cso",
+				"Vertex/Constant.cso",
+				"Vertex/PassThrough.cso"
+			};
+			return names;
+		}
+	}
+}
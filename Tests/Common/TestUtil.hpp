@@ -0,0 +1,68 @@
+/**
+ * @file TestUtil.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DILITHIUM_TEST_UTIL_HPP
+#define _DILITHIUM_TEST_UTIL_HPP
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Dilithium
+{
+	class LLVMContext;
+	class LLVMModule;
+
+	namespace Test
+	{
+		// Reads a file under the Tests folder, such as "Pixel/Constant.cso"
+		std::vector<uint8_t> LoadTestFile(std::string const & name);
+
+		// Loads the DXIL program of a compiled shader under the Tests folder
+		std::unique_ptr<LLVMModule> LoadTestModule(std::string const & name, std::shared_ptr<LLVMContext> const & context);
+		std::unique_ptr<LLVMModule> LoadTestModule(std::vector<uint8_t> const & container,
+			std::shared_ptr<LLVMContext> const & context);
+
+		// The textual IR, as DilithiumDisasm would write it
+		std::string PrintModule(LLVMModule const & module);
+
+		// The compiled shaders under the Tests folder
+		std::vector<std::string> const & TestShaderNames();
+	}
+}
+
+#endif		// _DILITHIUM_TEST_UTIL_HPP
@@ -0,0 +1,183 @@
+/**
+ * @file AsmWriterTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/AsmWriter.hpp>
+#include <Dilithium/BasicBlock.hpp>
+#include <Dilithium/Constants.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/Function.hpp>
+#include <Dilithium/GlobalVariable.hpp>
+#include <Dilithium/Instructions.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+#include <Dilithium/Metadata.hpp>
+#include <Dilithium/RawOStream.hpp>
+
+#include "TestUtil.hpp"
+
+#include <sstream>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+using namespace Dilithium::Test;
+
+namespace
+{
+	// A module of num_funcs functions, each with unnamed values, a named value, a function-local metadata operand and
+	// metadata attachments of its own, so that every function has something to number
+	std::unique_ptr<LLVMModule> MakeModule(std::shared_ptr<LLVMContext> const & context, uint32_t num_funcs)
+	{
+		auto module = std::make_unique<LLVMModule>("AsmWriter", context);
+
+		auto float_ty = Type::FloatType(*context);
+		auto md_ty = Type::MetadataType(*context);
+		auto op = Function::Create(FunctionType::Get(float_ty, { float_ty, float_ty }, false), GlobalValue::ExternalLinkage,
+			"dx.op.binary.f32", module.get());
+		auto use_md = Function::Create(FunctionType::Get(Type::VoidType(*context), md_ty, false),
+			GlobalValue::ExternalLinkage, "use.md", module.get());
+
+		for (uint32_t i = 0; i < num_funcs; ++ i)
+		{
+			auto func = Function::Create(FunctionType::Get(Type::VoidType(*context), false), GlobalValue::ExternalLinkage,
+				"func" + std::to_string(i), module.get());
+			auto bb = BasicBlock::Create(*context, "", func);
+
+			auto v0 = CallInst::Create(op, { ConstantFP::Get(float_ty, 1.0), ConstantFP::Get(float_ty, 2.0) }, "", bb);
+			auto v1 = CallInst::Create(op, { v0, ConstantFP::Get(float_ty, static_cast<double>(i)) }, "", bb);
+			auto named = CallInst::Create(op, { v1, v0 }, "sum", bb);
+			CallInst::Create(use_md, { MetadataAsValue::Get(*context, LocalAsMetadata::Get(v1)) }, "", bb);
+
+			Metadata* ops[] = { MDString::Get(*context, "func" + std::to_string(i)), ValueAsMetadata::Get(func) };
+			named->SetMetadata("test.uniqued", MDNode::Get(*context, ops));
+			v1->SetMetadata("test.distinct", MDNode::GetDistinct(*context, ops));
+
+			ReturnInst::Create(*context, bb);
+		}
+
+		return module;
+	}
+
+	std::string PrintModule(LLVMModule const & module, uint32_t num_threads)
+	{
+		RawOStream os;
+		module.Print(os, nullptr, num_threads);
+		return std::string(os.Str());
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(AsmWriterTest)
+
+// Printing the functions in parallel gives the same text as printing them one after another
+BOOST_AUTO_TEST_CASE(ParallelMatchesSerial)
+{
+	auto context = std::make_shared<LLVMContext>();
+	for (uint32_t num_funcs : { 1U, 2U, 7U, 64U })
+	{
+		auto module = MakeModule(context, num_funcs);
+		std::string const serial = PrintModule(*module, 1);
+		BOOST_TEST(serial.find("<badref>") == std::string::npos);
+		BOOST_TEST(serial.find("define void @func" + std::to_string(num_funcs - 1)) != std::string::npos);
+		for (uint32_t num_threads : { 0U, 2U, 3U, 8U, 100U })
+		{
+			BOOST_TEST_INFO(num_funcs << " functions on " << num_threads << " threads");
+			BOOST_TEST(PrintModule(*module, num_threads) == serial);
+		}
+	}
+
+	for (auto const & name : TestShaderNames())
+	{
+		auto module = LoadTestModule(name, context);
+		BOOST_TEST_INFO(name);
+		BOOST_TEST(PrintModule(*module, 4) == PrintModule(*module, 1));
+	}
+}
+
+// Printing a function through a ModuleSlotTracker keeps its values numbered for the values printed after it
+BOOST_AUTO_TEST_CASE(SlotTrackerReuse)
+{
+	auto context = std::make_shared<LLVMContext>();
+	auto module = MakeModule(context, 2);
+	auto func = module->FunctionList().back().get();
+	auto const & inst = *func->front().InstList().front();
+
+	ModuleSlotTracker mst(module.get());
+	std::ostringstream before;
+	inst.Print(before, mst);
+	BOOST_TEST(before.str().find("<badref>") == std::string::npos);
+
+	std::ostringstream func_text;
+	func->Print(func_text, mst);
+	BOOST_TEST(func_text.str().find("<badref>") == std::string::npos);
+	BOOST_TEST(func_text.str().find(before.str()) != std::string::npos);
+
+	std::ostringstream after;
+	inst.Print(after, mst);
+	BOOST_TEST(after.str() == before.str());
+}
+
+BOOST_AUTO_TEST_CASE(GlobalVariables)
+{
+	auto context = std::make_shared<LLVMContext>();
+	auto float_ty = Type::FloatType(*context);
+
+	std::unique_ptr<GlobalVariable> constant(GlobalVariable::Create(float_ty, true, GlobalValue::InternalLinkage,
+		ConstantFP::Get(float_ty, 1.0), "g"));
+	constant->SetAlignment(4);
+	BOOST_TEST(constant->HasInitializer());
+
+	std::ostringstream ss;
+	constant->Print(ss);
+	BOOST_TEST(ss.str() == "@g = internal constant float 1.0, align 4");
+
+	std::unique_ptr<GlobalVariable> external(GlobalVariable::Create(float_ty, false, GlobalValue::ExternalLinkage,
+		nullptr, "ext", 3));
+	BOOST_TEST(!external->HasInitializer());
+
+	ss.str("");
+	external->Print(ss);
+	BOOST_TEST(ss.str() == "@ext = external addrspace(3) global float");
+
+	external->SetInitializer(ConstantFP::Get(float_ty, 2.0));
+	BOOST_TEST(external->HasInitializer());
+	BOOST_TEST(external->GetInitializer() == ConstantFP::Get(float_ty, 2.0));
+
+	ss.str("");
+	external->Print(ss);
+	BOOST_TEST(ss.str() == "@ext = addrspace(3) global float 2.0");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
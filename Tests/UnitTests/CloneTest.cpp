@@ -0,0 +1,121 @@
+/**
+ * @file CloneTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/Function.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+#include <Dilithium/Metadata.hpp>
+
+#include "TestUtil.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+using namespace Dilithium::Test;
+
+namespace
+{
+	Function* FindFunction(LLVMModule const & module, std::string_view name)
+	{
+		for (auto const & func : module)
+		{
+			if (func->Name() == name)
+			{
+				return func.get();
+			}
+		}
+		return nullptr;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(CloneTest)
+
+BOOST_AUTO_TEST_CASE(CloneMatchesSource)
+{
+	auto context = std::make_shared<LLVMContext>();
+	for (auto const & name : TestShaderNames())
+	{
+		BOOST_TEST_CONTEXT(name)
+		{
+			auto module = LoadTestModule(name, context);
+			auto clone = module->Clone();
+			BOOST_TEST(PrintModule(*clone) == PrintModule(*module));
+
+			// The clone doesn't share any function with the source
+			for (auto const & func : *module)
+			{
+				auto new_func = FindFunction(*clone, func->Name());
+				BOOST_TEST_REQUIRE(new_func);
+				BOOST_TEST(new_func != func.get());
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(DistinctCycle)
+{
+	auto context = std::make_shared<LLVMContext>();
+	LLVMModule module("DistinctCycle", context);
+	auto func = Function::Create(FunctionType::Get(Type::VoidType(*context), false), GlobalValue::ExternalLinkage, "f",
+		&module);
+
+	// distinct !0 = !{void ()* @f, !1}, !1 = !{!0}
+	Metadata* ops[] = { ValueAsMetadata::Get(func), nullptr };
+	auto distinct_node = MDNode::GetDistinct(*context, ops);
+	Metadata* uniqued_ops[] = { distinct_node };
+	auto uniqued_node = MDNode::Get(*context, uniqued_ops);
+	distinct_node->ReplaceOperandWith(1, uniqued_node);
+	module.GetOrInsertNamedMetadata("test")->AddOperand(distinct_node);
+
+	auto clone = module.Clone();
+	auto new_func = FindFunction(*clone, "f");
+	auto new_distinct_node = clone->GetNamedMetadata("test")->Operand(0);
+	BOOST_TEST(new_distinct_node != distinct_node);
+	BOOST_TEST(new_distinct_node->IsDistinct());
+	BOOST_TEST(new_distinct_node->Operand(0).Get() == ValueAsMetadata::Get(new_func));
+
+	// The uniqued node on the cycle refers to the cloned distinct node, not the one of the source
+	auto new_uniqued_node = cast<MDNode>(new_distinct_node->Operand(1).Get());
+	BOOST_TEST(new_uniqued_node != uniqued_node);
+	BOOST_TEST(new_uniqued_node->Operand(0).Get() == new_distinct_node);
+
+	// The source is untouched
+	BOOST_TEST(distinct_node->Operand(0).Get() == ValueAsMetadata::Get(func));
+	BOOST_TEST(distinct_node->Operand(1).Get() == uniqued_node);
+	BOOST_TEST(uniqued_node->Operand(0).Get() == distinct_node);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
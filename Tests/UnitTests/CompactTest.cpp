@@ -0,0 +1,127 @@
+/**
+ * @file CompactTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/Constants.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+#include <Dilithium/MemoryUsage.hpp>
+#include <Dilithium/Metadata.hpp>
+
+#include "TestUtil.hpp"
+
+#include <cstring>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+using namespace Dilithium::Test;
+
+namespace
+{
+	size_t ContextCount(LLVMContext const & context, char const * name)
+	{
+		std::vector<MemoryUsage> stats;
+		context.MemoryStats(stats);
+		for (auto const & stat : stats)
+		{
+			if (strcmp(stat.name, name) == 0)
+			{
+				return stat.count;
+			}
+		}
+		BOOST_FAIL("No such memory stat");
+		return 0;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(CompactTest)
+
+BOOST_AUTO_TEST_CASE(FreesUnreachable)
+{
+	auto context = std::make_shared<LLVMContext>();
+	LLVMModule module("Compact", context);
+	auto float_ty = Type::FloatType(*context);
+
+	auto kept_str = MDString::Get(*context, "kept");
+	auto kept_fp = ConstantFP::Get(float_ty, 1.5);
+	Metadata* kept_ops[] = { kept_str, ValueAsMetadata::Get(kept_fp) };
+	auto kept_node = MDNode::Get(*context, kept_ops);
+	module.GetOrInsertNamedMetadata("test")->AddOperand(kept_node);
+
+	size_t const num_strs = ContextCount(*context, "MDStrings");
+	size_t const num_fps = ContextCount(*context, "ConstantFPs");
+	size_t const num_ints = ContextCount(*context, "ConstantInts");
+
+	Metadata* dropped_ops[] = { MDString::Get(*context, "dropped"), ValueAsMetadata::Get(ConstantFP::Get(float_ty, 2.5)) };
+	MDNode::Get(*context, dropped_ops);
+	ConstantFP::Get(float_ty, 3.5);
+	ConstantInt::Get(Type::Int32Type(*context), 123456);
+	BOOST_TEST(ContextCount(*context, "MDStrings") == num_strs + 1);
+	BOOST_TEST(ContextCount(*context, "ConstantFPs") == num_fps + 2);
+	BOOST_TEST(ContextCount(*context, "ConstantInts") == num_ints + 1);
+
+	context->Compact();
+	BOOST_TEST(ContextCount(*context, "MDStrings") == num_strs);
+	BOOST_TEST(ContextCount(*context, "ConstantFPs") == num_fps);
+	BOOST_TEST(ContextCount(*context, "ConstantInts") == num_ints);
+
+	// What the module reaches is still uniqued
+	BOOST_TEST(MDString::Get(*context, "kept") == kept_str);
+	BOOST_TEST(ConstantFP::Get(float_ty, 1.5) == kept_fp);
+	BOOST_TEST(MDNode::Get(*context, kept_ops) == kept_node);
+	BOOST_TEST(module.GetNamedMetadata("test")->Operand(0) == kept_node);
+}
+
+BOOST_AUTO_TEST_CASE(KeepsLoadedModules)
+{
+	for (auto const & name : TestShaderNames())
+	{
+		BOOST_TEST_CONTEXT(name)
+		{
+			auto context = std::make_shared<LLVMContext>();
+			auto module = LoadTestModule(name, context);
+			auto const expected = PrintModule(*module);
+
+			// Loading a second copy and dropping it leaves objects that only the dropped copy used
+			LoadTestModule(name, context);
+			context->Compact();
+			BOOST_TEST(PrintModule(*module) == expected);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,139 @@
+/**
+ * @file ConcurrentUniquingTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/Constants.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/Metadata.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+
+namespace
+{
+	uint32_t constexpr NUM_THREADS = 8;
+	uint32_t constexpr NUM_KEYS = 2000;
+
+	struct UniquedObjects
+	{
+		std::vector<Type*> types;
+		std::vector<Constant*> constants;
+		std::vector<Metadata*> mds;
+		std::vector<Value*> mavs;
+	};
+
+	// Every thread asks for the same objects, in a different order
+	void GetObjects(LLVMContext& context, uint32_t thread_index, UniquedObjects& objs)
+	{
+		auto i32_ty = Type::Int32Type(context);
+		auto float_ty = Type::FloatType(context);
+
+		objs.types.resize(NUM_KEYS * 3);
+		objs.constants.resize(NUM_KEYS * 3);
+		objs.mds.resize(NUM_KEYS * 3);
+		objs.mavs.resize(NUM_KEYS);
+		for (uint32_t n = 0; n < NUM_KEYS; ++ n)
+		{
+			uint32_t const i = (n * 7 + thread_index * 997) % NUM_KEYS;
+
+			objs.types[i * 3 + 0] = IntegerType::Get(context, 2 + i % 60);
+			std::vector<Type*> params;
+			for (uint32_t j = 0; j < 11; ++ j)
+			{
+				params.push_back((i & (1U << j)) ? float_ty : i32_ty);
+			}
+			objs.types[i * 3 + 1] = FunctionType::Get(i32_ty, params, false);
+			objs.types[i * 3 + 2] = PointerType::Get(objs.types[i * 3 + 1], i % 4);
+
+			objs.constants[i * 3 + 0] = ConstantInt::Get(IntegerType::Get(context, 64), i * 1000003ULL);
+			objs.constants[i * 3 + 1] = ConstantFP::Get(float_ty, i * 0.5);
+			objs.constants[i * 3 + 2] = UndefValue::Get(objs.types[i * 3 + 2]);
+
+			objs.mds[i * 3 + 0] = MDString::Get(context, "str" + std::to_string(i));
+			objs.mds[i * 3 + 1] = ValueAsMetadata::Get(objs.constants[i * 3 + 0]);
+			Metadata* ops[] = { objs.mds[i * 3 + 0], objs.mds[i * 3 + 1] };
+			objs.mds[i * 3 + 2] = MDNode::Get(context, ops);
+
+			objs.mavs[i] = MetadataAsValue::Get(context, objs.mds[i * 3 + 2]);
+			context.MdKindId("kind" + std::to_string(i % 100));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(ConcurrentUniquingTest)
+
+BOOST_AUTO_TEST_CASE(SameObjectsFromAllThreads)
+{
+	LLVMContext context;
+	context.ConcurrentUniquing(true);
+
+	std::vector<UniquedObjects> objs(NUM_THREADS);
+	std::vector<std::thread> threads;
+	for (uint32_t i = 0; i < NUM_THREADS; ++ i)
+	{
+		threads.emplace_back(GetObjects, std::ref(context), i, std::ref(objs[i]));
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	context.ConcurrentUniquing(false);
+
+	UniquedObjects single;
+	GetObjects(context, 0, single);
+	for (uint32_t i = 0; i < NUM_THREADS; ++ i)
+	{
+		BOOST_TEST(objs[i].types == single.types);
+		BOOST_TEST(objs[i].constants == single.constants);
+		BOOST_TEST(objs[i].mds == single.mds);
+		BOOST_TEST(objs[i].mavs == single.mavs);
+	}
+
+	// Racing MdKindId calls would hand out an ID twice, and leave a hole in the names
+	boost::container::small_vector<std::string_view, 128> kind_names;
+	context.MdKindNames(kind_names);
+	for (auto const & name : kind_names)
+	{
+		BOOST_TEST(!name.empty());
+	}
+	BOOST_TEST(kind_names[context.MdKindId("kind42")] == "kind42");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+/**
+ * @file ConstantIntTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/Constants.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/LLVMContext.hpp>
+
+#include <map>
+#include <set>
+#include <utility>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+
+BOOST_AUTO_TEST_SUITE(ConstantIntTest)
+
+// Values in and around the direct-indexed range, for the cached widths and a few that only go through the hash set
+BOOST_AUTO_TEST_CASE(Uniquing)
+{
+	LLVMContext context;
+
+	std::map<std::pair<uint32_t, uint64_t>, ConstantInt*> seen;
+	for (uint32_t width : { 1, 8, 16, 24, 32, 33, 64 })
+	{
+		auto ty = IntegerType::Get(context, width);
+		for (int64_t v = -300; v <= 1300; ++ v)
+		{
+			auto ci = ConstantInt::Get(ty, static_cast<uint64_t>(v), true);
+			BOOST_TEST_REQUIRE(ci->GetType() == ty);
+			BOOST_TEST_REQUIRE(ConstantInt::Get(ty, static_cast<uint64_t>(v), true) == ci);
+
+			uint64_t const zext = (width == 64) ? static_cast<uint64_t>(v) : (static_cast<uint64_t>(v) & ((1ULL << width) - 1));
+			BOOST_TEST_REQUIRE(ci->ZExtValue() == zext);
+
+			// Values that truncate to the same bits are the same constant, all others are distinct
+			auto iter = seen.emplace(std::make_pair(width, zext), ci).first;
+			BOOST_TEST_REQUIRE(iter->second == ci);
+		}
+	}
+
+	std::set<ConstantInt*> constants;
+	for (auto const & entry : seen)
+	{
+		constants.insert(entry.second);
+	}
+	BOOST_TEST(constants.size() == seen.size());
+}
+
+BOOST_AUTO_TEST_CASE(SignedAndUnsigned)
+{
+	LLVMContext context;
+	auto i8_ty = Type::Int8Type(context);
+	auto i32_ty = Type::Int32Type(context);
+
+	BOOST_TEST(ConstantInt::Get(i8_ty, 255) == ConstantInt::Get(i8_ty, static_cast<uint64_t>(-1), true));
+	BOOST_TEST(ConstantInt::Get(i32_ty, 0xFFFFFF80ULL) == ConstantInt::Get(i32_ty, static_cast<uint64_t>(-128), true));
+	BOOST_TEST(ConstantInt::Get(i32_ty, 1023) != ConstantInt::Get(i32_ty, 1024));
+
+	// Every width has its own constant for the same value
+	BOOST_TEST(ConstantInt::Get(i8_ty, 1) != ConstantInt::Get(i32_ty, 1));
+	BOOST_TEST(ConstantInt::Get(Type::Int1Type(context), 1)->ZExtValue() == 1U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,279 @@
+/**
+ * @file DxilCBufferLayoutTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+#include <Dilithium/dxc/HLSL/DxilCBufferLayout.hpp>
+#include <Dilithium/dxc/HLSL/DxilTypeSystem.hpp>
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+
+namespace
+{
+	struct Field
+	{
+		Type* type;
+		uint32_t rows;
+		uint32_t cols;
+		MatrixOrientation orientation;
+		uint32_t expected_offset;
+	};
+
+	class CBufferFixture
+	{
+	public:
+		CBufferFixture()
+			: context_(std::make_shared<LLVMContext>()), module_("CBuffer", context_), type_system_(&module_),
+				layout_(type_system_)
+		{
+		}
+
+		Type* Float()
+		{
+			return Type::FloatType(*context_);
+		}
+		Type* Vector(Type* elem_ty, uint32_t num_elems)
+		{
+			return VectorType::Get(elem_ty, num_elems);
+		}
+		// class.matrix.T.R.C is { [R x <C x T>] }
+		Type* Matrix(uint32_t rows, uint32_t cols)
+		{
+			return StructType::Create(*context_, ArrayType::Get(this->Vector(this->Float(), cols), rows),
+				"class.matrix.float." + std::to_string(rows) + "." + std::to_string(cols));
+		}
+
+		// An annotated struct of the fields, checked against the offsets fxc and dxc give them
+		StructType* MakeStruct(std::vector<Field> const & fields)
+		{
+			std::vector<Type*> types;
+			for (auto const & field : fields)
+			{
+				types.push_back(field.type);
+			}
+			auto st = StructType::Create(*context_, types, "struct.CB" + std::to_string(num_structs_));
+			++ num_structs_;
+
+			auto annotation = type_system_.AddStructAnnotation(st);
+			for (uint32_t i = 0; i < fields.size(); ++ i)
+			{
+				if (fields[i].orientation != MatrixOrientation::Undefined)
+				{
+					DxilMatrixAnnotation matrix;
+					matrix.rows = fields[i].rows;
+					matrix.cols = fields[i].cols;
+					matrix.orientation = fields[i].orientation;
+					annotation->FieldAnnotation(i).SetMatrixAnnotation(matrix);
+				}
+			}
+			return st;
+		}
+
+		void CheckOffsets(StructType* st, std::vector<Field> const & fields, uint32_t expected_size)
+		{
+			auto layout = layout_.GetStructLayout(st);
+			BOOST_TEST_REQUIRE(layout->NumElements() == fields.size());
+			for (uint32_t i = 0; i < fields.size(); ++ i)
+			{
+				BOOST_TEST_INFO("field " << i);
+				BOOST_TEST(layout->ElementOffset(i) == fields[i].expected_offset);
+			}
+			BOOST_TEST(layout->SizeInBytes() == expected_size);
+		}
+
+	protected:
+		std::shared_ptr<LLVMContext> context_;
+		LLVMModule module_;
+		DxilTypeSystem type_system_;
+		DxilCBufferLayout layout_;
+		uint32_t num_structs_ = 0;
+	};
+
+	MatrixOrientation constexpr NoMatrix = MatrixOrientation::Undefined;
+	MatrixOrientation constexpr RowMajor = MatrixOrientation::RowMajor;
+	MatrixOrientation constexpr ColumnMajor = MatrixOrientation::ColumnMajor;
+}
+
+BOOST_FIXTURE_TEST_SUITE(DxilCBufferLayoutTest, CBufferFixture)
+
+// The examples of the HLSL packing rules documentation
+BOOST_AUTO_TEST_CASE(PackingRules)
+{
+	Type* f = this->Float();
+	Type* f2 = this->Vector(f, 2);
+	Type* f3 = this->Vector(f, 3);
+	Type* f4 = this->Vector(f, 4);
+
+	// float4 Val1; float2 Val2; float2 Val3;
+	std::vector<Field> fields = { { f4, 0, 0, NoMatrix, 0 }, { f2, 0, 0, NoMatrix, 16 }, { f2, 0, 0, NoMatrix, 24 } };
+	this->CheckOffsets(this->MakeStruct(fields), fields, 32);
+
+	// float2 Val1; float4 Val2; float2 Val3;
+	fields = { { f2, 0, 0, NoMatrix, 0 }, { f4, 0, 0, NoMatrix, 16 }, { f2, 0, 0, NoMatrix, 32 } };
+	this->CheckOffsets(this->MakeStruct(fields), fields, 40);
+
+	// float3 Val1; float Val2; float2 Val3; float3 Val4;
+	fields = { { f3, 0, 0, NoMatrix, 0 }, { f, 0, 0, NoMatrix, 12 }, { f2, 0, 0, NoMatrix, 16 },
+		{ f3, 0, 0, NoMatrix, 32 } };
+	this->CheckOffsets(this->MakeStruct(fields), fields, 44);
+
+	// float Val1[2]; float Val2; float2 Val3[2];
+	// Every element but the last takes a whole row, so Val2 fills the rest of the last one
+	fields = { { ArrayType::Get(f, 2), 0, 0, NoMatrix, 0 }, { f, 0, 0, NoMatrix, 20 },
+		{ ArrayType::Get(f2, 2), 0, 0, NoMatrix, 32 } };
+	this->CheckOffsets(this->MakeStruct(fields), fields, 56);
+}
+
+BOOST_AUTO_TEST_CASE(Scalars)
+{
+	Type* f = this->Float();
+
+	// float a; double b; min16float c; int64_t d; min16int e;
+	// Doubles align to 8 bytes, min precision types take 32 bits
+	std::vector<Field> fields = { { f, 0, 0, NoMatrix, 0 }, { Type::DoubleType(*context_), 0, 0, NoMatrix, 8 },
+		{ Type::HalfType(*context_), 0, 0, NoMatrix, 16 }, { Type::Int64Type(*context_), 0, 0, NoMatrix, 24 },
+		{ Type::Int16Type(*context_), 0, 0, NoMatrix, 32 } };
+	this->CheckOffsets(this->MakeStruct(fields), fields, 36);
+
+	// double2 a; float b; double c;
+	Type* d2 = this->Vector(Type::DoubleType(*context_), 2);
+	fields = { { d2, 0, 0, NoMatrix, 0 }, { f, 0, 0, NoMatrix, 16 }, { Type::DoubleType(*context_), 0, 0, NoMatrix, 24 } };
+	this->CheckOffsets(this->MakeStruct(fields), fields, 32);
+}
+
+BOOST_AUTO_TEST_CASE(Matrices)
+{
+	Type* f = this->Float();
+
+	// float a; float4x4 b; float c; row_major float3x2 d; float e; float2x3 f; row_major float1x2 g; float h;
+	// A column major float2x3 is 3 vectors of 2, so is a row major float3x2. A matrix of one vector stays on the
+	// current row if it fits, like a vector.
+	std::vector<Field> fields = { { f, 0, 0, NoMatrix, 0 },
+		{ this->Matrix(4, 4), 4, 4, ColumnMajor, 16 }, { f, 0, 0, NoMatrix, 80 },
+		{ this->Matrix(3, 2), 3, 2, RowMajor, 96 }, { f, 0, 0, NoMatrix, 136 },
+		{ this->Matrix(2, 3), 2, 3, ColumnMajor, 144 }, { this->Matrix(1, 2), 1, 2, RowMajor, 184 },
+		{ f, 0, 0, NoMatrix, 192 } };
+	this->CheckOffsets(this->MakeStruct(fields), fields, 196);
+
+	// Without an annotation, the matrix is column major
+	auto st = StructType::Create(*context_, { f, this->Matrix(2, 3), f }, "struct.NoAnnotation");
+	auto layout = layout_.GetStructLayout(st);
+	BOOST_TEST(layout->ElementOffset(1) == 16U);
+	BOOST_TEST(layout->ElementOffset(2) == 56U);
+}
+
+BOOST_AUTO_TEST_CASE(NestedStruct)
+{
+	Type* f = this->Float();
+	Type* f3 = this->Vector(f, 3);
+
+	// struct S { float x; float3 y; }; float a; S b; float c; S d[2]; float e;
+	std::vector<Field> inner = { { f, 0, 0, NoMatrix, 0 }, { f3, 0, 0, NoMatrix, 4 } };
+	auto s = this->MakeStruct(inner);
+	this->CheckOffsets(s, inner, 16);
+
+	std::vector<Field> fields = { { f, 0, 0, NoMatrix, 0 }, { s, 0, 0, NoMatrix, 16 }, { f, 0, 0, NoMatrix, 32 },
+		{ ArrayType::Get(s, 2), 0, 0, NoMatrix, 48 }, { f, 0, 0, NoMatrix, 80 } };
+	this->CheckOffsets(this->MakeStruct(fields), fields, 84);
+}
+
+// Matrices without rows or columns take no space instead of wrapping around
+BOOST_AUTO_TEST_CASE(EmptyMatrix)
+{
+	Type* f = this->Float();
+
+	std::vector<Field> fields = { { f, 0, 0, NoMatrix, 0 }, { this->Matrix(0, 4), 0, 4, RowMajor, 4 },
+		{ this->Matrix(0, 4), 0, 4, ColumnMajor, 16 }, { f, 0, 0, NoMatrix, 16 } };
+	auto st = this->MakeStruct(fields);
+	this->CheckOffsets(st, fields, 20);
+	BOOST_TEST(layout_.GetStructLayout(st)->ElementSize(1) == 0U);
+	BOOST_TEST(layout_.GetStructLayout(st)->ElementSize(2) == 0U);
+}
+
+BOOST_AUTO_TEST_CASE(SynthesizeAndVerify)
+{
+	Type* f = this->Float();
+	Type* f3 = this->Vector(f, 3);
+
+	std::vector<Field> fields = { { f, 0, 0, NoMatrix, 0 }, { f3, 0, 0, NoMatrix, 4 },
+		{ this->Matrix(2, 2), 2, 2, RowMajor, 16 } };
+	auto st = this->MakeStruct(fields);
+	BOOST_TEST(!layout_.VerifyAnnotation(st));
+
+	layout_.SynthesizeAnnotation(st);
+	BOOST_TEST(layout_.VerifyAnnotation(st));
+	auto annotation = type_system_.GetStructAnnotation(st);
+	BOOST_TEST(annotation->CBufferSize() == 40U);
+	for (uint32_t i = 0; i < fields.size(); ++ i)
+	{
+		BOOST_TEST(annotation->FieldAnnotation(i).GetCBufferOffset() == fields[i].expected_offset);
+	}
+
+	annotation->FieldAnnotation(1).SetCBufferOffset(12);
+	BOOST_TEST(!layout_.VerifyAnnotation(st));
+
+	// Without an annotation, one is added
+	auto plain = StructType::Create(*context_, { f3, f3 }, "struct.Plain");
+	BOOST_TEST(!layout_.VerifyAnnotation(plain));
+	layout_.SynthesizeAnnotation(plain);
+	BOOST_TEST(layout_.VerifyAnnotation(plain));
+	BOOST_TEST(type_system_.GetStructAnnotation(plain)->FieldAnnotation(1).GetCBufferOffset() == 16U);
+}
+
+// A layout cached while the struct was still opaque has fewer elements than the annotation added after the body.
+// Neither function reads past the layout.
+BOOST_AUTO_TEST_CASE(FieldCountMismatch)
+{
+	auto st = StructType::Create(*context_, "struct.Opaque");
+	BOOST_TEST(layout_.GetStructLayout(st)->NumElements() == 0U);
+
+	st->Body({ this->Float(), this->Float() });
+	auto annotation = type_system_.AddStructAnnotation(st);
+	BOOST_TEST_REQUIRE(annotation->NumFields() == 2U);
+
+	BOOST_TEST(!layout_.VerifyAnnotation(st));
+	layout_.SynthesizeAnnotation(st);
+	BOOST_TEST(annotation->CBufferSize() == 0U);
+	BOOST_TEST(!annotation->FieldAnnotation(0).HasCBufferOffset());
+	BOOST_TEST(!layout_.VerifyAnnotation(st));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
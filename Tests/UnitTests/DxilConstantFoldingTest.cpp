@@ -0,0 +1,347 @@
+/**
+ * @file DxilConstantFoldingTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/BasicBlock.hpp>
+#include <Dilithium/Constants.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/Function.hpp>
+#include <Dilithium/Instructions.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+#include <Dilithium/MPFloat.hpp>
+#include <Dilithium/dxc/HLSL/DxilConstantFolding.hpp>
+#include <Dilithium/dxc/HLSL/DxilConstants.hpp>
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+
+namespace
+{
+	// Builds dx.op calls into the entry block of a function with one float argument
+	class DxilCallBuilder
+	{
+	public:
+		DxilCallBuilder()
+			: context_(std::make_shared<LLVMContext>()), module_("DxilConstantFolding", context_), num_funcs_(0)
+		{
+			auto float_ty = Type::FloatType(*context_);
+			main_ = Function::Create(FunctionType::Get(Type::VoidType(*context_), float_ty, false),
+				GlobalValue::ExternalLinkage, "main", &module_);
+			bb_ = BasicBlock::Create(*context_, "entry", main_);
+		}
+
+		LLVMContext& Context()
+		{
+			return *context_;
+		}
+		LLVMModule& Module()
+		{
+			return module_;
+		}
+		Value* Argument()
+		{
+			return main_->ArgBegin()->get();
+		}
+		BasicBlock* Block()
+		{
+			return bb_;
+		}
+
+		CallInst* Call(OpCode op, Type* ret_ty, std::vector<Value*> args, char const * prefix = "dx.op.test.")
+		{
+			std::vector<Type*> param_tys = { Type::Int32Type(*context_) };
+			for (auto arg : args)
+			{
+				param_tys.push_back(arg->GetType());
+			}
+			auto func = Function::Create(FunctionType::Get(ret_ty, param_tys, false), GlobalValue::ExternalLinkage,
+				prefix + std::to_string(num_funcs_), &module_);
+			++ num_funcs_;
+
+			args.insert(args.begin(), ConstantInt::Get(Type::Int32Type(*context_), static_cast<uint32_t>(op)));
+			return CallInst::Create(func, args, "", bb_);
+		}
+
+		Constant* Fold(OpCode op, Type* ret_ty, std::vector<Value*> args)
+		{
+			return ConstantFoldDxilCall(*this->Call(op, ret_ty, std::move(args)));
+		}
+
+		Type* F16()
+		{
+			return Type::HalfType(*context_);
+		}
+		Type* F32()
+		{
+			return Type::FloatType(*context_);
+		}
+		Type* F64()
+		{
+			return Type::DoubleType(*context_);
+		}
+		Type* I1()
+		{
+			return Type::Int1Type(*context_);
+		}
+		Type* I32()
+		{
+			return Type::Int32Type(*context_);
+		}
+
+		Constant* F32(double v)
+		{
+			return ConstantFP::Get(this->F32(), v);
+		}
+		Constant* F64(double v)
+		{
+			return ConstantFP::Get(this->F64(), v);
+		}
+		Constant* I32(uint64_t v)
+		{
+			return ConstantInt::Get(this->I32(), v);
+		}
+
+	private:
+		std::shared_ptr<LLVMContext> context_;
+		LLVMModule module_;
+		Function* main_;
+		BasicBlock* bb_;
+		uint32_t num_funcs_;
+	};
+
+	double FloatValue(Constant const * c)
+	{
+		BOOST_TEST_REQUIRE(c != nullptr);
+		MPFloat f = cast<ConstantFP>(c)->GetValueMPF();
+		f.Convert(MPFloat::IEEEDouble, nullptr);
+		return f.ConvertToDouble();
+	}
+
+	uint64_t IntValue(Constant const * c)
+	{
+		BOOST_TEST_REQUIRE(c != nullptr);
+		return cast<ConstantInt>(c)->ZExtValue();
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(DxilConstantFoldingTest)
+
+BOOST_AUTO_TEST_CASE(Unary)
+{
+	DxilCallBuilder b;
+	double const nan = std::numeric_limits<double>::quiet_NaN();
+
+	BOOST_TEST(FloatValue(b.Fold(OpCode::FAbs, b.F32(), { b.F32(-2.5) })) == 2.5);
+	BOOST_TEST(FloatValue(b.Fold(OpCode::Sqrt, b.F32(), { b.F32(16) })) == 4);
+	BOOST_TEST(FloatValue(b.Fold(OpCode::Round_ne, b.F32(), { b.F32(2.5) })) == 2);
+	BOOST_TEST(FloatValue(b.Fold(OpCode::Round_ne, b.F32(), { b.F32(3.5) })) == 4);
+	BOOST_TEST(FloatValue(b.Fold(OpCode::Frc, b.F32(), { b.F32(-1.25) })) == 0.75);
+
+	// Saturate sends NaN and -0 to +0
+	BOOST_TEST(FloatValue(b.Fold(OpCode::Saturate, b.F32(), { b.F32(1.5) })) == 1);
+	auto sat_nan = b.Fold(OpCode::Saturate, b.F32(), { b.F32(nan) });
+	BOOST_TEST(FloatValue(sat_nan) == 0);
+	BOOST_TEST(!std::signbit(FloatValue(sat_nan)));
+	BOOST_TEST(!std::signbit(FloatValue(b.Fold(OpCode::Saturate, b.F32(), { b.F32(-0.0) }))));
+
+	// The result is rounded to the type of the call
+	BOOST_TEST(FloatValue(b.Fold(OpCode::Sqrt, b.F32(), { b.F32(2) })) == static_cast<double>(std::sqrt(2.0f)));
+	BOOST_TEST(FloatValue(b.Fold(OpCode::Sqrt, b.F64(), { b.F64(2) })) == std::sqrt(2.0));
+}
+
+// f16/f32 denormals are left to the driver, f64 keeps them
+BOOST_AUTO_TEST_CASE(Denormals)
+{
+	DxilCallBuilder b;
+
+	BOOST_TEST(b.Fold(OpCode::FAbs, b.F32(), { b.F32(-1e-40) }) == nullptr);
+	BOOST_TEST(b.Fold(OpCode::FAbs, b.F16(), { ConstantFP::Get(b.F16(), 1e-5) }) == nullptr);
+	BOOST_TEST(FloatValue(b.Fold(OpCode::FAbs, b.F64(), { b.F64(-1e-310) })) == 1e-310);
+
+	// A normal input with a denormal result
+	BOOST_TEST(b.Fold(OpCode::FMad, b.F32(), { b.F32(1e-20), b.F32(1e-20), b.F32(0) }) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(IsSpecialFloat)
+{
+	DxilCallBuilder b;
+	double const nan = std::numeric_limits<double>::quiet_NaN();
+	double const inf = std::numeric_limits<double>::infinity();
+
+	BOOST_TEST(IntValue(b.Fold(OpCode::IsNaN, b.I1(), { b.F32(nan) })) == 1U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::IsNaN, b.I1(), { b.F32(1) })) == 0U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::IsInf, b.I1(), { b.F32(-inf) })) == 1U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::IsFinite, b.I1(), { b.F32(inf) })) == 0U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::IsNormal, b.I1(), { b.F32(0) })) == 0U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::IsNormal, b.I1(), { b.F32(1) })) == 1U);
+}
+
+BOOST_AUTO_TEST_CASE(UnaryBits)
+{
+	DxilCallBuilder b;
+
+	BOOST_TEST(IntValue(b.Fold(OpCode::Countbits, b.I32(), { b.I32(0xF0F0) })) == 8U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::Bfrev, b.I32(), { b.I32(1) })) == 0x80000000U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::FirstbitLo, b.I32(), { b.I32(8) })) == 3U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::FirstbitLo, b.I32(), { b.I32(0) })) == 0xFFFFFFFFU);
+	BOOST_TEST(IntValue(b.Fold(OpCode::FirstbitHi, b.I32(), { b.I32(1) })) == 31U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::FirstbitHi, b.I32(), { b.I32(0) })) == 0xFFFFFFFFU);
+	BOOST_TEST(IntValue(b.Fold(OpCode::FirstbitSHi, b.I32(), { b.I32(0xFFFFFFFE) })) == 31U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::FirstbitSHi, b.I32(), { b.I32(0xFFFFFFFF) })) == 0xFFFFFFFFU);
+}
+
+BOOST_AUTO_TEST_CASE(Binary)
+{
+	DxilCallBuilder b;
+	double const nan = std::numeric_limits<double>::quiet_NaN();
+
+	BOOST_TEST(FloatValue(b.Fold(OpCode::FMax, b.F32(), { b.F32(1), b.F32(2) })) == 2);
+	BOOST_TEST(FloatValue(b.Fold(OpCode::FMin, b.F32(), { b.F32(1), b.F32(2) })) == 1);
+
+	// maxNum/minNum, a NaN returns the other operand
+	BOOST_TEST(FloatValue(b.Fold(OpCode::FMax, b.F32(), { b.F32(nan), b.F32(2) })) == 2);
+	BOOST_TEST(FloatValue(b.Fold(OpCode::FMin, b.F32(), { b.F32(3), b.F32(nan) })) == 3);
+
+	// The order of -0 and +0 is up to the implementation
+	BOOST_TEST(b.Fold(OpCode::FMax, b.F32(), { b.F32(-0.0), b.F32(0.0) }) == nullptr);
+
+	BOOST_TEST(IntValue(b.Fold(OpCode::IMax, b.I32(), { b.I32(0xFFFFFFFF), b.I32(1) })) == 1U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::IMin, b.I32(), { b.I32(0xFFFFFFFF), b.I32(1) })) == 0xFFFFFFFFU);
+	BOOST_TEST(IntValue(b.Fold(OpCode::UMax, b.I32(), { b.I32(0xFFFFFFFF), b.I32(1) })) == 0xFFFFFFFFU);
+	BOOST_TEST(IntValue(b.Fold(OpCode::UMin, b.I32(), { b.I32(0xFFFFFFFF), b.I32(1) })) == 1U);
+}
+
+BOOST_AUTO_TEST_CASE(Tertiary)
+{
+	DxilCallBuilder b;
+
+	BOOST_TEST(FloatValue(b.Fold(OpCode::FMad, b.F32(), { b.F32(2), b.F32(3), b.F32(4) })) == 10);
+	BOOST_TEST(FloatValue(b.Fold(OpCode::Fma, b.F64(), { b.F64(2), b.F64(3), b.F64(4) })) == 10);
+
+	// FMad rounds the product before the add
+	double const a = 1 + std::ldexp(1.0, -12);
+	double const c = -(1 + std::ldexp(1.0, -11));
+	BOOST_TEST(FloatValue(b.Fold(OpCode::FMad, b.F32(), { b.F32(a), b.F32(a), b.F32(c) })) == 0);
+
+	BOOST_TEST(IntValue(b.Fold(OpCode::IMad, b.I32(), { b.I32(0xFFFFFFFF), b.I32(2), b.I32(1) })) == 0xFFFFFFFFU);
+	BOOST_TEST(IntValue(b.Fold(OpCode::UMad, b.I32(), { b.I32(0x10000), b.I32(0x10000), b.I32(5) })) == 5U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::Msad, b.I32(), { b.I32(0x10203040), b.I32(0x00204010), b.I32(1) }))
+		== 1U + 0x30 + 0x10);
+
+	// (width, offset, value)
+	BOOST_TEST(IntValue(b.Fold(OpCode::Ubfe, b.I32(), { b.I32(4), b.I32(4), b.I32(0xABCD) })) == 0xCU);
+	BOOST_TEST(IntValue(b.Fold(OpCode::Ibfe, b.I32(), { b.I32(4), b.I32(4), b.I32(0x80) })) == 0xFFFFFFF8U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::Ubfe, b.I32(), { b.I32(0), b.I32(4), b.I32(0xABCD) })) == 0U);
+	BOOST_TEST(IntValue(b.Fold(OpCode::Ibfe, b.I32(), { b.I32(8), b.I32(28), b.I32(0x80000000) })) == 0xFFFFFFF8U);
+}
+
+BOOST_AUTO_TEST_CASE(BfiAndDot)
+{
+	DxilCallBuilder b;
+
+	// (width, offset, value, base)
+	BOOST_TEST(IntValue(b.Fold(OpCode::Bfi, b.I32(), { b.I32(8), b.I32(8), b.I32(0xAB), b.I32(0x12345678) }))
+		== 0x1234AB78U);
+
+	BOOST_TEST(FloatValue(b.Fold(OpCode::Dot2, b.F32(), { b.F32(1), b.F32(2), b.F32(3), b.F32(4) })) == 11);
+	BOOST_TEST(FloatValue(b.Fold(OpCode::Dot3, b.F32(),
+		{ b.F32(1), b.F32(2), b.F32(3), b.F32(4), b.F32(5), b.F32(6) })) == 32);
+	BOOST_TEST(FloatValue(b.Fold(OpCode::Dot4, b.F32(),
+		{ b.F32(1), b.F32(2), b.F32(3), b.F32(4), b.F32(1), b.F32(1), b.F32(1), b.F32(-10) })) == -34);
+}
+
+BOOST_AUTO_TEST_CASE(Legacy)
+{
+	DxilCallBuilder b;
+
+	BOOST_TEST(FloatValue(b.Fold(OpCode::LegacyF16ToF32, b.F32(), { b.I32(0x3C00) })) == 1);
+	BOOST_TEST(FloatValue(b.Fold(OpCode::LegacyF16ToF32, b.F32(), { b.I32(0xC500) })) == -5);
+	BOOST_TEST(b.Fold(OpCode::LegacyF16ToF32, b.F32(), { b.I32(0x0001) }) == nullptr);
+	BOOST_TEST(b.Fold(OpCode::LegacyF32ToF16, b.I32(), { b.F32(1) }) == nullptr);
+
+	BOOST_TEST(FloatValue(b.Fold(OpCode::LegacyDoubleToFloat, b.F32(), { b.F64(0.1) })) == static_cast<double>(0.1f));
+	BOOST_TEST(IntValue(b.Fold(OpCode::LegacyDoubleToSInt32, b.I32(), { b.F64(-2.7) })) == 0xFFFFFFFEU);
+	BOOST_TEST(IntValue(b.Fold(OpCode::LegacyDoubleToUInt32, b.I32(), { b.F64(4e9) })) == 4000000000U);
+	BOOST_TEST(b.Fold(OpCode::LegacyDoubleToUInt32, b.I32(), { b.F64(5e9) }) == nullptr);
+	BOOST_TEST(b.Fold(OpCode::LegacyDoubleToSInt32, b.I32(), { b.F64(-3e9) }) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(NotFoldable)
+{
+	DxilCallBuilder b;
+
+	// A non-constant argument
+	BOOST_TEST(b.Fold(OpCode::FAbs, b.F32(), { b.Argument() }) == nullptr);
+
+	// Not a dx.op function
+	BOOST_TEST(ConstantFoldDxilCall(*b.Call(OpCode::FAbs, b.F32(), { b.F32(-1) }, "not.dx.op.")) == nullptr);
+
+	// A wrong number of arguments
+	BOOST_TEST(b.Fold(OpCode::FAbs, b.F32(), { b.F32(-1), b.F32(-1) }) == nullptr);
+
+	// Not ReadNone
+	BOOST_TEST(b.Fold(OpCode::CBufferLoadLegacy, b.F32(), { b.I32(0), b.I32(0) }) == nullptr);
+
+	// ReadNone, but reads shader state
+	BOOST_TEST(b.Fold(OpCode::LoadInput, b.F32(), { b.I32(0), b.I32(0), b.I32(0), b.I32(0) }) == nullptr);
+}
+
+// Folding a call revisits its users, and the folded calls are removed
+BOOST_AUTO_TEST_CASE(FoldModule)
+{
+	DxilCallBuilder b;
+
+	auto abs_call = b.Call(OpCode::FAbs, b.F32(), { b.F32(-16) });
+	auto sqrt_call = b.Call(OpCode::Sqrt, b.F32(), { abs_call });
+	auto max_call = b.Call(OpCode::FMax, b.F32(), { sqrt_call, b.Argument() });
+	ReturnInst::Create(b.Context(), b.Block());
+	BOOST_TEST(b.Block()->size() == 4U);
+
+	BOOST_TEST(FoldDxilConstants(b.Module()) == 2U);
+	BOOST_TEST(b.Block()->size() == 2U);
+	BOOST_TEST(b.Block()->begin()->get() == max_call);
+	BOOST_TEST(FloatValue(cast<Constant>(max_call->ArgOperand(1))) == 4);
+	BOOST_TEST(max_call->ArgOperand(2) == b.Argument());
+
+	BOOST_TEST(FoldDxilConstants(b.Module()) == 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+/**
+ * @file DxilPreludeTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+#include <Dilithium/dxc/HLSL/DxilOperations.hpp>
+
+#include "TestUtil.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+using namespace Dilithium::Test;
+
+BOOST_AUTO_TEST_SUITE(DxilPreludeTest)
+
+BOOST_AUTO_TEST_CASE(CBufRetTypes)
+{
+	LLVMContext context;
+	auto const & prelude = context.GetDxilPrelude();
+
+	// A legacy cbuffer load returns one 16-byte row. Min precision 16-bit values take a 32-bit slot each.
+	struct
+	{
+		Type* overload;
+		uint32_t num_elements;
+	} const expected[] =
+	{
+		{ Type::HalfType(context), 4 },
+		{ Type::FloatType(context), 4 },
+		{ Type::DoubleType(context), 2 },
+		{ Type::Int16Type(context), 4 },
+		{ Type::Int32Type(context), 4 }
+	};
+	for (auto const & exp : expected)
+	{
+		auto ty = prelude.CBufRetType(exp.overload);
+		BOOST_TEST_REQUIRE(ty);
+		BOOST_TEST(ty->NumElements() == exp.num_elements);
+		for (uint32_t i = 0; i < ty->NumElements(); ++ i)
+		{
+			BOOST_TEST(ty->ElementType(i) == exp.overload);
+		}
+	}
+	BOOST_TEST(!prelude.CBufRetType(Type::Int64Type(context)));
+	BOOST_TEST(prelude.CBufRetType(Type::FloatType(context))->Name() == "dx.types.CBufRet.f32");
+}
+
+BOOST_AUTO_TEST_CASE(LoadWithPrelude)
+{
+	for (auto const & name : TestShaderNames())
+	{
+		BOOST_TEST_CONTEXT(name)
+		{
+			auto context = std::make_shared<LLVMContext>();
+			auto module = LoadTestModule(name, context);
+
+			auto prelude_context = std::make_shared<LLVMContext>();
+			auto const & prelude = prelude_context->GetDxilPrelude();
+			auto prelude_module = LoadTestModule(name, prelude_context);
+
+			BOOST_TEST(PrintModule(*prelude_module) == PrintModule(*module));
+
+			// The module shares the handle type of the prelude instead of a renamed copy
+			for (auto const & func : *prelude_module)
+			{
+				for (auto param_ty : func->GetFunctionType()->Params())
+				{
+					auto st = dyn_cast<StructType>(param_ty);
+					if (st && st->HasName() && (st->Name().find("dx.types.Handle") == 0))
+					{
+						BOOST_TEST(st == prelude.HandleType());
+					}
+				}
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
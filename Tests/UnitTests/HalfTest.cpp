@@ -0,0 +1,225 @@
+/**
+ * @file HalfTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/Half.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+
+namespace
+{
+	half HalfFromBits(uint16_t bits)
+	{
+		half h;
+		memcpy(&h, &bits, sizeof(h));
+		return h;
+	}
+
+	uint16_t HalfBits(half h)
+	{
+		uint16_t bits;
+		memcpy(&bits, &h, sizeof(bits));
+		return bits;
+	}
+
+	float FloatFromBits(uint32_t bits)
+	{
+		float f;
+		memcpy(&f, &bits, sizeof(f));
+		return f;
+	}
+
+	uint32_t FloatBits(float f)
+	{
+		uint32_t bits;
+		memcpy(&bits, &f, sizeof(bits));
+		return bits;
+	}
+
+	// The exact float value of a half, computed independently of the conversion code
+	uint32_t ReferenceHalfToFloat(uint16_t h)
+	{
+		uint32_t const sign = static_cast<uint32_t>(h & 0x8000) << 16;
+		uint32_t const e = (h >> 10) & 0x1F;
+		uint32_t const m = h & 0x3FF;
+		if (e == 31)
+		{
+			// Infinity and NaN keep their significand
+			return sign | 0x7F800000 | (m << 13);
+		}
+
+		float const magnitude = (e == 0) ? std::ldexp(static_cast<float>(m), -24)
+			: std::ldexp(static_cast<float>(m | 0x400), static_cast<int>(e) - 25);
+		return sign | FloatBits(magnitude);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(HalfTest)
+
+// All 65536 halves, scalar and bulk, against the reference
+BOOST_AUTO_TEST_CASE(HalfToFloatExhaustive)
+{
+	std::vector<half> halves(65536);
+	for (uint32_t i = 0; i < halves.size(); ++ i)
+	{
+		halves[i] = HalfFromBits(static_cast<uint16_t>(i));
+	}
+	std::vector<float> floats(halves.size());
+	ConvertHalfToFloat(halves, floats.data());
+
+	uint32_t num_mismatches = 0;
+	for (uint32_t i = 0; i < halves.size(); ++ i)
+	{
+		uint32_t const expected = ReferenceHalfToFloat(static_cast<uint16_t>(i));
+		uint32_t const scalar = FloatBits(static_cast<float>(halves[i]));
+		uint32_t const bulk = FloatBits(floats[i]);
+		if ((scalar != expected) || (bulk != expected))
+		{
+			BOOST_TEST_MESSAGE("half 0x" << std::hex << i << ": expected 0x" << expected << ", scalar 0x" << scalar
+				<< ", bulk 0x" << bulk);
+			++ num_mismatches;
+		}
+	}
+	BOOST_TEST(num_mismatches == 0U);
+}
+
+// Every half that isn't a NaN survives the trip through float, in both the scalar and the bulk conversion. That includes
+// -0, and floats too small for a half keep their sign too.
+BOOST_AUTO_TEST_CASE(RoundTrip)
+{
+	std::vector<half> halves;
+	for (uint32_t i = 0; i < 65536; ++ i)
+	{
+		if (((i & 0x7C00) != 0x7C00) || ((i & 0x3FF) == 0))
+		{
+			halves.push_back(HalfFromBits(static_cast<uint16_t>(i)));
+		}
+	}
+	std::vector<float> floats(halves.size());
+	ConvertHalfToFloat(halves, floats.data());
+	std::vector<half> back(halves.size());
+	ConvertFloatToHalf(floats, back.data());
+
+	uint32_t num_mismatches = 0;
+	for (size_t i = 0; i < halves.size(); ++ i)
+	{
+		uint16_t const bits = HalfBits(halves[i]);
+		if ((HalfBits(half(floats[i])) != bits) || (HalfBits(back[i]) != bits))
+		{
+			BOOST_TEST_MESSAGE("half 0x" << std::hex << bits << ": scalar 0x" << HalfBits(half(floats[i])) << ", bulk 0x"
+				<< HalfBits(back[i]));
+			++ num_mismatches;
+		}
+	}
+	BOOST_TEST(num_mismatches == 0U);
+
+	BOOST_TEST(HalfBits(half(-1e-10f)) == 0x8000);
+	BOOST_TEST(HalfBits(half(1e-10f)) == 0x0000);
+}
+
+// The bulk float to half conversion gives the scalar bits, for a spread of floats over the whole bit space and for the
+// ties and neighbors of every half
+BOOST_AUTO_TEST_CASE(FloatToHalfMatchesScalar)
+{
+	std::vector<float> floats;
+	for (uint64_t bits = 0; bits <= 0xFFFFFFFFULL; bits += 65521)
+	{
+		floats.push_back(FloatFromBits(static_cast<uint32_t>(bits)));
+	}
+	for (uint32_t i = 0; i < 65536; ++ i)
+	{
+		uint32_t const bits = ReferenceHalfToFloat(static_cast<uint16_t>(i));
+		for (uint32_t delta : { 0x0FFFU, 0x1000U, 0x1001U, 0x1FFFU })
+		{
+			floats.push_back(FloatFromBits(bits + delta));
+			floats.push_back(FloatFromBits(bits - delta));
+		}
+	}
+	floats.push_back(std::numeric_limits<float>::infinity());
+	floats.push_back(-std::numeric_limits<float>::infinity());
+	floats.push_back(std::numeric_limits<float>::quiet_NaN());
+	floats.push_back(std::numeric_limits<float>::denorm_min());
+
+	std::vector<half> halves(floats.size());
+	ConvertFloatToHalf(floats, halves.data());
+
+	uint32_t num_mismatches = 0;
+	for (size_t i = 0; i < floats.size(); ++ i)
+	{
+		uint16_t const scalar = HalfBits(half(floats[i]));
+		if (HalfBits(halves[i]) != scalar)
+		{
+			BOOST_TEST_MESSAGE("float 0x" << std::hex << FloatBits(floats[i]) << ": scalar 0x" << scalar << ", bulk 0x"
+				<< HalfBits(halves[i]));
+			++ num_mismatches;
+		}
+	}
+	BOOST_TEST(num_mismatches == 0U);
+}
+
+// Lengths and offsets that aren't multiples of the vector width go through the scalar tail
+BOOST_AUTO_TEST_CASE(Tails)
+{
+	std::vector<float> floats(40);
+	for (size_t i = 0; i < floats.size(); ++ i)
+	{
+		floats[i] = static_cast<float>(i) * 0.75f - 10.0f;
+	}
+
+	for (size_t offset = 0; offset < 4; ++ offset)
+	{
+		for (size_t size = 0; size + offset <= floats.size(); ++ size)
+		{
+			std::vector<half> halves(size + 1, HalfFromBits(0xABCD));
+			ConvertFloatToHalf(ArrayRef<float>(floats.data() + offset, size), halves.data());
+			std::vector<float> back(size + 1, -1.0f);
+			ConvertHalfToFloat(ArrayRef<half>(halves.data(), size), back.data());
+			for (size_t i = 0; i < size; ++ i)
+			{
+				BOOST_TEST_REQUIRE(back[i] == floats[offset + i]);
+			}
+			BOOST_TEST(HalfBits(halves[size]) == 0xABCD);
+			BOOST_TEST(back[size] == -1.0f);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+/**
+ * @file MDNodeTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/Function.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+#include <Dilithium/Metadata.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+
+BOOST_AUTO_TEST_SUITE(MDNodeTest)
+
+BOOST_AUTO_TEST_CASE(UniquifyDistinct)
+{
+	LLVMContext context;
+
+	Metadata* ops[] = { MDString::Get(context, "unique") };
+	auto node = MDNode::GetDistinct(context, ops);
+	BOOST_TEST(node->IsDistinct());
+
+	node->UniquifyDistinct();
+	BOOST_TEST(node->IsUniqued());
+	BOOST_TEST(node->IsResolved());
+	BOOST_TEST(MDNode::Get(context, ops) == node);
+}
+
+// An equal uniqued node exists already, so the node stays distinct, and its operands go on working as distinct ones
+BOOST_AUTO_TEST_CASE(UniquifyDistinctFallback)
+{
+	auto context = std::make_shared<LLVMContext>();
+	LLVMModule module("UniquifyDistinctFallback", context);
+	auto func_ty = FunctionType::Get(Type::VoidType(*context), false);
+	auto f = Function::Create(func_ty, GlobalValue::ExternalLinkage, "f", &module);
+	auto g = Function::Create(func_ty, GlobalValue::ExternalLinkage, "g", &module);
+
+	Metadata* ops[] = { ValueAsMetadata::Get(f), MDString::Get(*context, "fallback") };
+	auto uniqued_node = MDNode::Get(*context, ops);
+	auto distinct_node = MDNode::GetDistinct(*context, ops);
+
+	distinct_node->UniquifyDistinct();
+	BOOST_TEST(distinct_node->IsDistinct());
+	BOOST_TEST(distinct_node->IsResolved());
+	BOOST_TEST(MDNode::Get(*context, ops) == uniqued_node);
+
+	// Both nodes follow the value, the distinct one keeps its identity
+	f->ReplaceAllUsesWith(g);
+	BOOST_TEST(distinct_node->IsDistinct());
+	BOOST_TEST(distinct_node->Operand(0).Get() == ValueAsMetadata::Get(g));
+	BOOST_TEST(distinct_node->Operand(1).Get() == ops[1]);
+	BOOST_TEST(uniqued_node->Operand(0).Get() == ValueAsMetadata::Get(g));
+
+	Metadata* new_ops[] = { ValueAsMetadata::Get(g), ops[1] };
+	BOOST_TEST(MDNode::Get(*context, new_ops) == uniqued_node);
+
+	// Changing an operand of the distinct node doesn't touch the uniqued one
+	distinct_node->ReplaceOperandWith(1, MDString::Get(*context, "changed"));
+	BOOST_TEST(cast<MDString>(distinct_node->Operand(1).Get())->String() == "changed");
+	BOOST_TEST(uniqued_node->Operand(1).Get() == ops[1]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,125 @@
+/**
+ * @file MDStringTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+#include <Dilithium/Metadata.hpp>
+
+#include "TestUtil.hpp"
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+using namespace Dilithium::Test;
+
+BOOST_AUTO_TEST_SUITE(MDStringTest)
+
+// The characters live right behind the MDString, in the same allocation
+BOOST_AUTO_TEST_CASE(InlineCharacters)
+{
+	LLVMContext context;
+
+	std::vector<std::string> strs = { "", "a", "dx.version", std::string("embedded\0null", 13), std::string(5000, 'x') };
+	std::vector<MDString*> mds_strs;
+	for (auto const & str : strs)
+	{
+		auto mds = MDString::Get(context, str);
+		BOOST_TEST(mds->String() == str);
+		BOOST_TEST(mds->Size() == str.size());
+		BOOST_TEST(static_cast<void const *>(mds->String().data()) == static_cast<void const *>(mds + 1));
+		BOOST_TEST(std::string(mds->begin(), mds->end()) == str);
+		mds_strs.push_back(mds);
+	}
+
+	// Growing the table doesn't move the characters
+	std::vector<char const *> datas;
+	for (auto mds : mds_strs)
+	{
+		datas.push_back(mds->String().data());
+	}
+	for (uint32_t i = 0; i < 10000; ++ i)
+	{
+		MDString::Get(context, "filler" + std::to_string(i));
+	}
+	for (size_t i = 0; i < strs.size(); ++ i)
+	{
+		BOOST_TEST(MDString::Get(context, strs[i]) == mds_strs[i]);
+		BOOST_TEST(static_cast<void const *>(mds_strs[i]->String().data()) == static_cast<void const *>(datas[i]));
+		BOOST_TEST(mds_strs[i]->String() == strs[i]);
+	}
+}
+
+// The input string is copied, the MDString doesn't alias it
+BOOST_AUTO_TEST_CASE(CopiesInput)
+{
+	LLVMContext context;
+
+	std::string str = "dx.resources";
+	auto mds = MDString::Get(context, str);
+	BOOST_TEST(static_cast<void const *>(mds->String().data()) != static_cast<void const *>(str.data()));
+	str[0] = 'X';
+	BOOST_TEST(mds->String() == "dx.resources");
+	BOOST_TEST(MDString::Get(context, "dx.resources") == mds);
+	BOOST_TEST(MDString::Get(context, str) != mds);
+}
+
+// Loading a shader produces the strings its listing has
+BOOST_AUTO_TEST_CASE(LoadedStrings)
+{
+	for (auto const & name : TestShaderNames())
+	{
+		BOOST_TEST_CONTEXT(name)
+		{
+			auto context = std::make_shared<LLVMContext>();
+			auto module = LoadTestModule(name, context);
+			auto const listing = PrintModule(*module);
+
+			auto version = module->GetNamedMetadata("dx.version");
+			BOOST_TEST_REQUIRE(version != nullptr);
+			BOOST_TEST(listing.find("!dx.version") != std::string::npos);
+
+			auto shader_model = module->GetNamedMetadata("dx.shaderModel");
+			BOOST_TEST_REQUIRE(shader_model != nullptr);
+			auto model_name = cast<MDString>(shader_model->Operand(0)->Operand(0).Get());
+			BOOST_TEST(((model_name->String() == "ps") || (model_name->String() == "vs")));
+			BOOST_TEST(MDString::Get(*context, model_name->String()) == model_name);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
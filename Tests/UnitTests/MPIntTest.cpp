@@ -0,0 +1,233 @@
+/**
+ * @file MPIntTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/MPFloat.hpp>
+#include <Dilithium/MPInt.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+
+#ifdef __SIZEOF_INT128__
+namespace
+{
+	typedef unsigned __int128 uint128_t;
+	typedef __int128 int128_t;
+
+	MPInt MakeMPInt(uint128_t val)
+	{
+		uint64_t const words[] = { static_cast<uint64_t>(val), static_cast<uint64_t>(val >> 64) };
+		return MPInt(128, words);
+	}
+
+	uint128_t FromMPInt(MPInt const & val)
+	{
+		BOOST_ASSERT(val.BitWidth() == 128);
+		return (static_cast<uint128_t>(val.RawData()[1]) << 64) | val.RawData()[0];
+	}
+
+	// Random values with a random number of active bits, so that carries and shifts cross the word boundary in
+	// both directions
+	class Int128Generator
+	{
+	public:
+		Int128Generator()
+			: gen_(42), bits_dist_(0, 127)
+		{
+		}
+
+		uint128_t operator()()
+		{
+			uint128_t const val = (static_cast<uint128_t>(gen_()) << 64) | gen_();
+			return val >> bits_dist_(gen_);
+		}
+
+		uint32_t Shift()
+		{
+			return bits_dist_(gen_);
+		}
+
+	private:
+		std::mt19937_64 gen_;
+		std::uniform_int_distribution<uint32_t> bits_dist_;
+	};
+
+	double ConvertToDouble(MPInt const & val, bool is_signed)
+	{
+		MPFloat f(MPFloat::IEEEDouble);
+		f.ConvertFromMPInt(val, is_signed);
+		return f.ConvertToDouble();
+	}
+
+	float ConvertToFloat(MPInt const & val, bool is_signed)
+	{
+		MPFloat f(MPFloat::IEEESingle);
+		f.ConvertFromMPInt(val, is_signed);
+		return f.ConvertToFloat();
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(MPIntTest)
+
+// The multi-word arithmetic against the compiler's 128-bit integers
+BOOST_AUTO_TEST_CASE(Arithmetic)
+{
+	Int128Generator gen;
+	uint32_t num_mismatches = 0;
+	for (uint32_t i = 0; i < 100000; ++ i)
+	{
+		uint128_t const a = gen();
+		uint128_t const b = gen();
+		uint32_t const shift = gen.Shift();
+		MPInt const ma = MakeMPInt(a);
+		MPInt const mb = MakeMPInt(b);
+
+		bool const match = (FromMPInt(ma + mb) == a + b)
+			&& (FromMPInt(ma - mb) == a - b)
+			&& (FromMPInt(ma * mb) == a * b)
+			&& (FromMPInt(ma & mb) == (a & b))
+			&& (FromMPInt(ma | mb) == (a | b))
+			&& (FromMPInt(ma ^ mb) == (a ^ b))
+			&& (FromMPInt(~ma) == ~a)
+			&& (FromMPInt(-ma) == -a)
+			&& (FromMPInt(ma.Shl(shift)) == a << shift)
+			&& (FromMPInt(ma.LShr(shift)) == a >> shift)
+			&& (FromMPInt(ma.AShr(shift)) == static_cast<uint128_t>(static_cast<int128_t>(a) >> shift))
+			&& ((ma == mb) == (a == b))
+			&& (ma == MakeMPInt(a))
+			&& (ma.Trunc(64).ZExtValue() == static_cast<uint64_t>(a))
+			&& (FromMPInt(MPInt(128, static_cast<uint64_t>(a), true))
+				== static_cast<uint128_t>(static_cast<int128_t>(static_cast<int64_t>(a))))
+			&& (ma.ActiveBits() == ((a == 0) ? 0 : 128 - ((a >> 64) ? __builtin_clzll(static_cast<uint64_t>(a >> 64))
+				: 64 + __builtin_clzll(static_cast<uint64_t>(a)))));
+		if (!match)
+		{
+			BOOST_TEST_MESSAGE("Mismatch for 0x" << std::hex << static_cast<uint64_t>(a >> 64) << "_"
+				<< static_cast<uint64_t>(a) << " and 0x" << static_cast<uint64_t>(b >> 64) << "_"
+				<< static_cast<uint64_t>(b) << ", shift " << std::dec << shift);
+			++ num_mismatches;
+		}
+	}
+	BOOST_TEST(num_mismatches == 0U);
+}
+
+// Every word of the integer takes part in the conversion, rounded to nearest even like the compiler does it
+BOOST_AUTO_TEST_CASE(ConvertFromMPInt)
+{
+	Int128Generator gen;
+	uint32_t num_mismatches = 0;
+	for (uint32_t i = 0; i < 100000; ++ i)
+	{
+		uint128_t const a = gen();
+		MPInt const ma = MakeMPInt(a);
+		int128_t const sa = static_cast<int128_t>(a);
+		MPInt const mna = MakeMPInt(static_cast<uint128_t>(-sa));
+
+		bool const match = (ConvertToDouble(ma, false) == static_cast<double>(a))
+			&& (ConvertToFloat(ma, false) == static_cast<float>(a))
+			&& (ConvertToDouble(ma, true) == static_cast<double>(sa))
+			&& (ConvertToFloat(ma, true) == static_cast<float>(sa))
+			&& (ConvertToDouble(mna, true) == static_cast<double>(-sa))
+			&& (ConvertToFloat(mna, true) == static_cast<float>(-sa));
+		if (!match)
+		{
+			BOOST_TEST_MESSAGE("Mismatch for 0x" << std::hex << static_cast<uint64_t>(a >> 64) << "_"
+				<< static_cast<uint64_t>(a));
+			++ num_mismatches;
+		}
+	}
+	BOOST_TEST(num_mismatches == 0U);
+
+	// The most negative value has no positive counterpart in the same width
+	MPInt const min = MakeMPInt(static_cast<uint128_t>(1) << 127);
+	BOOST_TEST(ConvertToDouble(min, true) == -std::ldexp(1.0, 127));
+	BOOST_TEST(ConvertToDouble(min, false) == std::ldexp(1.0, 127));
+	BOOST_TEST(ConvertToFloat(MPInt(128, 0), true) == 0.0f);
+}
+
+// Wider than the compiler's integers, the bits below the top 64 still decide ties
+BOOST_AUTO_TEST_CASE(ConvertWide)
+{
+	uint64_t const tie = (1ULL << 53) + 1;
+	uint64_t words[4] = { 0, tie << 36, tie >> 28, 0 };
+	MPInt const exact_tie(256, words);
+	BOOST_TEST(ConvertToDouble(exact_tie, false) == std::ldexp(static_cast<double>(1ULL << 53), 100));
+
+	words[0] = 1;
+	MPInt const above_tie(256, words);
+	BOOST_TEST(ConvertToDouble(above_tie, false) == std::ldexp(static_cast<double>((1ULL << 53) + 2), 100));
+	BOOST_TEST(ConvertToDouble(-above_tie, true) == -std::ldexp(static_cast<double>((1ULL << 53) + 2), 100));
+
+	// Past the range of a float, but not of a double
+	words[0] = 0;
+	words[1] = 0;
+	words[2] = 0;
+	words[3] = 1ULL << 63;
+	MPInt const huge(256, words);
+	BOOST_TEST(ConvertToDouble(huge, false) == std::ldexp(1.0, 255));
+	BOOST_TEST(ConvertToFloat(huge, false) == std::numeric_limits<float>::infinity());
+	BOOST_TEST(ConvertToDouble(huge, true) == -std::ldexp(1.0, 255));
+	BOOST_TEST(ConvertToFloat(huge, true) == -std::numeric_limits<float>::infinity());
+}
+
+// Halves are exact up to 11 bits, round above that, and overflow to infinity past 65519
+BOOST_AUTO_TEST_CASE(ConvertToHalf)
+{
+	uint32_t num_mismatches = 0;
+	for (int32_t i = -70000; i <= 70000; ++ i)
+	{
+		MPFloat f(MPFloat::IEEEHalf);
+		f.ConvertFromMPInt(MPInt(128, static_cast<uint64_t>(static_cast<int64_t>(i)), true), true);
+		float const expected = (std::abs(i) >= 65520) ? std::copysign(std::numeric_limits<float>::infinity(), static_cast<float>(i))
+			: static_cast<float>(i);
+		half const expected_half(expected);
+		uint16_t expected_bits;
+		memcpy(&expected_bits, &expected_half, sizeof(expected_bits));
+		if (f.BitcastToMPInt().ZExtValue() != expected_bits)
+		{
+			BOOST_TEST_MESSAGE("Mismatch for " << i);
+			++ num_mismatches;
+		}
+	}
+	BOOST_TEST(num_mismatches == 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file MetadataLoadTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/GlobalValue.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+#include <Dilithium/Metadata.hpp>
+
+#include "TestUtil.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+using namespace Dilithium::Test;
+
+namespace
+{
+	// The metadata lines of a listing, the ones starting with '!'
+	std::vector<std::string> MetadataLines(std::string const & listing)
+	{
+		std::vector<std::string> lines;
+		std::istringstream iss(listing);
+		std::string line;
+		while (std::getline(iss, line))
+		{
+			if (!line.empty() && (line.back() == '\r'))
+			{
+				line.pop_back();
+			}
+			if (!line.empty() && (line[0] == '!'))
+			{
+				lines.push_back(line);
+			}
+		}
+		return lines;
+	}
+
+	// Whether md reaches no global value and no distinct node, so that its identity doesn't depend on the module
+	bool ModuleIndependent(Metadata const * md)
+	{
+		if (auto node = dyn_cast_or_null<MDNode>(md))
+		{
+			if (node->IsDistinct())
+			{
+				return false;
+			}
+			for (auto const & op : node->Operands())
+			{
+				if (!ModuleIndependent(op.Get()))
+				{
+					return false;
+				}
+			}
+		}
+		else if (auto vam = dyn_cast_or_null<ValueAsMetadata>(md))
+		{
+			return !isa<GlobalValue>(vam->GetValue());
+		}
+		return true;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(MetadataLoadTest)
+
+// The metadata block is built in bulk, but prints the same as the reference listings
+BOOST_AUTO_TEST_CASE(MatchesListing)
+{
+	for (auto const & name : TestShaderNames())
+	{
+		BOOST_TEST_CONTEXT(name)
+		{
+			auto const asm_file = LoadTestFile(name.substr(0, name.rfind('.')) + ".asm");
+			auto const expected = MetadataLines(std::string(asm_file.begin(), asm_file.end()));
+			BOOST_TEST_REQUIRE(!expected.empty());
+
+			auto context = std::make_shared<LLVMContext>();
+			auto module = LoadTestModule(name, context);
+			auto const actual = MetadataLines(PrintModule(*module));
+			BOOST_TEST(actual == expected, boost::test_tools::per_element());
+		}
+	}
+}
+
+// A second load into the same context finds the uniqued nodes of the first one that don't depend on the module, and gets
+// its own distinct nodes
+BOOST_AUTO_TEST_CASE(UniquedAcrossLoads)
+{
+	for (auto const & name : TestShaderNames())
+	{
+		BOOST_TEST_CONTEXT(name)
+		{
+			auto context = std::make_shared<LLVMContext>();
+			auto first = LoadTestModule(name, context);
+			auto second = LoadTestModule(name, context);
+			BOOST_TEST_REQUIRE(first->NamedMetadataSize() == second->NamedMetadataSize());
+
+			uint32_t num_shared = 0;
+			for (auto const & nmd : first->NamedMetadata())
+			{
+				auto other = second->GetNamedMetadata(nmd->GetName());
+				BOOST_TEST_REQUIRE(other != nullptr);
+				BOOST_TEST_REQUIRE(nmd->NumOperands() == other->NumOperands());
+				for (uint32_t i = 0; i < nmd->NumOperands(); ++ i)
+				{
+					auto node = nmd->Operand(i);
+					BOOST_TEST(node->IsResolved());
+					if (ModuleIndependent(node))
+					{
+						BOOST_TEST(other->Operand(i) == node);
+						++ num_shared;
+					}
+					else if (node->IsDistinct())
+					{
+						BOOST_TEST(other->Operand(i) != node);
+					}
+				}
+			}
+			BOOST_TEST(num_shared > 0U);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
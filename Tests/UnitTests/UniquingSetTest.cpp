@@ -0,0 +1,216 @@
+/**
+ * @file UniquingSetTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/Metadata.hpp>
+
+#include "UniquingSet.hpp"
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+
+namespace
+{
+	struct Key
+	{
+		uint32_t value;
+	};
+
+	// Every key falls into one of a handful of hashes, so most lookups go through a full key compare
+	uint64_t CollidingHash(uint32_t value)
+	{
+		return value & 7;
+	}
+
+	Key* Find(UniquingSet<Key> const & set, uint32_t value)
+	{
+		return set.Find(CollidingHash(value), [value](Key const * key)
+			{
+				return key->value == value;
+			});
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(UniquingSetTest)
+
+BOOST_AUTO_TEST_CASE(CollidingKeys)
+{
+	uint32_t constexpr NUM_KEYS = 1000;
+
+	std::vector<Key> keys(NUM_KEYS);
+	UniquingSet<Key> set;
+	for (uint32_t i = 0; i < NUM_KEYS; ++ i)
+	{
+		keys[i].value = i;
+		BOOST_TEST_REQUIRE(!Find(set, i));
+		set.Insert(CollidingHash(i), &keys[i]);
+	}
+	BOOST_TEST(set.size() == NUM_KEYS);
+
+	for (uint32_t i = 0; i < NUM_KEYS; ++ i)
+	{
+		BOOST_TEST(Find(set, i) == &keys[i]);
+	}
+	BOOST_TEST(!Find(set, NUM_KEYS));
+
+	// Erasing leaves tombstones on the probe sequences of the remaining keys
+	for (uint32_t i = 0; i < NUM_KEYS; i += 2)
+	{
+		BOOST_TEST(set.Erase(CollidingHash(i), &keys[i]));
+	}
+	BOOST_TEST(set.size() == NUM_KEYS / 2);
+	for (uint32_t i = 0; i < NUM_KEYS; ++ i)
+	{
+		BOOST_TEST(Find(set, i) == ((i & 1) ? &keys[i] : nullptr));
+	}
+
+	set.ShrinkToFit();
+	for (uint32_t i = 1; i < NUM_KEYS; i += 2)
+	{
+		BOOST_TEST(Find(set, i) == &keys[i]);
+	}
+
+	size_t num_iterated = 0;
+	for (auto key : set)
+	{
+		BOOST_TEST((key->value & 1) == 1U);
+		++ num_iterated;
+	}
+	BOOST_TEST(num_iterated == set.size());
+}
+
+BOOST_AUTO_TEST_CASE(RandomOperations)
+{
+	uint32_t constexpr NUM_KEYS = 512;
+
+	std::vector<Key> keys(NUM_KEYS);
+	for (uint32_t i = 0; i < NUM_KEYS; ++ i)
+	{
+		keys[i].value = i;
+	}
+
+	UniquingSet<Key> set;
+	std::unordered_map<uint32_t, Key*> reference;
+	std::mt19937 gen(42);
+	std::uniform_int_distribution<uint32_t> key_dist(0, NUM_KEYS - 1);
+	std::uniform_int_distribution<uint32_t> op_dist(0, 2);
+	for (uint32_t i = 0; i < 100000; ++ i)
+	{
+		uint32_t const value = key_dist(gen);
+		auto const iter = reference.find(value);
+		switch (op_dist(gen))
+		{
+		case 0:
+			if (iter == reference.end())
+			{
+				set.Insert(CollidingHash(value), &keys[value]);
+				reference.emplace(value, &keys[value]);
+			}
+			break;
+
+		case 1:
+			BOOST_TEST_REQUIRE(set.Erase(CollidingHash(value), &keys[value]) == (iter != reference.end()));
+			if (iter != reference.end())
+			{
+				reference.erase(iter);
+			}
+			break;
+
+		default:
+			BOOST_TEST_REQUIRE(Find(set, value) == ((iter != reference.end()) ? iter->second : nullptr));
+			break;
+		}
+		BOOST_TEST_REQUIRE(set.size() == reference.size());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ContextUniquing)
+{
+	LLVMContext context;
+	auto i32_ty = Type::Int32Type(context);
+	auto float_ty = Type::FloatType(context);
+
+	// Function types that differ only in one parameter are distinct, equal ones are shared
+	std::vector<FunctionType*> func_tys;
+	for (uint32_t i = 0; i < 64; ++ i)
+	{
+		std::vector<Type*> params;
+		for (uint32_t j = 0; j < 6; ++ j)
+		{
+			params.push_back((i & (1U << j)) ? float_ty : i32_ty);
+		}
+		func_tys.push_back(FunctionType::Get(i32_ty, params, false));
+	}
+	for (uint32_t i = 0; i < 64; ++ i)
+	{
+		BOOST_TEST(func_tys[i]->NumParams() == 6U);
+		for (uint32_t j = 0; j < 6; ++ j)
+		{
+			BOOST_TEST(func_tys[i]->ParamType(j) == ((i & (1U << j)) ? float_ty : i32_ty));
+		}
+		for (uint32_t j = 0; j < i; ++ j)
+		{
+			BOOST_TEST(func_tys[i] != func_tys[j]);
+		}
+	}
+
+	std::vector<MDString*> strs;
+	std::vector<MDTuple*> tuples;
+	for (uint32_t i = 0; i < 256; ++ i)
+	{
+		auto const str = "str" + std::to_string(i);
+		strs.push_back(MDString::Get(context, str));
+		BOOST_TEST(strs.back()->String() == str);
+
+		Metadata* ops[] = { strs.back() };
+		tuples.push_back(MDNode::Get(context, ops));
+	}
+	for (uint32_t i = 0; i < 256; ++ i)
+	{
+		BOOST_TEST(MDString::Get(context, "str" + std::to_string(i)) == strs[i]);
+		Metadata* ops[] = { strs[i] };
+		BOOST_TEST(MDNode::Get(context, ops) == tuples[i]);
+		BOOST_TEST(tuples[i]->Operand(0).Get() == strs[i]);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+/**
+ * @file UseTest.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of Dilithium
+ * For the latest info, see https://github.com/gongminmin/Dilithium
+ *
+ * @section LICENSE
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Minmin Gong. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Dilithium/Dilithium.hpp>
+#include <Dilithium/BasicBlock.hpp>
+#include <Dilithium/Constants.hpp>
+#include <Dilithium/DerivedType.hpp>
+#include <Dilithium/Function.hpp>
+#include <Dilithium/Instructions.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/LLVMModule.hpp>
+#include <Dilithium/Use.hpp>
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Dilithium;
+
+namespace
+{
+	// A call with num_args constant operands, so the waymarking tags cover both short and long digit runs
+	CallInst* CreateCall(LLVMModule& module, uint32_t num_args)
+	{
+		auto& context = module.Context();
+		auto i32_ty = Type::Int32Type(context);
+
+		std::vector<Type*> param_tys(num_args, i32_ty);
+		auto callee = Function::Create(FunctionType::Get(Type::VoidType(context), param_tys, false),
+			GlobalValue::ExternalLinkage, "callee" + std::to_string(num_args), &module);
+		auto caller = Function::Create(FunctionType::Get(Type::VoidType(context), false),
+			GlobalValue::ExternalLinkage, "caller" + std::to_string(num_args), &module);
+		auto bb = BasicBlock::Create(context, "entry", caller);
+
+		std::vector<Value*> args;
+		for (uint32_t i = 0; i < num_args; ++ i)
+		{
+			args.push_back(ConstantInt::Get(i32_ty, i));
+		}
+		auto call = CallInst::Create(callee, args, "", bb);
+		ReturnInst::Create(context, bb);
+		return call;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(UseTest)
+
+BOOST_AUTO_TEST_CASE(ThreePointersBig)
+{
+	BOOST_TEST(sizeof(Use) == 3 * sizeof(void*));
+}
+
+BOOST_AUTO_TEST_CASE(ImpliedUser)
+{
+	auto context = std::make_shared<LLVMContext>();
+	LLVMModule module("UseTest", context);
+	for (uint32_t num_args = 0; num_args < 64; ++ num_args)
+	{
+		auto call = CreateCall(module, num_args);
+		BOOST_TEST(call->NumOperands() == num_args + 1);
+		for (auto const & op : call->Operands())
+		{
+			BOOST_TEST(op.GetUser() == call);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(MoveKeepsImpliedUser)
+{
+	auto context = std::make_shared<LLVMContext>();
+	LLVMModule module("UseTest", context);
+	for (uint32_t num_args : { 0, 1, 7, 31 })
+	{
+		auto call = CreateCall(module, num_args);
+
+		// Moving the operands and the Use past them, like a reallocating vector does, must keep the owner
+		std::vector<Use> moved;
+		moved.reserve(call->NumOperands() + 1);
+		for (auto iter = call->OpBegin(), end_iter = call->OpEnd() + 1; iter != end_iter; ++ iter)
+		{
+			moved.emplace_back(std::move(*iter));
+		}
+		for (uint32_t i = 0; i < call->NumOperands(); ++ i)
+		{
+			BOOST_TEST(moved[i].Get() == call->Operand(i));
+			BOOST_TEST(moved[i].GetUser() == call);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(UseList)
+{
+	auto context = std::make_shared<LLVMContext>();
+	LLVMModule module("UseTest", context);
+	auto call = CreateCall(module, 4);
+	auto zero = ConstantInt::Get(Type::Int32Type(*context), 0);
+
+	uint32_t num_uses = 0;
+	for (auto const & use : zero->Uses())
+	{
+		BOOST_TEST(use.Get() == zero);
+		BOOST_TEST(use.GetUser() == call);
+		++ num_uses;
+	}
+	BOOST_TEST(num_uses == 1U);
+
+	call->Operand(1, zero);
+	num_uses = 0;
+	for (auto const & use : zero->Uses())
+	{
+		BOOST_TEST(use.GetUser() == call);
+		++ num_uses;
+	}
+	BOOST_TEST(num_uses == 2U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -33,6 +33,7 @@
  */
 
 #include <cstdint>
+#include <cstdio>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -40,6 +41,8 @@
 #include <string>
 #include <algorithm>
 #include <iomanip>
+#include <iterator>
+#include <random>
 
 #include <Dilithium/Dilithium.hpp>
 
@@ -47,8 +50,11 @@
 #include <Dilithium/Constants.hpp>
 #include <Dilithium/DerivedType.hpp>
 #include <Dilithium/Instructions.hpp>
+#include <Dilithium/LLVMContext.hpp>
+#include <Dilithium/MemoryUsage.hpp>
 
 #include <Dilithium/dxc/HLSL/DxilCBuffer.hpp>
+#include <Dilithium/dxc/HLSL/DxilConstantFolding.hpp>
 #include <Dilithium/dxc/HLSL/DxilContainer.hpp>
 #include <Dilithium/dxc/HLSL/DxilOperations.hpp>
 #include <Dilithium/dxc/HLSL/DxilPipelineStateValidation.hpp>
@@ -457,7 +463,8 @@ namespace
 		os << comment << std::endl;
 	}
 
-	void PrintPipelineStateValidationRuntimeInfo(char const * buff, ShaderKind shader_kind, std::ostream& os, char const * comment)
+	void PrintPipelineStateValidationRuntimeInfo(PSVRuntimeInfo0 const * info, ShaderKind shader_kind, std::ostream& os,
+		char const * comment)
 	{
 		static char const * input_primitive_names[] =
 		{
@@ -534,9 +541,6 @@ namespace
 			<< comment << " Pipeline Runtime Information:" << std::endl
 			<< comment << std::endl;
 
-		uint32_t const offset = sizeof(uint32_t);
-		auto info = reinterpret_cast<PSVRuntimeInfo0 const *>(buff + offset);
-
 		switch (shader_kind)
 		{
 		case ShaderKind::Vertex:
@@ -1068,15 +1072,60 @@ namespace
 	}
 }
 
+uint32_t const MaxThreads = 256;
+
 void Usage()
 {
 	std::cerr << "Dilithium DirectX Intermediate Language Disassembler." << std::endl;
 	std::cerr << "This program is free software, released under a MIT license" << std::endl;
 	std::cerr << std::endl;
-	std::cerr << "Usage: DilithiumDisasm INPUT [OUTPUT]" << std::endl;
+	std::cerr << "Usage: DilithiumDisasm [-stats] [-fold] [-threads N] [-cache DIR] INPUT [OUTPUT]" << std::endl;
+	std::cerr << std::endl;
+	std::cerr << "  -stats    Print the memory used by the module and its context to stderr" << std::endl;
+	std::cerr << "  -fold     Fold dx.op calls with constant arguments before printing" << std::endl;
+	std::cerr << "  -threads  Print functions on N threads, N from 1 to " << MaxThreads << ". Default is 1" << std::endl;
+	std::cerr << "  -cache    Reuse listings stored in the existing directory DIR, keyed by the container hash" << std::endl;
 	std::cerr << std::endl;
 }
 
+// Only plain decimal numbers in [1, MaxThreads] are accepted
+bool ParseThreadCount(char const * str, uint32_t& num_threads)
+{
+	uint32_t value = 0;
+	char const * p = str;
+	for (; (*p >= '0') && (*p <= '9'); ++ p)
+	{
+		value = value * 10 + (*p - '0');
+		if (value > MaxThreads)
+		{
+			return false;
+		}
+	}
+	if ((p == str) || (*p != '\0') || (value == 0))
+	{
+		return false;
+	}
+
+	num_threads = value;
+	return true;
+}
+
+void PrintMemoryStats(char const * title, std::vector<Dilithium::MemoryUsage> const & stats)
+{
+	size_t total_count = 0;
+	size_t total_bytes = 0;
+	std::cerr << title << ":" << std::endl;
+	for (auto const & usage : stats)
+	{
+		std::cerr << "  " << std::left << std::setw(24) << usage.name
+			<< std::right << std::setw(10) << usage.count << std::setw(14) << usage.bytes << " bytes" << std::endl;
+		total_count += usage.count;
+		total_bytes += usage.bytes;
+	}
+	std::cerr << "  " << std::left << std::setw(24) << "Total"
+		<< std::right << std::setw(10) << total_count << std::setw(14) << total_bytes << " bytes" << std::endl;
+}
+
 std::vector<uint8_t> LoadProgramFromStream(std::istream& in)
 {
 	in.seekg(0, std::ios_base::end);
@@ -1086,117 +1135,187 @@ std::vector<uint8_t> LoadProgramFromStream(std::istream& in)
 	return program;
 }
 
-std::string Disassemble(std::vector<uint8_t> const & program)
+// Bump when the listing of the same input changes without a version change
+uint32_t const DisasmCacheRevision = 1;
+
+uint64_t Fnv1aHash(void const * data, size_t size, uint64_t hash = 0xCBF29CE484222325ULL)
+{
+	auto p = static_cast<uint8_t const *>(data);
+	for (size_t i = 0; i < size; ++ i)
+	{
+		hash ^= p[i];
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+std::string ToHex(uint64_t value)
 {
 	std::ostringstream oss;
+	oss << std::hex << std::setw(16) << std::setfill('0') << value;
+	return oss.str();
+}
 
-	uint8_t const * il = program.data();
-	uint32_t il_length = static_cast<uint32_t>(program.size());
-	auto container = IsDxilContainerLike(il, il_length);
+// The cache entry of a program is named after its content and the options, and starts with a key line that is
+// checked on load. Returns an empty name if the program can't be cached.
+std::string DisasmCacheFileName(std::vector<uint8_t> const & program, bool fold_constants, std::string& key_line)
+{
+	std::string content_id;
+	auto container = IsDxilContainerLike(program.data(), static_cast<uint32_t>(program.size()));
 	if (container)
 	{
-		if (!IsValidDxilContainer(container, il_length))
+		// The hash is all zero unless the container is signed by the validator
+		auto const & digest = container->Hash.Digest;
+		if (std::any_of(std::begin(digest), std::end(digest), [](uint8_t d) { return d != 0; }))
 		{
-			TERROR("This container is invalid.");
-		}
-
-		for (uint32_t i = 0; i < container->PartCount; ++ i)
-		{
-			auto part = GetDxilContainerPart(container, i);
-			if (part->PartFourCC == DFCC_FeatureInfo)
+			std::ostringstream oss;
+			oss << std::hex << std::setfill('0');
+			for (auto d : digest)
 			{
-				PrintFeatureInfo(reinterpret_cast<DxilShaderFeatureInfo const *>(GetDxilPartData(part)), oss, ";");
-				break;
+				oss << std::setw(2) << static_cast<uint32_t>(d);
 			}
+			content_id = oss.str();
 		}
-		for (uint32_t i = 0; i < container->PartCount; ++ i)
+	}
+	if (content_id.empty())
+	{
+		if (program.empty())
 		{
-			auto part = GetDxilContainerPart(container, i);
-			if (part->PartFourCC == DFCC_InputSignature)
-			{
-				PrintSignature("Input", reinterpret_cast<DxilProgramSignature const *>(GetDxilPartData(part)), true, oss, ";");
-				break;
-			}
+			return "";
 		}
-		for (uint32_t i = 0; i < container->PartCount; ++ i)
+		content_id = "c" + ToHex(Fnv1aHash(program.data(), program.size())) + ToHex(program.size());
+	}
+
+	std::ostringstream oss;
+	oss << "; DilithiumDisasm "
+		<< DILITHIUM_STRINGIZE(DILITHIUM_MAJOR_VERSION) "." DILITHIUM_STRINGIZE(DILITHIUM_MINOR_VERSION) "."
+			DILITHIUM_STRINGIZE(DILITHIUM_PATCH_VERSION)
+		<< " r" << DisasmCacheRevision << " fold=" << fold_constants << ' ' << content_id << '\n';
+	key_line = oss.str();
+
+	return content_id + "_" + ToHex(Fnv1aHash(key_line.data(), key_line.size())) + ".txt";
+}
+
+bool LoadCachedDisassembly(std::string const & path, std::string const & key_line, std::string& text)
+{
+	std::ifstream in(path, std::ios_base::in | std::ios_base::binary);
+	if (!in)
+	{
+		return false;
+	}
+
+	std::string entry((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	if (entry.compare(0, key_line.size(), key_line) != 0)
+	{
+		return false;
+	}
+	text = entry.substr(key_line.size());
+	return true;
+}
+
+// Writes to a unique temporary file and renames it over the entry, so concurrent runs never see a partial entry.
+// Failures are ignored, the cache is only an optimization.
+void StoreCachedDisassembly(std::string const & path, std::string const & key_line, std::string const & text)
+{
+	std::random_device rd;
+	std::string const tmp_path = path + "." + ToHex((static_cast<uint64_t>(rd()) << 32) | rd()) + ".tmp";
+	{
+		std::ofstream out(tmp_path, std::ios_base::out | std::ios_base::binary);
+		if (!out)
 		{
-			auto part = GetDxilContainerPart(container, i);
-			if (part->PartFourCC == DFCC_OutputSignature)
-			{
-				PrintSignature("Output", reinterpret_cast<DxilProgramSignature const *>(GetDxilPartData(part)), false, oss, ";");
-				break;
-			}
+			return;
 		}
-		for (uint32_t i = 0; i < container->PartCount; ++ i)
+		out << key_line << text;
+		out.close();
+		if (!out)
 		{
-			auto part = GetDxilContainerPart(container, i);
-			if (part->PartFourCC == DFCC_PatchConstantSignature)
-			{
-				PrintSignature("Patch Constant signature", reinterpret_cast<DxilProgramSignature const *>(GetDxilPartData(part)),
-					false, oss, ";");
-				break;
-			}
+			std::remove(tmp_path.c_str());
+			return;
 		}
+	}
+
+	if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+	{
+		// Windows doesn't replace an existing file. It holds the same listing, written by another run.
+		std::remove(tmp_path.c_str());
+	}
+}
+
+// Returns false if the program can't be loaded. The error is reported to std::cerr and the text is left empty.
+bool Disassemble(std::vector<uint8_t> const & program, bool print_stats, bool fold_constants, uint32_t num_threads,
+	std::string& text)
+{
+	try
+	{
+		std::ostringstream oss;
 
-		uint32_t dxil_index = container->PartCount;
-		for (uint32_t i = 0; i < container->PartCount; ++ i)
+		uint8_t const * il = program.data();
+		uint32_t il_length = static_cast<uint32_t>(program.size());
+		if (IsDxilContainerLike(il, il_length))
 		{
-			auto part = GetDxilContainerPart(container, i);
-			if (part->PartFourCC == DFCC_DXIL)
+			DxilContainerReader container;
+			if (!container.Load(il, il_length))
 			{
-				dxil_index = i;
-				break;
+				TERROR("This container is invalid.");
 			}
-		}
 
-		if (dxil_index == container->PartCount)
-		{
-			TERROR("This container doesn't have DXIL.");
-		}
+			auto feature_info = container.GetFeatureInfo();
+			if (feature_info)
+			{
+				PrintFeatureInfo(feature_info, oss, ";");
+			}
+			auto input_signature = container.GetSignature(DFCC_InputSignature);
+			if (input_signature)
+			{
+				PrintSignature("Input", input_signature, true, oss, ";");
+			}
+			auto output_signature = container.GetSignature(DFCC_OutputSignature);
+			if (output_signature)
+			{
+				PrintSignature("Output", output_signature, false, oss, ";");
+			}
+			auto patch_constant_signature = container.GetSignature(DFCC_PatchConstantSignature);
+			if (patch_constant_signature)
+			{
+				PrintSignature("Patch Constant signature", patch_constant_signature, false, oss, ";");
+			}
 
-		for (uint32_t i = 0; i < container->PartCount; ++ i)
-		{
-			auto part = GetDxilContainerPart(container, i);
-			if (part->PartFourCC == DFCC_ShaderDebugInfoDXIL)
+			if (!container.HasPart(DFCC_DXIL))
 			{
-				// Use dbg module if exist.
-				dxil_index = i;
-				break;
+				TERROR("This container doesn't have DXIL.");
 			}
-		}
 
-		auto dxil_part = GetDxilContainerPart(container, dxil_index);
-		auto program_header = reinterpret_cast<DxilProgramHeader const *>(GetDxilPartData(dxil_part));
-		if (!IsValidDxilProgramHeader(program_header, dxil_part->PartSize))
-		{
-			TERROR("The program header in this is container is invalid.");
-		}
+			// Use dbg module if exist.
+			auto program_header = container.GetProgramHeader(container.HasPart(DFCC_ShaderDebugInfoDXIL)
+				? DFCC_ShaderDebugInfoDXIL : DFCC_DXIL);
+			if (!program_header)
+			{
+				TERROR("The program header in this is container is invalid.");
+			}
 
-		for (uint32_t i = 0; i < container->PartCount; ++ i)
-		{
-			auto part = GetDxilContainerPart(container, i);
-			if (part->PartFourCC == DFCC_PipelineStateValidation)
+			auto psv_runtime_info = container.GetPSVRuntimeInfo();
+			if (psv_runtime_info)
 			{
-				PrintPipelineStateValidationRuntimeInfo(GetDxilPartData(part), GetVersionShaderType(program_header->ProgramVersion),
+				PrintPipelineStateValidationRuntimeInfo(psv_runtime_info, GetVersionShaderType(program_header->ProgramVersion),
 					oss, ";");
-				break;
 			}
-		}
 
-		GetDxilProgramBitcode(program_header, &il, &il_length);
-	}
-	else
-	{
-		auto program_header = reinterpret_cast<DxilProgramHeader const *>(il);
-		if (IsValidDxilProgramHeader(program_header, il_length))
-		{
 			GetDxilProgramBitcode(program_header, &il, &il_length);
 		}
-	}
+		else
+		{
+			auto program_header = reinterpret_cast<DxilProgramHeader const *>(il);
+			if (IsValidDxilProgramHeader(program_header, il_length))
+			{
+				GetDxilProgramBitcode(program_header, &il, &il_length);
+			}
+		}
 
-	try
-	{
 		auto module = Dilithium::LoadLLVMModule(il, il_length, "");
+		if (fold_constants)
+		{
+			Dilithium::FoldDxilConstants(*module);
+		}
 		if (module->GetNamedMetadata("dx.version"))
 		{
 			auto& dxil_module = module->GetOrCreateDxilModule();
@@ -1208,40 +1327,111 @@ std::string Disassemble(std::vector<uint8_t> const & program)
 		}
 
 		DxcAssemblyAnnotationWriter w;
-		module->Print(oss, &w);
+		module->Print(oss, &w, num_threads);
 
-		return oss.str();
+		if (print_stats)
+		{
+			std::vector<Dilithium::MemoryUsage> stats;
+			module->MemoryStats(stats);
+			PrintMemoryStats("Module", stats);
+			stats.clear();
+			module->Context().MemoryStats(stats);
+			PrintMemoryStats("Context", stats);
+		}
+
+		text = oss.str();
+		return true;
 	}
-	catch (std::error_code& ec)
+	catch (std::exception& ex)
 	{
-		std::cerr << ec.message() << std::endl;
-		return "";
+		std::cerr << ex.what() << std::endl;
+		text.clear();
+		return false;
 	}
 }
 
 int main(int argc, char** argv)
 {
-	if (argc < 2)
+	bool print_stats = false;
+	bool fold_constants = false;
+	uint32_t num_threads = 1;
+	std::string cache_dir;
+	int arg_index = 1;
+	for (; arg_index < argc; ++ arg_index)
+	{
+		std::string const arg = argv[arg_index];
+		if (arg == "-stats")
+		{
+			print_stats = true;
+		}
+		else if (arg == "-fold")
+		{
+			fold_constants = true;
+		}
+		else if ((arg == "-threads") && (arg_index + 1 < argc))
+		{
+			++ arg_index;
+			if (!ParseThreadCount(argv[arg_index], num_threads))
+			{
+				std::cerr << "Invalid thread count " << argv[arg_index] << "." << std::endl;
+				Usage();
+				return 1;
+			}
+		}
+		else if ((arg == "-cache") && (arg_index + 1 < argc))
+		{
+			++ arg_index;
+			cache_dir = argv[arg_index];
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	if (argc - arg_index < 1)
 	{
 		Usage();
 		return 1;
 	}
 
-	std::ifstream in(argv[1], std::ios_base::in | std::ios_base::binary);
+	std::ifstream in(argv[arg_index], std::ios_base::in | std::ios_base::binary);
 	auto program = LoadProgramFromStream(in);
 	in.close();
 
-	auto text = Disassemble(program);
+	// Memory stats need the module, so they bypass the cache
+	std::string cache_path;
+	std::string cache_key_line;
+	if (!cache_dir.empty() && !print_stats)
+	{
+		auto const file_name = DisasmCacheFileName(program, fold_constants, cache_key_line);
+		if (!file_name.empty())
+		{
+			cache_path = cache_dir + "/" + file_name;
+		}
+	}
+
+	std::string text;
+	bool succeeded = true;
+	if (cache_path.empty() || !LoadCachedDisassembly(cache_path, cache_key_line, text))
+	{
+		// A failure isn't cached, so a fixed build of the tool gets another try at the same program
+		succeeded = Disassemble(program, print_stats, fold_constants, num_threads, text);
+		if (succeeded && !cache_path.empty())
+		{
+			StoreCachedDisassembly(cache_path, cache_key_line, text);
+		}
+	}
 
 	std::ofstream out;
 	bool screen_only = false;
-	if (argc < 3)
+	if (argc - arg_index < 2)
 	{
 		screen_only = true;
 	}
 	else
 	{
-		out.open(argv[2]);
+		out.open(argv[arg_index + 1]);
 	}
 
 	std::cout << text;
@@ -1249,4 +1439,6 @@ int main(int argc, char** argv)
 	{
 		out << text;
 	}
+
+	return succeeded ? 0 : 1;
 }